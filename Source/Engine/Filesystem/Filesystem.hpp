@@ -4,6 +4,8 @@
 
 #include "Engine/Filesystem/Filepath.hpp"
 
+#include "Utils/DataHelpers.hpp"
+
 struct DialogDescription
 {
     std::string title;
@@ -18,4 +20,8 @@ namespace Filesystem
     std::optional<Filepath> ShowSaveDialog(const DialogDescription& description);
 
     std::string ReadFile(const Filepath& filepath);
+
+    Bytes ReadBinaryFile(const Filepath& filepath);
+
+    bool WriteBinaryFile(const Filepath& filepath, const ByteView& data);
 }
@@ -42,3 +42,29 @@ std::string Filesystem::ReadFile(const Filepath& filepath)
 
     return buffer.str();
 }
+
+Bytes Filesystem::ReadBinaryFile(const Filepath& filepath)
+{
+    std::ifstream file(filepath.GetAbsolute(), std::ios::binary | std::ios::ate);
+
+    if (!file)
+    {
+        return {};
+    }
+
+    Bytes bytes(static_cast<size_t>(file.tellg()));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    return bytes;
+}
+
+bool Filesystem::WriteBinaryFile(const Filepath& filepath, const ByteView& data)
+{
+    std::ofstream file(filepath.GetAbsolute(), std::ios::binary | std::ios::trunc);
+
+    file.write(reinterpret_cast<const char*>(data.data), static_cast<std::streamsize>(data.size));
+
+    return file.good();
+}
@@ -10,6 +10,7 @@
 #include "Engine/Scene/Systems/CameraSystem.hpp"
 #include "Engine/Render/FrameLoop.hpp"
 #include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderThread.hpp"
 #include "Engine/Render/SceneRenderer.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
@@ -88,6 +89,15 @@ void Engine::Create()
     AddSystem<AnimationSystem>();
     AddSystem<CameraSystem>();
 
+    RenderContext::renderThread->Start([](const RenderSnapshot& snapshot)
+        {
+            RenderContext::frameLoop->Draw([&](vk::CommandBuffer commandBuffer, uint32_t imageIndex)
+                {
+                    sceneRenderer->Render(commandBuffer, imageIndex, snapshot);
+                    imGuiRenderer->Render(commandBuffer, imageIndex, snapshot);
+                });
+        });
+
     OpenScene();
 }
 
@@ -107,6 +117,8 @@ void Engine::Run()
             {
                 system->Process(*scene, deltaSeconds);
             }
+
+            scene->SortHierarchy();
         }
 
         if (drawingSuspended)
@@ -116,16 +128,19 @@ void Engine::Run()
 
         imGuiRenderer->Build(scene.get(), deltaSeconds);
 
-        RenderContext::frameLoop->Draw([](vk::CommandBuffer commandBuffer, uint32_t imageIndex)
-            {
-                sceneRenderer->Render(commandBuffer, imageIndex);
-                imGuiRenderer->Render(commandBuffer, imageIndex);
-            });
+        RenderSnapshot& snapshot = RenderContext::renderThread->AcquireSnapshot();
+
+        sceneRenderer->ExtractSnapshot(snapshot);
+        imGuiRenderer->CaptureDrawData(snapshot);
+
+        RenderContext::renderThread->SubmitSnapshot();
     }
 }
 
 void Engine::Destroy()
 {
+    RenderContext::renderThread->Stop();
+
     VulkanContext::device->WaitIdle();
 
     systems.clear();
@@ -160,6 +175,8 @@ void Engine::AddEventHandler(EventType type, const std::function<void()>& handle
 
 void Engine::HandleResizeEvent(const vk::Extent2D& extent)
 {
+    RenderContext::renderThread->Flush();
+
     VulkanContext::device->WaitIdle();
 
     drawingSuspended = extent.width == 0 || extent.height == 0;
@@ -207,6 +224,8 @@ void Engine::OpenScene()
 {
     EASY_FUNCTION()
 
+    RenderContext::renderThread->Flush();
+
     VulkanContext::device->WaitIdle();
 
     sceneRenderer->RemoveScene();
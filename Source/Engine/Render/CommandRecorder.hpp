@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Records tasks into secondary command buffers on persistent worker threads.
+// Each thread allocates from own command pool per frame slot, so recording doesn't need synchronization
+// Tasks take resource handles from the render snapshot, they must not lock state that the main thread
+// holds while it waits for the render thread, e.g. geometry buffers are bound from RenderSnapshot::geometryBuffers
+class CommandRecorder
+{
+public:
+    using TaskCommands = std::function<void(vk::CommandBuffer, uint32_t)>;
+
+    CommandRecorder(uint32_t frameCount);
+    ~CommandRecorder();
+
+    // Threads used by Record including the calling one, limited by r.RecordingThreads
+    uint32_t GetActiveThreadCount() const;
+
+    // Resets command pools of the frame slot, command buffers recorded for it before have to be completed
+    void BeginFrame(uint32_t frameIndex);
+
+    // Returns secondary command buffers in task order, they are valid until the next call
+    const std::vector<vk::CommandBuffer>& Record(const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+            uint32_t threadCount, uint32_t taskCount, const TaskCommands& commands);
+
+private:
+    struct CommandPool
+    {
+        vk::CommandPool pool;
+        std::vector<vk::CommandBuffer> commandBuffers;
+        uint32_t usedCount = 0;
+    };
+
+    // Command pools of each thread by frame slot, the calling thread has index 0
+    std::vector<std::vector<CommandPool>> commandPools;
+    uint32_t currentFrameIndex = 0;
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable finishCondition;
+
+    uint64_t generation = 0;
+    uint32_t runningWorkerCount = 0;
+    bool stopped = false;
+
+    // State of the current Record call, written before workers are started
+    const vk::CommandBufferInheritanceInfo* inheritanceInfo = nullptr;
+    const TaskCommands* commands = nullptr;
+    uint32_t taskCount = 0;
+    uint32_t workerCount = 0;
+    std::atomic<uint32_t> nextTask = 0;
+
+    std::vector<vk::CommandBuffer> recordedCommandBuffers;
+
+    void RunWorker(uint32_t threadIndex);
+
+    void RecordTasks(uint32_t threadIndex);
+
+    vk::CommandBuffer AcquireCommandBuffer(uint32_t threadIndex);
+};
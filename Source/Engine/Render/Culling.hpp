@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Utils/AABBox.hpp"
+
+class Frustum;
+
+// Structure of arrays layout of world space bounds, allows to test 4 boxes against a plane at once
+struct CullingBounds
+{
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    uint32_t GetSize() const { return static_cast<uint32_t>(centerX.size()); }
+
+    void Clear();
+
+    void Add(const AABBox& bbox, const glm::mat4& transform);
+
+    AABBox Get(uint32_t index) const;
+};
+
+namespace CullingHelpers
+{
+    void CullFrustum(const Frustum& frustum, const CullingBounds& bounds, std::vector<uint32_t>& visibleObjects);
+}
@@ -2,6 +2,10 @@
 
 #include "Engine/Render/Vulkan/VulkanHelpers.hpp"
 
+#include "Utils/LinearArena.hpp"
+
+#include <mutex>
+
 class FrameLoop // TODO make static
 {
 public:
@@ -10,17 +14,39 @@ public:
 
     uint32_t GetFrameCount() const;
 
+    uint32_t GetCurrentFrameIndex() const;
+
     bool IsFrameActive(uint32_t index) const;
 
     void Draw(RenderCommands renderCommands);
 
+    // Transient CPU memory of the frame being recorded, reset once the frame fence is signaled
+    LinearArena& GetArena();
+
+    // Submits commands to async compute queue during frame recording, frame waits for them in waitStages.
+    // Commands don't wait for the previous frame, resources they write have to be per swapchain image.
+    // Commands are recorded into frame command buffer if device has no async compute queue.
+    void ExecuteAsyncCompute(vk::CommandBuffer frameCommandBuffer,
+            const DeviceCommands& commands, vk::PipelineStageFlags waitStages);
+
     void DestroyResource(std::function<void()>&& destroyTask);
 
 private:
+    static constexpr size_t kArenaBlockSize = 256 * 1024;
+
     struct Frame
     {
         vk::CommandBuffer commandBuffer;
         CommandBufferSync commandBufferSync;
+
+        // Reused for each submit, so async compute waits are appended without reallocation
+        CommandBufferSync submitSync;
+
+        LinearArena arena{ kArenaBlockSize };
+
+        vk::CommandBuffer computeCommandBuffer;
+        vk::Semaphore computeSemaphore;
+        vk::PipelineStageFlags computeWaitStages;
     };
 
     struct ResourceToDestroy
@@ -32,7 +58,17 @@ private:
     uint32_t currentFrameIndex = 0;
     std::vector<Frame> frames;
 
+    // Fence of the frame that rendered the swapchain image last, waited when the image is acquired again,
+    // so resources per swapchain image are no longer used by GPU when a frame records into them
+    std::vector<vk::Fence> imageFences;
+
+    std::mutex resourcesToDestroyMutex;
     std::vector<ResourceToDestroy> resourcesToDestroy;
 
+    uint64_t lastAllocationCount = 0;
+    uint64_t lastThreadAllocationCount = 0;
+
+    void UpdateAllocationStats();
+
     void UpdateResourcesToDestroy();
 };
@@ -5,6 +5,7 @@ class GBufferStage;
 class LightingStage;
 class ForwardStage;
 struct KeyInput;
+struct RenderSnapshot;
 
 class HybridRenderer
 {
@@ -17,9 +18,9 @@ public:
 
     void RemoveScene();
 
-    void Update() const;
+    void Update(const RenderSnapshot& snapshot) const;
 
-    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const;
 
     void Resize(const vk::Extent2D& extent) const;
 
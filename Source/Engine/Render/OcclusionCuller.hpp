@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Utils/AABBox.hpp"
+
+// Rasterizes occluders into low resolution depth buffer on CPU and tests bounds against its Hi-Z pyramid.
+// Depth is stored as 1 / w, so it's linear in screen space and independent of projection depth range.
+class OcclusionCuller
+{
+public:
+    static constexpr uint32_t kWidth = 256;
+    static constexpr uint32_t kHeight = 128;
+
+    OcclusionCuller();
+
+    void Begin(const glm::mat4& viewProjMatrix_);
+
+    void RasterizeOccluder(const std::vector<glm::vec3>& positions,
+            const std::vector<uint32_t>& indices, const glm::mat4& transform);
+
+    void BuildHierarchy();
+
+    bool IsOccluded(const AABBox& bbox) const;
+
+    const std::vector<float>& GetDepthBuffer() const { return levels.front().depth; }
+
+private:
+    struct Level
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> depth;
+    };
+
+    glm::mat4 viewProjMatrix = glm::mat4(1.0f);
+
+    std::vector<Level> levels;
+
+    std::vector<glm::vec4> screenPositions;
+
+    void RasterizeTriangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Vulkan/Resources/ImageHelpers.hpp"
+#include "Vulkan/Pipelines/PipelineBase.hpp"
 
 class Scene;
 class AABBox;
@@ -28,6 +29,7 @@ private:
     vk::Buffer cameraBuffer;
 
     std::unique_ptr<GraphicsPipeline> pipeline;
+    PushConstantHandle transformHandle;
 
     std::unique_ptr<DescriptorProvider> descriptorProvider;
 
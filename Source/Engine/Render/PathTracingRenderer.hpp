@@ -1,13 +1,17 @@
 #pragma once
 
 #include "Engine/Render/RenderHelpers.hpp"
+#include "Vulkan/Pipelines/PipelineBase.hpp"
 #include "Vulkan/Resources/DescriptorProvider.hpp"
 #include "Vulkan/Resources/ImageHelpers.hpp"
 #include "Vulkan/VulkanHelpers.hpp"
 
+#include <atomic>
+
 class Scene;
 class RayTracingPipeline;
 struct KeyInput;
+struct RenderSnapshot;
 
 class PathTracingRenderer
 {
@@ -20,9 +24,9 @@ public:
 
     void RemoveScene();
 
-    void Update() const;
+    void Update(const RenderSnapshot& snapshot) const;
 
-    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex);
+    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot);
 
     void Resize(const vk::Extent2D& extent);
 
@@ -32,9 +36,11 @@ private:
     RenderTarget accumulationTarget;
 
     std::unique_ptr<RayTracingPipeline> rayTracingPipeline;
+    PushConstantHandle lightCountHandle;
+    PushConstantHandle accumulationIndexHandle;
     std::unique_ptr<DescriptorProvider> descriptorProvider;
 
-    uint32_t accumulationIndex = 0;
+    std::atomic<uint32_t> accumulationIndex = 0;
 
     void HandleKeyInputEvent(const KeyInput& keyInput);
 
@@ -0,0 +1,242 @@
+#include "Engine/Render/CommandRecorder.hpp"
+
+#include "Engine/ConsoleVariable.hpp"
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+#include "Utils/Assert.hpp"
+
+namespace Details
+{
+    static int recordingThreads = 0;
+    static CVarInt recordingThreadsCVar("r.RecordingThreads", recordingThreads);
+
+    static uint32_t GetHardwareThreadCount()
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    static vk::CommandPool CreateCommandPool()
+    {
+        const vk::CommandPoolCreateInfo createInfo(vk::CommandPoolCreateFlagBits::eTransient,
+                VulkanContext::device->GetQueuesDescription().graphicsFamilyIndex);
+
+        const auto [result, commandPool] = VulkanContext::device->Get().createCommandPool(createInfo);
+        Assert(result == vk::Result::eSuccess);
+
+        return commandPool;
+    }
+}
+
+CommandRecorder::CommandRecorder(uint32_t frameCount)
+{
+    const uint32_t threadCount = Details::GetHardwareThreadCount();
+
+    commandPools.resize(threadCount);
+
+    for (auto& threadCommandPools : commandPools)
+    {
+        threadCommandPools.resize(frameCount);
+
+        for (CommandPool& commandPool : threadCommandPools)
+        {
+            commandPool.pool = Details::CreateCommandPool();
+        }
+    }
+
+    for (uint32_t i = 1; i < threadCount; ++i)
+    {
+        workers.emplace_back(&CommandRecorder::RunWorker, this, i);
+    }
+}
+
+CommandRecorder::~CommandRecorder()
+{
+    {
+        const std::unique_lock lock(mutex);
+
+        stopped = true;
+    }
+
+    startCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    // Command buffers are freed together with command pools
+    for (const auto& threadCommandPools : commandPools)
+    {
+        for (const CommandPool& commandPool : threadCommandPools)
+        {
+            VulkanContext::device->Get().destroyCommandPool(commandPool.pool);
+        }
+    }
+}
+
+uint32_t CommandRecorder::GetActiveThreadCount() const
+{
+    const uint32_t threadCount = static_cast<uint32_t>(commandPools.size());
+
+    if (Details::recordingThreads <= 0)
+    {
+        return threadCount;
+    }
+
+    return std::min(static_cast<uint32_t>(Details::recordingThreads), threadCount);
+}
+
+void CommandRecorder::BeginFrame(uint32_t frameIndex)
+{
+    currentFrameIndex = frameIndex;
+
+    for (auto& threadCommandPools : commandPools)
+    {
+        CommandPool& commandPool = threadCommandPools[frameIndex];
+
+        if (commandPool.usedCount > 0)
+        {
+            const vk::Result result = VulkanContext::device->Get().resetCommandPool(commandPool.pool);
+            Assert(result == vk::Result::eSuccess);
+
+            commandPool.usedCount = 0;
+        }
+    }
+}
+
+const std::vector<vk::CommandBuffer>& CommandRecorder::Record(
+        const vk::CommandBufferInheritanceInfo& inheritanceInfo_,
+        uint32_t threadCount, uint32_t taskCount_, const TaskCommands& commands_)
+{
+    EASY_FUNCTION()
+
+    Assert(threadCount > 0 && threadCount <= commandPools.size());
+
+    recordedCommandBuffers.resize(taskCount_);
+
+    if (taskCount_ == 0)
+    {
+        return recordedCommandBuffers;
+    }
+
+    inheritanceInfo = &inheritanceInfo_;
+    commands = &commands_;
+    taskCount = taskCount_;
+    nextTask = 0;
+
+    // There is no point to wake more workers than there are tasks
+    workerCount = std::min(threadCount, taskCount) - 1;
+
+    if (workerCount > 0)
+    {
+        {
+            const std::unique_lock lock(mutex);
+
+            runningWorkerCount = workerCount;
+            ++generation;
+        }
+
+        startCondition.notify_all();
+    }
+
+    RecordTasks(0);
+
+    if (workerCount > 0)
+    {
+        std::unique_lock lock(mutex);
+
+        finishCondition.wait(lock, [&]()
+            {
+                return runningWorkerCount == 0;
+            });
+    }
+
+    return recordedCommandBuffers;
+}
+
+void CommandRecorder::RunWorker(uint32_t threadIndex)
+{
+    uint64_t lastGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+
+            startCondition.wait(lock, [&]()
+                {
+                    return stopped || generation != lastGeneration;
+                });
+
+            if (stopped)
+            {
+                return;
+            }
+
+            lastGeneration = generation;
+
+            if (threadIndex > workerCount)
+            {
+                continue;
+            }
+        }
+
+        RecordTasks(threadIndex);
+
+        bool finished;
+
+        {
+            const std::unique_lock lock(mutex);
+
+            finished = --runningWorkerCount == 0;
+        }
+
+        if (finished)
+        {
+            finishCondition.notify_one();
+        }
+    }
+}
+
+void CommandRecorder::RecordTasks(uint32_t threadIndex)
+{
+    const vk::CommandBufferUsageFlags usageFlags = inheritanceInfo->renderPass
+            ? vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue
+            : vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+    const vk::CommandBufferBeginInfo beginInfo(usageFlags, inheritanceInfo);
+
+    for (uint32_t i = nextTask++; i < taskCount; i = nextTask++)
+    {
+        const vk::CommandBuffer commandBuffer = AcquireCommandBuffer(threadIndex);
+
+        vk::Result result = commandBuffer.begin(beginInfo);
+        Assert(result == vk::Result::eSuccess);
+
+        (*commands)(commandBuffer, i);
+
+        result = commandBuffer.end();
+        Assert(result == vk::Result::eSuccess);
+
+        recordedCommandBuffers[i] = commandBuffer;
+    }
+}
+
+vk::CommandBuffer CommandRecorder::AcquireCommandBuffer(uint32_t threadIndex)
+{
+    CommandPool& commandPool = commandPools[threadIndex][currentFrameIndex];
+
+    if (commandPool.usedCount == commandPool.commandBuffers.size())
+    {
+        const vk::CommandBufferAllocateInfo allocateInfo(commandPool.pool, vk::CommandBufferLevel::eSecondary, 1);
+
+        vk::CommandBuffer commandBuffer;
+
+        const vk::Result result = VulkanContext::device->Get().allocateCommandBuffers(&allocateInfo, &commandBuffer);
+        Assert(result == vk::Result::eSuccess);
+
+        commandPool.commandBuffers.push_back(commandBuffer);
+    }
+
+    return commandPool.commandBuffers[commandPool.usedCount++];
+}
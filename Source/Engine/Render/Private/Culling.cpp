@@ -0,0 +1,147 @@
+#include "Engine/Render/Culling.hpp"
+
+#include "Utils/Frustum.hpp"
+
+#include <xmmintrin.h>
+
+namespace Details
+{
+    static bool IsVisible(const std::array<glm::vec4, 6>& planes, const CullingBounds& bounds, uint32_t index)
+    {
+        for (const auto& plane : planes)
+        {
+            const float distance = plane.x * bounds.centerX[index]
+                    + plane.y * bounds.centerY[index]
+                    + plane.z * bounds.centerZ[index] + plane.w;
+
+            const float radius = std::abs(plane.x) * bounds.extentX[index]
+                    + std::abs(plane.y) * bounds.extentY[index]
+                    + std::abs(plane.z) * bounds.extentZ[index];
+
+            if (distance + radius < 0.0f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+void CullingBounds::Clear()
+{
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+void CullingBounds::Add(const AABBox& bbox, const glm::mat4& transform)
+{
+    const glm::vec3 center = glm::vec3(transform * glm::vec4(bbox.GetCenter(), 1.0f));
+
+    const glm::mat3 linearTransform(transform);
+
+    const glm::mat3 absTransform(glm::abs(linearTransform[0]),
+            glm::abs(linearTransform[1]), glm::abs(linearTransform[2]));
+
+    const glm::vec3 extent = absTransform * (bbox.GetSize() * 0.5f);
+
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    extentX.push_back(extent.x);
+    extentY.push_back(extent.y);
+    extentZ.push_back(extent.z);
+}
+
+AABBox CullingBounds::Get(uint32_t index) const
+{
+    const glm::vec3 center(centerX[index], centerY[index], centerZ[index]);
+    const glm::vec3 extent(extentX[index], extentY[index], extentZ[index]);
+
+    return AABBox(center - extent, center + extent);
+}
+
+void CullingHelpers::CullFrustum(const Frustum& frustum,
+        const CullingBounds& bounds, std::vector<uint32_t>& visibleObjects)
+{
+    EASY_FUNCTION()
+
+    const std::array<glm::vec4, 6>& planes = frustum.GetPlanes();
+
+    // Vector types as template arguments lose their alignment attributes, so std::array isn't used
+    struct PlaneData
+    {
+        __m128 x;
+        __m128 y;
+        __m128 z;
+        __m128 w;
+    };
+
+    PlaneData planeData[6];
+
+    for (size_t i = 0; i < planes.size(); ++i)
+    {
+        planeData[i] = PlaneData{
+            _mm_set1_ps(planes[i].x),
+            _mm_set1_ps(planes[i].y),
+            _mm_set1_ps(planes[i].z),
+            _mm_set1_ps(planes[i].w)
+        };
+    }
+
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    visibleObjects.clear();
+
+    const uint32_t count = bounds.GetSize();
+
+    uint32_t index = 0;
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 centerX = _mm_loadu_ps(bounds.centerX.data() + index);
+        const __m128 centerY = _mm_loadu_ps(bounds.centerY.data() + index);
+        const __m128 centerZ = _mm_loadu_ps(bounds.centerZ.data() + index);
+        const __m128 extentX = _mm_loadu_ps(bounds.extentX.data() + index);
+        const __m128 extentY = _mm_loadu_ps(bounds.extentY.data() + index);
+        const __m128 extentZ = _mm_loadu_ps(bounds.extentZ.data() + index);
+
+        __m128 outside = _mm_setzero_ps();
+
+        for (const auto& [x, y, z, w] : planeData)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, centerX), w);
+            distance = _mm_add_ps(_mm_mul_ps(y, centerY), distance);
+            distance = _mm_add_ps(_mm_mul_ps(z, centerZ), distance);
+
+            __m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, x), extentX);
+            radius = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, y), extentY), radius);
+            radius = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, z), extentZ), radius);
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        const int32_t outsideMask = _mm_movemask_ps(outside);
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            if (!(outsideMask & (1 << i)))
+            {
+                visibleObjects.push_back(index + i);
+            }
+        }
+    }
+
+    for (; index < count; ++index)
+    {
+        if (Details::IsVisible(planes, bounds, index))
+        {
+            visibleObjects.push_back(index);
+        }
+    }
+}
@@ -1,7 +1,12 @@
 #include "Engine/Render/FrameLoop.hpp"
 
+#include "Engine/Render/CommandRecorder.hpp"
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderStats.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 
+#include "Utils/AllocationCounter.hpp"
 #include "Utils/Assert.hpp"
 
 namespace Details
@@ -62,7 +67,15 @@ FrameLoop::FrameLoop()
     {
         frame.commandBuffer = VulkanContext::device->AllocateCommandBuffer(CommandBufferType::eOneTime);
         frame.commandBufferSync = Details::CreateCommandBufferSync();
+
+        if (VulkanContext::device->HasAsyncComputeQueue())
+        {
+            frame.computeCommandBuffer = VulkanContext::device->AllocateCommandBuffer(CommandBufferType::eAsyncCompute);
+            frame.computeSemaphore = VulkanHelpers::CreateSemaphore(VulkanContext::device->Get());
+        }
     }
+
+    imageFences.resize(frames.size());
 }
 
 FrameLoop::~FrameLoop()
@@ -75,6 +88,11 @@ FrameLoop::~FrameLoop()
     for (const auto& frame : frames)
     {
         VulkanHelpers::DestroyCommandBufferSync(VulkanContext::device->Get(), frame.commandBufferSync);
+
+        if (frame.computeSemaphore)
+        {
+            VulkanContext::device->Get().destroySemaphore(frame.computeSemaphore);
+        }
     }
 }
 
@@ -83,6 +101,11 @@ uint32_t FrameLoop::GetFrameCount() const
     return static_cast<uint32_t>(frames.size());
 }
 
+uint32_t FrameLoop::GetCurrentFrameIndex() const
+{
+    return currentFrameIndex;
+}
+
 bool FrameLoop::IsFrameActive(uint32_t frameIndex) const
 {
     Assert(frameIndex < GetFrameCount());
@@ -94,24 +117,94 @@ bool FrameLoop::IsFrameActive(uint32_t frameIndex) const
 
 void FrameLoop::Draw(RenderCommands renderCommands)
 {
-    const auto& [graphicsQueue, presentQueue] = VulkanContext::device->GetQueues();
-    const auto& [commandBuffer, commandBufferSync] = frames[currentFrameIndex];
+    const Queues& queues = VulkanContext::device->GetQueues();
+    Frame& frame = frames[currentFrameIndex];
+
+    const uint32_t imageIndex = Details::AcquireNextImageIndex(frame.commandBufferSync.waitSemaphores.front());
+
+    Details::WaitAndResetFence(frame.commandBufferSync.fence);
+
+    // Images can be acquired out of order, so the frame that rendered the image last can still be active
+    if (imageFences[imageIndex] && imageFences[imageIndex] != frame.commandBufferSync.fence)
+    {
+        VulkanHelpers::WaitForFences(VulkanContext::device->Get(), { imageFences[imageIndex] });
+    }
+
+    imageFences[imageIndex] = frame.commandBufferSync.fence;
+
+    UpdateAllocationStats();
 
-    const uint32_t imageIndex = Details::AcquireNextImageIndex(commandBufferSync.waitSemaphores.front());
+    frame.arena.Reset();
 
-    Details::WaitAndResetFence(commandBufferSync.fence);
+    RenderContext::commandRecorder->BeginFrame(currentFrameIndex);
 
     UpdateResourcesToDestroy();
 
-    const DeviceCommands deviceCommands = [&](vk::CommandBuffer cb) { renderCommands(cb, imageIndex); };
+    // Resources used by the frame could be uploaded by a batch that isn't submitted yet
+    ResourceContext::SubmitUploads();
 
-    VulkanHelpers::SubmitCommandBuffer(graphicsQueue, commandBuffer, deviceCommands, commandBufferSync);
+    frame.computeWaitStages = vk::PipelineStageFlags();
 
-    Details::PresentImage(presentQueue, imageIndex, commandBufferSync.signalSemaphores.front());
+    CommandBufferSync& commandBufferSync = frame.submitSync;
+
+    commandBufferSync = frame.commandBufferSync;
+
+    const DeviceCommands deviceCommands = [&](vk::CommandBuffer cb)
+        {
+            renderCommands(cb, imageIndex);
+
+            // Sync is read by SubmitCommandBuffer after recording, so async compute submitted during it is waited
+            if (frame.computeWaitStages)
+            {
+                commandBufferSync.waitSemaphores.push_back(frame.computeSemaphore);
+                commandBufferSync.waitStages.push_back(frame.computeWaitStages);
+            }
+        };
+
+    {
+        const std::unique_lock lock = VulkanContext::device->LockQueues();
+
+        VulkanHelpers::SubmitCommandBuffer(queues.graphics, frame.commandBuffer, deviceCommands, commandBufferSync);
+
+        Details::PresentImage(queues.present, imageIndex, commandBufferSync.signalSemaphores.front());
+    }
 
     currentFrameIndex = (currentFrameIndex + 1) % frames.size();
 }
 
+LinearArena& FrameLoop::GetArena()
+{
+    return frames[currentFrameIndex].arena;
+}
+
+void FrameLoop::ExecuteAsyncCompute(vk::CommandBuffer frameCommandBuffer,
+        const DeviceCommands& commands, vk::PipelineStageFlags waitStages)
+{
+    if (!VulkanContext::device->HasAsyncComputeQueue())
+    {
+        commands(frameCommandBuffer);
+        return;
+    }
+
+    Frame& frame = frames[currentFrameIndex];
+
+    Assert(frame.commandBuffer == frameCommandBuffer);
+    Assert(!frame.computeWaitStages);
+
+    const CommandBufferSync computeSync{
+        .signalSemaphores = { frame.computeSemaphore }
+    };
+
+    {
+        const std::unique_lock lock = VulkanContext::device->LockQueues();
+
+        VulkanHelpers::SubmitCommandBuffer(VulkanContext::device->GetQueues().compute,
+                frame.computeCommandBuffer, commands, computeSync);
+    }
+
+    frame.computeWaitStages = waitStages;
+}
+
 void FrameLoop::DestroyResource(std::function<void()>&& destroyTask)
 {
     std::set<uint32_t> framesToWait;
@@ -124,11 +217,15 @@ void FrameLoop::DestroyResource(std::function<void()>&& destroyTask)
         }
     }
 
+    const std::lock_guard lock(resourcesToDestroyMutex);
+
     resourcesToDestroy.push_back(ResourceToDestroy{ destroyTask, std::move(framesToWait) });
 }
 
 void FrameLoop::UpdateResourcesToDestroy()
 {
+    const std::lock_guard lock(resourcesToDestroyMutex);
+
     for (ResourceToDestroy& resourceToDestroy : resourcesToDestroy)
     {
         std::erase_if(resourceToDestroy.framesToWait, [&](uint32_t frameIndex)
@@ -147,3 +244,20 @@ void FrameLoop::UpdateResourcesToDestroy()
             return resourceToDestroy.framesToWait.empty();
         });
 }
+
+void FrameLoop::UpdateAllocationStats()
+{
+    const uint64_t allocationCount = AllocationCounter::GetTotalCount();
+    const uint64_t threadAllocationCount = AllocationCounter::GetThreadCount();
+
+    // Counted between consecutive frames, so a frame includes snapshot extraction and recording
+    RenderContext::stats.frameAllocationCount = static_cast<uint32_t>(allocationCount - lastAllocationCount);
+    RenderContext::stats.renderThreadAllocationCount
+            = static_cast<uint32_t>(threadAllocationCount - lastThreadAllocationCount);
+
+    lastAllocationCount = allocationCount;
+    lastThreadAllocationCount = threadAllocationCount;
+
+    // Arena of the frame slot is not reset yet and holds data of the frame recorded frame count frames ago
+    RenderContext::stats.frameArenaUsedBytes = frames[currentFrameIndex].arena.GetUsedSize();
+}
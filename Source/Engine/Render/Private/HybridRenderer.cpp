@@ -4,6 +4,8 @@
 #include "Engine/Engine.hpp"
 #include "Engine/EngineHelpers.hpp"
 #include "Engine/InputHelpers.hpp"
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderThread.hpp"
 #include "Engine/Render/Stages/ForwardStage.hpp"
 #include "Engine/Render/Stages/GBufferStage.hpp"
 #include "Engine/Render/Stages/LightingStage.hpp"
@@ -69,20 +71,20 @@ void HybridRenderer::RemoveScene()
     scene = nullptr;
 }
 
-void HybridRenderer::Update() const
+void HybridRenderer::Update(const RenderSnapshot& snapshot) const
 {
-    gBufferStage->Update();
-    lightingStage->Update();
-    forwardStage->Update();
+    gBufferStage->Update(snapshot);
+    lightingStage->Update(snapshot);
+    forwardStage->Update(snapshot);
 }
 
-void HybridRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void HybridRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const
 {
     if (scene)
     {
-        gBufferStage->Execute(commandBuffer, imageIndex);
-        lightingStage->Execute(commandBuffer, imageIndex);
-        forwardStage->Execute(commandBuffer, imageIndex);
+        gBufferStage->Execute(commandBuffer, imageIndex, snapshot);
+        lightingStage->Execute(commandBuffer, imageIndex, snapshot);
+        forwardStage->Execute(commandBuffer, imageIndex, snapshot);
     }
     else
     {
@@ -121,6 +123,8 @@ void HybridRenderer::ReloadShaders() const
         return;
     }
 
+    RenderContext::renderThread->Flush();
+
     VulkanContext::device->WaitIdle();
 
     gBufferStage->ReloadShaders();
@@ -0,0 +1,274 @@
+#include "Engine/Render/OcclusionCuller.hpp"
+
+#include <xmmintrin.h>
+
+namespace Details
+{
+    static constexpr float kMinW = 1e-3f;
+
+    static const glm::vec2 kScreenSize(OcclusionCuller::kWidth, OcclusionCuller::kHeight);
+
+    static glm::vec4 ProjectToScreen(const glm::vec4& clipPosition)
+    {
+        const float invW = 1.0f / clipPosition.w;
+
+        const glm::vec2 ndc = glm::vec2(clipPosition) * invW;
+
+        const glm::vec2 screenPosition = (ndc * 0.5f + 0.5f) * kScreenSize;
+
+        return glm::vec4(screenPosition, invW, clipPosition.w);
+    }
+
+    static float EdgeFunction(const glm::vec3& a, const glm::vec3& b, const glm::vec3& p)
+    {
+        return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+    }
+}
+
+OcclusionCuller::OcclusionCuller()
+{
+    static_assert(kWidth % 4 == 0);
+
+    uint32_t width = kWidth;
+    uint32_t height = kHeight;
+
+    while (true)
+    {
+        levels.push_back(Level{ width, height, std::vector<float>(width * height, 0.0f) });
+
+        if (width == 1 && height == 1)
+        {
+            break;
+        }
+
+        width = std::max((width + 1) / 2, 1u);
+        height = std::max((height + 1) / 2, 1u);
+    }
+}
+
+void OcclusionCuller::Begin(const glm::mat4& viewProjMatrix_)
+{
+    viewProjMatrix = viewProjMatrix_;
+
+    for (auto& level : levels)
+    {
+        std::fill(level.depth.begin(), level.depth.end(), 0.0f);
+    }
+}
+
+void OcclusionCuller::RasterizeOccluder(const std::vector<glm::vec3>& positions,
+        const std::vector<uint32_t>& indices, const glm::mat4& transform)
+{
+    EASY_FUNCTION()
+
+    const glm::mat4 matrix = viewProjMatrix * transform;
+
+    screenPositions.resize(positions.size());
+
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const glm::vec4 clipPosition = matrix * glm::vec4(positions[i], 1.0f);
+
+        if (clipPosition.w > Details::kMinW)
+        {
+            screenPositions[i] = Details::ProjectToScreen(clipPosition);
+        }
+        else
+        {
+            screenPositions[i] = glm::vec4(0.0f);
+        }
+    }
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const glm::vec4& v0 = screenPositions[indices[i]];
+        const glm::vec4& v1 = screenPositions[indices[i + 1]];
+        const glm::vec4& v2 = screenPositions[indices[i + 2]];
+
+        // Triangles crossing near plane are skipped, it only makes occluders less effective
+        if (v0.w > Details::kMinW && v1.w > Details::kMinW && v2.w > Details::kMinW)
+        {
+            RasterizeTriangle(glm::vec3(v0), glm::vec3(v1), glm::vec3(v2));
+        }
+    }
+}
+
+void OcclusionCuller::BuildHierarchy()
+{
+    EASY_FUNCTION()
+
+    for (size_t i = 1; i < levels.size(); ++i)
+    {
+        const Level& src = levels[i - 1];
+        Level& dst = levels[i];
+
+        for (uint32_t y = 0; y < dst.height; ++y)
+        {
+            const uint32_t y0 = std::min(y * 2, src.height - 1);
+            const uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                const uint32_t x0 = std::min(x * 2, src.width - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+
+                dst.depth[y * dst.width + x] = std::min(
+                        std::min(src.depth[y0 * src.width + x0], src.depth[y0 * src.width + x1]),
+                        std::min(src.depth[y1 * src.width + x0], src.depth[y1 * src.width + x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsOccluded(const AABBox& bbox) const
+{
+    glm::vec2 screenMin(std::numeric_limits<float>::max());
+    glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+
+    float nearestDepth = 0.0f;
+
+    for (const auto& corner : bbox.GetCorners())
+    {
+        const glm::vec4 clipPosition = viewProjMatrix * glm::vec4(corner, 1.0f);
+
+        if (clipPosition.w <= Details::kMinW)
+        {
+            return false;
+        }
+
+        const glm::vec4 screenPosition = Details::ProjectToScreen(clipPosition);
+
+        screenMin = glm::min(screenMin, glm::vec2(screenPosition));
+        screenMax = glm::max(screenMax, glm::vec2(screenPosition));
+
+        nearestDepth = std::max(nearestDepth, screenPosition.z);
+    }
+
+    screenMin = glm::clamp(screenMin, glm::vec2(0.0f), Details::kScreenSize - 1.0f);
+    screenMax = glm::clamp(screenMax, glm::vec2(0.0f), Details::kScreenSize - 1.0f);
+
+    const glm::vec2 screenSize = screenMax - screenMin;
+
+    const float levelSize = std::max(std::max(screenSize.x, screenSize.y), 1.0f);
+
+    const size_t levelIndex = std::min(static_cast<size_t>(std::ceil(std::log2(levelSize))), levels.size() - 1);
+
+    const Level& level = levels[levelIndex];
+
+    const float scale = 1.0f / static_cast<float>(1 << levelIndex);
+
+    const uint32_t minX = std::min(static_cast<uint32_t>(screenMin.x * scale), level.width - 1);
+    const uint32_t minY = std::min(static_cast<uint32_t>(screenMin.y * scale), level.height - 1);
+    const uint32_t maxX = std::min(static_cast<uint32_t>(screenMax.x * scale), level.width - 1);
+    const uint32_t maxY = std::min(static_cast<uint32_t>(screenMax.y * scale), level.height - 1);
+
+    for (uint32_t y = minY; y <= maxY; ++y)
+    {
+        for (uint32_t x = minX; x <= maxX; ++x)
+        {
+            if (nearestDepth >= level.depth[y * level.width + x])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void OcclusionCuller::RasterizeTriangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2)
+{
+    float area = Details::EdgeFunction(v0, v1, v2);
+
+    if (std::abs(area) < std::numeric_limits<float>::epsilon())
+    {
+        return;
+    }
+
+    if (area < 0.0f)
+    {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    const glm::vec2 triangleMin = glm::min(glm::min(glm::vec2(v0), glm::vec2(v1)), glm::vec2(v2));
+    const glm::vec2 triangleMax = glm::max(glm::max(glm::vec2(v0), glm::vec2(v1)), glm::vec2(v2));
+
+    if (triangleMax.x < 0.0f || triangleMax.y < 0.0f
+            || triangleMin.x >= Details::kScreenSize.x || triangleMin.y >= Details::kScreenSize.y)
+    {
+        return;
+    }
+
+    const int32_t minX = std::max(static_cast<int32_t>(triangleMin.x), 0) & ~3;
+    const int32_t minY = std::max(static_cast<int32_t>(triangleMin.y), 0);
+    const int32_t maxX = std::min(static_cast<int32_t>(triangleMax.x), static_cast<int32_t>(kWidth) - 1);
+    const int32_t maxY = std::min(static_cast<int32_t>(triangleMax.y), static_cast<int32_t>(kHeight) - 1);
+
+    // Edge functions are linear: e(x, y) = a * x + b * y + c
+    const std::array<std::pair<glm::vec3, glm::vec3>, 3> edges{
+        std::make_pair(v1, v2), std::make_pair(v2, v0), std::make_pair(v0, v1)
+    };
+
+    // Vector types as template arguments lose their alignment attributes
+    __m128 edgeA[3];
+    std::array<float, 3> edgeB;
+    std::array<float, 3> edgeC;
+
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        const auto& [a, b] = edges[i];
+
+        edgeA[i] = _mm_set1_ps(a.y - b.y);
+        edgeB[i] = b.x - a.x;
+        edgeC[i] = (b.y - a.y) * a.x - (b.x - a.x) * a.y;
+    }
+
+    const float invArea = 1.0f / area;
+
+    const __m128 depth0 = _mm_set1_ps(v0.z * invArea);
+    const __m128 depth1 = _mm_set1_ps(v1.z * invArea);
+    const __m128 depth2 = _mm_set1_ps(v2.z * invArea);
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 pixelOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    std::vector<float>& depthBuffer = levels.front().depth;
+
+    for (int32_t y = minY; y <= maxY; ++y)
+    {
+        const float pixelY = static_cast<float>(y) + 0.5f;
+
+        const __m128 rowC0 = _mm_set1_ps(edgeB[0] * pixelY + edgeC[0]);
+        const __m128 rowC1 = _mm_set1_ps(edgeB[1] * pixelY + edgeC[1]);
+        const __m128 rowC2 = _mm_set1_ps(edgeB[2] * pixelY + edgeC[2]);
+
+        float* row = depthBuffer.data() + y * kWidth;
+
+        for (int32_t x = minX; x <= maxX; x += 4)
+        {
+            const __m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), pixelOffset);
+
+            const __m128 w0 = _mm_add_ps(_mm_mul_ps(edgeA[0], pixelX), rowC0);
+            const __m128 w1 = _mm_add_ps(_mm_mul_ps(edgeA[1], pixelX), rowC1);
+            const __m128 w2 = _mm_add_ps(_mm_mul_ps(edgeA[2], pixelX), rowC2);
+
+            const __m128 inside = _mm_and_ps(_mm_cmpge_ps(w0, zero),
+                    _mm_and_ps(_mm_cmpge_ps(w1, zero), _mm_cmpge_ps(w2, zero)));
+
+            if (_mm_movemask_ps(inside) == 0)
+            {
+                continue;
+            }
+
+            __m128 depth = _mm_mul_ps(w0, depth0);
+            depth = _mm_add_ps(_mm_mul_ps(w1, depth1), depth);
+            depth = _mm_add_ps(_mm_mul_ps(w2, depth2), depth);
+
+            const __m128 oldDepth = _mm_loadu_ps(row + x);
+            const __m128 newDepth = _mm_max_ps(oldDepth, depth);
+
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, newDepth), _mm_andnot_ps(inside, oldDepth)));
+        }
+    }
+}
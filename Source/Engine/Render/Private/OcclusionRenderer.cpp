@@ -115,11 +115,6 @@ namespace Details
                     defines),
         };
 
-        const VertexInput vertexInput{
-            { vk::Format::eR32G32B32Sfloat },
-            0, vk::VertexInputRate::eVertex
-        };
-
         const GraphicsPipeline::Description description{
             vk::PrimitiveTopology::eTriangleList,
             vk::PolygonMode::eFill,
@@ -128,7 +123,7 @@ namespace Details
             vk::SampleCountFlagBits::e1,
             vk::CompareOp::eLess,
             shaderModules,
-            { vertexInput },
+            { GeometryArena::GetPositionVertexInput() },
             {}
         };
 
@@ -206,6 +201,7 @@ OcclusionRenderer::OcclusionRenderer(const Scene* scene_)
     cameraBuffer = Details::CreateCameraBuffer();
 
     pipeline = Details::CreatePipeline(*renderPass);
+    transformHandle = pipeline->GetPushConstantHandle("transform");
 
     descriptorProvider = pipeline->CreateDescriptorProvider();
     descriptorProvider->PushGlobalData("viewProj", cameraBuffer);
@@ -277,18 +273,17 @@ void OcclusionRenderer::Render(vk::CommandBuffer commandBuffer) const
 
     const auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
 
+    GeometryArena::Bind(commandBuffer, GeometryArena::GetBuffers(), true);
+
     for (auto&& [entity, tc, rc] : sceneRenderView.each())
     {
         for (const auto& ro : rc.renderObjects)
         {
-            pipeline->PushConstant(commandBuffer, "transform", tc.GetWorldTransform().GetMatrix());
+            pipeline->PushConstant(commandBuffer, transformHandle, tc.GetWorldTransform().GetMatrix());
 
             const Primitive& primitive = geometryComponent.primitives[ro.primitive];
 
-            commandBuffer.bindIndexBuffer(primitive.GetIndexBuffer(), 0, vk::IndexType::eUint32);
-            commandBuffer.bindVertexBuffers(0, { primitive.GetPositionBuffer() }, { 0 });
-
-            commandBuffer.drawIndexed(primitive.GetIndexCount(), 1, 0, 0, 0);
+            primitive.Draw(commandBuffer);
         }
     }
 
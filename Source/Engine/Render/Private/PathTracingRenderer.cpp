@@ -1,5 +1,9 @@
 #include "Engine/Render/PathTracingRenderer.hpp"
 
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderHelpers.hpp"
+#include "Engine/Render/RenderSnapshot.hpp"
+#include "Engine/Render/RenderThread.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderManager.hpp"
 #include "Engine/Render/Vulkan/Pipelines/RayTracingPipeline.hpp"
@@ -37,11 +41,18 @@ namespace Details
 
     static std::unique_ptr<RayTracingPipeline> CreateRayTracingPipeline()
     {
+        const uint32_t vertexLayout = static_cast<uint32_t>(GeometryArena::GetVertexLayout());
+
         const ShaderDefines rayGenDefines{
             std::make_pair("ACCUMULATION", 1),
             std::make_pair("RENDER_TO_HDR", 0),
             std::make_pair("RENDER_TO_CUBE", 0),
             std::make_pair("SAMPLE_COUNT", kSampleCount),
+            std::make_pair("VERTEX_LAYOUT", vertexLayout),
+        };
+
+        const ShaderDefines hitDefines{
+            std::make_pair("VERTEX_LAYOUT", vertexLayout),
         };
 
         const std::vector<ShaderModule> shaderModules{
@@ -54,10 +65,12 @@ namespace Details
                     vk::ShaderStageFlagBits::eMissKHR),
             VulkanContext::shaderManager->CreateShaderModule(
                     Filepath("~/Shaders/PathTracing/ClosestHit.rchit"),
-                    vk::ShaderStageFlagBits::eClosestHitKHR),
+                    vk::ShaderStageFlagBits::eClosestHitKHR,
+                    hitDefines),
             VulkanContext::shaderManager->CreateShaderModule(
                     Filepath("~/Shaders/PathTracing/AnyHit.rahit"),
-                    vk::ShaderStageFlagBits::eAnyHitKHR)
+                    vk::ShaderStageFlagBits::eAnyHitKHR,
+                    hitDefines)
         };
 
         ShaderGroupMap shaderGroupMap;
@@ -84,42 +97,30 @@ namespace Details
         return pipeline;
     }
 
+    static void PushGeometryDescriptorData(DescriptorProvider& descriptorProvider,
+            const RayTracingContextComponent& rayTracingComponent)
+    {
+        descriptorProvider.PushGlobalData("primitives", rayTracingComponent.primitiveBuffer);
+        descriptorProvider.PushGlobalData("vertexIndices", GeometryArena::GetIndexBuffer());
+        descriptorProvider.PushGlobalData("vertexNormals", GeometryArena::GetVertexBuffer(VertexAttribute::eNormal));
+        descriptorProvider.PushGlobalData("vertexTangents", GeometryArena::GetVertexBuffer(VertexAttribute::eTangent));
+        descriptorProvider.PushGlobalData("vertexTexCoords", GeometryArena::GetVertexBuffer(VertexAttribute::eTexCoord));
+    }
+
     static void CreateDescriptors(DescriptorProvider& descriptorProvider,
             const Scene& scene, const RenderTarget& accumulationTarget)
     {
         const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
         const auto& rayTracingComponent = scene.ctx().get<RayTracingContextComponent>();
         const auto& textureComponent = scene.ctx().get<TextureStorageComponent>();
-        const auto& geometryComponent = scene.ctx().get<GeometryStorageComponent>();
         const auto& environmentComponent = scene.ctx().get<EnvironmentComponent>();
 
-        std::vector<vk::Buffer> indexBuffers;
-        std::vector<vk::Buffer> normalsBuffers;
-        std::vector<vk::Buffer> tangentsBuffers;
-        std::vector<vk::Buffer> texCoordBuffers;
-
-        indexBuffers.reserve(geometryComponent.primitives.size());
-        normalsBuffers.reserve(geometryComponent.primitives.size());
-        tangentsBuffers.reserve(geometryComponent.primitives.size());
-        texCoordBuffers.reserve(geometryComponent.primitives.size());
-
-        for (const auto& primitive : geometryComponent.primitives)
-        {
-            indexBuffers.push_back(primitive.GetIndexBuffer());
-            normalsBuffers.push_back(primitive.GetNormalBuffer());
-            tangentsBuffers.push_back(primitive.GetTangentBuffer());
-            texCoordBuffers.push_back(primitive.GetTexCoordBuffer());
-        }
-
         descriptorProvider.PushGlobalData("lights", renderComponent.lightBuffer);
         descriptorProvider.PushGlobalData("materials", renderComponent.materialBuffer);
-        descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures);
+        descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
         descriptorProvider.PushGlobalData("environmentMap", &environmentComponent.cubemapTexture);
-        descriptorProvider.PushGlobalData("tlas", &rayTracingComponent.tlas);
-        descriptorProvider.PushGlobalData("indexBuffers", &indexBuffers);
-        descriptorProvider.PushGlobalData("normalBuffers", &normalsBuffers);
-        descriptorProvider.PushGlobalData("tangentBuffers", &tangentsBuffers);
-        descriptorProvider.PushGlobalData("texCoordBuffers", &texCoordBuffers);
+        RenderHelpers::PushTlasDescriptorData(scene, descriptorProvider);
+        PushGeometryDescriptorData(descriptorProvider, rayTracingComponent);
         descriptorProvider.PushGlobalData("accumulationTarget", accumulationTarget.view);
 
         for (uint32_t i = 0; i < VulkanContext::swapchain->GetImageCount(); ++i)
@@ -139,6 +140,8 @@ PathTracingRenderer::PathTracingRenderer()
     accumulationTarget = Details::CreateAccumulationTarget(VulkanContext::swapchain->GetExtent());
 
     rayTracingPipeline = Details::CreateRayTracingPipeline();
+    lightCountHandle = rayTracingPipeline->GetPushConstantHandle("lightCount");
+    accumulationIndexHandle = rayTracingPipeline->GetPushConstantHandle("accumulationIndex");
 
     descriptorProvider = rayTracingPipeline->CreateDescriptorProvider();
 
@@ -182,55 +185,34 @@ void PathTracingRenderer::RemoveScene()
     scene = nullptr;
 }
 
-void PathTracingRenderer::Update() const
+void PathTracingRenderer::Update(const RenderSnapshot& snapshot) const
 {
     const auto& textureComponent = scene->ctx().get<TextureStorageComponent>();
-    const auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
     const auto& rayTracingComponent = scene->ctx().get<RayTracingContextComponent>();
 
-    if (geometryComponent.updated)
+    // Geometry arena buffers are recreated when it grows
+    if (snapshot.geometryUpdated)
     {
-        std::vector<vk::Buffer> indexBuffers;
-        std::vector<vk::Buffer> normalsBuffers;
-        std::vector<vk::Buffer> tangentsBuffers;
-        std::vector<vk::Buffer> texCoordBuffers;
-
-        indexBuffers.reserve(geometryComponent.primitives.size());
-        normalsBuffers.reserve(geometryComponent.primitives.size());
-        tangentsBuffers.reserve(geometryComponent.primitives.size());
-        texCoordBuffers.reserve(geometryComponent.primitives.size());
-
-        for (const auto& primitive : geometryComponent.primitives)
-        {
-            indexBuffers.push_back(primitive.GetIndexBuffer());
-            normalsBuffers.push_back(primitive.GetNormalBuffer());
-            tangentsBuffers.push_back(primitive.GetTangentBuffer());
-            texCoordBuffers.push_back(primitive.GetTexCoordBuffer());
-        }
-
-        descriptorProvider->PushGlobalData("indexBuffers", &indexBuffers);
-        descriptorProvider->PushGlobalData("normalBuffers", &normalsBuffers);
-        descriptorProvider->PushGlobalData("tangentBuffers", &tangentsBuffers);
-        descriptorProvider->PushGlobalData("texCoordBuffers", &texCoordBuffers);
+        Details::PushGeometryDescriptorData(*descriptorProvider, rayTracingComponent);
     }
 
     if (rayTracingComponent.updated)
     {
-        descriptorProvider->PushGlobalData("tlas", &rayTracingComponent.tlas);
+        RenderHelpers::PushTlasDescriptorData(*scene, *descriptorProvider);
     }
 
-    if (textureComponent.updated)
+    if (snapshot.texturesUpdated)
     {
-        descriptorProvider->PushGlobalData("materialTextures", &textureComponent.textures);
+        descriptorProvider->PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
     }
 
-    if (geometryComponent.updated || textureComponent.updated || rayTracingComponent.updated)
+    if (snapshot.geometryUpdated || snapshot.texturesUpdated || rayTracingComponent.updated)
     {
         descriptorProvider->FlushData();
     }
 }
 
-void PathTracingRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
+void PathTracingRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot)
 {
     {
         const vk::Image swapchainImage = VulkanContext::swapchain->GetImages()[imageIndex];
@@ -254,11 +236,13 @@ void PathTracingRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t image
 
         rayTracingPipeline->BindDescriptorSets(commandBuffer, descriptorProvider->GetDescriptorSlice(imageIndex));
 
-        rayTracingPipeline->PushConstant(commandBuffer, "accumulationIndex", accumulationIndex++);
+        const uint32_t lightCount = static_cast<uint32_t>(snapshot.lights.size());
 
-        const uint32_t lightCount = static_cast<uint32_t>(scene->view<LightComponent>().size());
+        const PushConstantBlock pushConstants = PushConstantBlock()
+                .Set(lightCountHandle, lightCount)
+                .Set(accumulationIndexHandle, accumulationIndex++);
 
-        rayTracingPipeline->PushConstant(commandBuffer, "lightCount", lightCount);
+        rayTracingPipeline->PushConstants(commandBuffer, pushConstants);
 
         const vk::Extent2D extent = VulkanContext::swapchain->GetExtent();
 
@@ -320,11 +304,15 @@ void PathTracingRenderer::ReloadShaders()
         return;
     }
 
+    RenderContext::renderThread->Flush();
+
     VulkanContext::device->WaitIdle();
 
     ResetAccumulation();
 
     rayTracingPipeline = Details::CreateRayTracingPipeline();
+    lightCountHandle = rayTracingPipeline->GetPushConstantHandle("lightCount");
+    accumulationIndexHandle = rayTracingPipeline->GetPushConstantHandle("accumulationIndex");
 
     descriptorProvider = rayTracingPipeline->CreateDescriptorProvider();
 
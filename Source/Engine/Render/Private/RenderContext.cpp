@@ -1,19 +1,28 @@
 #include "Engine/Render/RenderContext.hpp"
 
+#include "Engine/Render/CommandRecorder.hpp"
 #include "Engine/Render/FrameLoop.hpp"
+#include "Engine/Render/RenderStats.hpp"
+#include "Engine/Render/RenderThread.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Scene/ImageBasedLighting.hpp"
 #include "Engine/Scene/GlobalIllumination.hpp"
 
 std::unique_ptr<FrameLoop> RenderContext::frameLoop;
+std::unique_ptr<CommandRecorder> RenderContext::commandRecorder;
+std::unique_ptr<RenderThread> RenderContext::renderThread;
 std::unique_ptr<ImageBasedLighting> RenderContext::imageBasedLighting;
 std::unique_ptr<GlobalIllumination> RenderContext::globalIllumination;
 
+RecordStats RenderContext::stats;
+
 void RenderContext::Create()
 {
     EASY_FUNCTION()
 
     frameLoop = std::make_unique<FrameLoop>();
+    commandRecorder = std::make_unique<CommandRecorder>(frameLoop->GetFrameCount());
+    renderThread = std::make_unique<RenderThread>();
     imageBasedLighting = std::make_unique<ImageBasedLighting>();
     globalIllumination = std::make_unique<GlobalIllumination>();
 }
@@ -22,5 +31,7 @@ void RenderContext::Destroy()
 {
     imageBasedLighting.reset();
     globalIllumination.reset();
+    renderThread.reset();
+    commandRecorder.reset();
     frameLoop.reset();
 }
@@ -1,6 +1,10 @@
 #include "Engine/Render/RenderHelpers.hpp"
 
+#include "Engine/ConsoleVariable.hpp"
+#include "Engine/Render/FrameLoop.hpp"
 #include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderList.hpp"
+#include "Engine/Render/RenderStats.hpp"
 #include "Engine/Render/SceneRenderer.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Pipelines/GraphicsPipeline.hpp"
@@ -11,6 +15,17 @@
 #include "Engine/Scene/ImageBasedLighting.hpp"
 #include "Engine/Scene/Scene.hpp"
 
+#include <atomic>
+
+namespace Details
+{
+    static bool indirectDraws = true;
+    static CVarBool indirectDrawsCVar("r.IndirectDraws", indirectDraws);
+
+    constexpr uint32_t kMinDrawChunkSize = 64;
+    constexpr uint32_t kDrawChunksPerThread = 4;
+}
+
 vk::Rect2D RenderHelpers::GetSwapchainRenderArea()
 {
     return vk::Rect2D(vk::Offset2D(), VulkanContext::swapchain->GetExtent());
@@ -53,24 +68,64 @@ void RenderHelpers::PushRayTracingDescriptorData(const Scene& scene, DescriptorP
 {
     Assert(scene.ctx().contains<RayTracingContextComponent>());
 
-    const auto& geometryComponent = scene.ctx().get<GeometryStorageComponent>();
     const auto& rayTracingComponent = scene.ctx().get<RayTracingContextComponent>();
 
-    std::vector<vk::Buffer> indexBuffers;
-    std::vector<vk::Buffer> texCoordBuffers;
+    PushTlasDescriptorData(scene, descriptorProvider);
+
+    descriptorProvider.PushGlobalData("primitives", rayTracingComponent.primitiveBuffer);
+    descriptorProvider.PushGlobalData("vertexIndices", GeometryArena::GetIndexBuffer());
+    descriptorProvider.PushGlobalData("vertexTexCoords", GeometryArena::GetVertexBuffer(VertexAttribute::eTexCoord));
+}
+
+void RenderHelpers::PushTlasDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider)
+{
+    Assert(scene.ctx().contains<RayTracingContextComponent>());
+
+    const auto& rayTracingComponent = scene.ctx().get<RayTracingContextComponent>();
+
+    // TLAS is created with the first instances, null descriptors are written until then
+    static const vk::AccelerationStructureKHR kNullTlas;
+
+    for (uint32_t i = 0; i < VulkanContext::swapchain->GetImageCount(); ++i)
+    {
+        const vk::AccelerationStructureKHR* tlas = rayTracingComponent.tlases.empty()
+                ? &kNullTlas : &rayTracingComponent.tlases[i];
+
+        descriptorProvider.PushSliceData("tlas", tlas);
+    }
+}
+
+void RenderHelpers::PushDrawDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider)
+{
+    const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
+
+    for (const auto& instanceBuffer : renderComponent.instanceBuffers)
+    {
+        descriptorProvider.PushSliceData("instances", instanceBuffer);
+    }
+}
 
-    indexBuffers.reserve(geometryComponent.primitives.size());
-    texCoordBuffers.reserve(geometryComponent.primitives.size());
+void RenderHelpers::EnumeratePrimitiveSlots(const Scene& scene, const std::function<void(const Primitive&)>& func)
+{
+    const auto& primitives = scene.ctx().get<GeometryStorageComponent>().primitives;
+
+    if (primitives.IsEmpty())
+    {
+        return;
+    }
 
-    for (const auto& primitive : geometryComponent.primitives)
+    uint32_t fallbackIndex = 0;
+    while (!primitives.IsAlive(fallbackIndex))
     {
-        indexBuffers.push_back(primitive.GetIndexBuffer());
-        texCoordBuffers.push_back(primitive.GetTexCoordBuffer());
+        ++fallbackIndex;
     }
 
-    descriptorProvider.PushGlobalData("tlas", &rayTracingComponent.tlas);
-    descriptorProvider.PushGlobalData("indexBuffers", &indexBuffers);
-    descriptorProvider.PushGlobalData("texCoordBuffers", &texCoordBuffers);
+    const std::vector<Primitive>& slots = primitives.GetSlots();
+
+    for (uint32_t i = 0; i < primitives.GetSlotCount(); ++i)
+    {
+        func(primitives.IsAlive(i) ? slots[i] : slots[fallbackIndex]);
+    }
 }
 
 std::set<MaterialFlags> RenderHelpers::CacheMaterialPipelines(const Scene& scene,
@@ -80,15 +135,78 @@ std::set<MaterialFlags> RenderHelpers::CacheMaterialPipelines(const Scene& scene
 
     const auto& materialComponent = scene.ctx().get<MaterialStorageComponent>();
 
-    for (const auto& material : materialComponent.materials)
+    materialComponent.materials.Enumerate([&](MaterialHandle, const Material& material)
+        {
+            if (pred(material.flags))
+            {
+                cache.GetPipeline(material.flags);
+
+                uniquePipelines.emplace(material.flags);
+            }
+        });
+
+    return uniquePipelines;
+}
+
+void RenderHelpers::DrawObjects(vk::CommandBuffer commandBuffer, const RenderContextComponent& renderComponent,
+        uint32_t imageIndex, const DrawBucket& drawBucket)
+{
+    if (Details::indirectDraws)
+    {
+        constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+
+        commandBuffer.drawIndexedIndirect(renderComponent.drawCommandBuffers[imageIndex],
+                drawBucket.offset * stride, drawBucket.count, stride);
+
+        ++std::atomic_ref(RenderContext::stats.drawCallCount);
+    }
+    else
     {
-        if (pred(material.flags))
+        for (uint32_t i = drawBucket.offset; i < drawBucket.offset + drawBucket.count; ++i)
         {
-            cache.GetPipeline(material.flags);
+            const vk::DrawIndexedIndirectCommand& command = renderComponent.drawCommands[i];
 
-            uniquePipelines.emplace(material.flags);
+            commandBuffer.drawIndexed(command.indexCount, command.instanceCount,
+                    command.firstIndex, command.vertexOffset, command.firstInstance);
         }
+
+        std::atomic_ref(RenderContext::stats.drawCallCount) += drawBucket.count;
     }
+}
 
-    return uniquePipelines;
+ArenaVector<DrawBucket> RenderHelpers::SplitDrawBuckets(const std::vector<DrawBucket>& drawBuckets,
+        const std::set<MaterialFlags>& pipelines, uint32_t threadCount)
+{
+    uint32_t drawCount = 0;
+
+    for (const DrawBucket& drawBucket : drawBuckets)
+    {
+        if (pipelines.contains(drawBucket.pipeline))
+        {
+            drawCount += drawBucket.count;
+        }
+    }
+
+    const uint32_t chunkCount = threadCount * Details::kDrawChunksPerThread;
+    const uint32_t chunkSize = std::max((drawCount + chunkCount - 1) / chunkCount, Details::kMinDrawChunkSize);
+
+    ArenaVector<DrawBucket> drawChunks(RenderContext::frameLoop->GetArena());
+    drawChunks.reserve(chunkCount + drawBuckets.size());
+
+    for (const DrawBucket& drawBucket : drawBuckets)
+    {
+        if (!pipelines.contains(drawBucket.pipeline))
+        {
+            continue;
+        }
+
+        for (uint32_t offset = 0; offset < drawBucket.count; offset += chunkSize)
+        {
+            const uint32_t count = std::min(chunkSize, drawBucket.count - offset);
+
+            drawChunks.push_back(DrawBucket{ drawBucket.pipeline, drawBucket.offset + offset, count });
+        }
+    }
+
+    return drawChunks;
 }
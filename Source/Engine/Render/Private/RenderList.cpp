@@ -0,0 +1,118 @@
+#include "Engine/Render/RenderList.hpp"
+
+#include "Engine/Render/RenderSnapshot.hpp"
+#include "Engine/Scene/Components/Components.hpp"
+#include "Engine/Scene/Scene.hpp"
+
+#include "Utils/TimeHelpers.hpp"
+
+void RenderList::Invalidate()
+{
+    valid = false;
+}
+
+void RenderList::Apply(const Scene& scene, RenderSnapshot& snapshot)
+{
+    EASY_FUNCTION()
+
+    if (!valid || sortKeys.size() != snapshot.drawObjects.size())
+    {
+        Rebuild(scene, snapshot);
+    }
+
+    visibility.assign(sortKeys.size(), 0);
+
+    for (const uint32_t index : snapshot.visibleObjects)
+    {
+        visibility[index] = 1;
+    }
+
+    snapshot.visibleObjects.clear();
+    snapshot.drawBuckets.clear();
+
+    stats.pipelineChangeCount = 0;
+    stats.materialChangeCount = 0;
+    stats.primitiveChangeCount = 0;
+
+    const SortKey* previousKey = nullptr;
+
+    for (const SortKey& sortKey : sortKeys)
+    {
+        if (!visibility[sortKey.drawObject])
+        {
+            continue;
+        }
+
+        if (!previousKey || previousKey->pipeline != sortKey.pipeline)
+        {
+            const uint32_t offset = static_cast<uint32_t>(snapshot.visibleObjects.size());
+
+            snapshot.drawBuckets.push_back(DrawBucket{ sortKey.pipeline, offset, 0 });
+
+            ++stats.pipelineChangeCount;
+        }
+
+        if (!previousKey || previousKey->material != sortKey.material)
+        {
+            ++stats.materialChangeCount;
+        }
+
+        if (!previousKey || previousKey->primitive != sortKey.primitive)
+        {
+            ++stats.primitiveChangeCount;
+        }
+
+        snapshot.visibleObjects.push_back(sortKey.drawObject);
+
+        ++snapshot.drawBuckets.back().count;
+
+        previousKey = &sortKey;
+    }
+}
+
+void RenderList::Rebuild(const Scene& scene, const RenderSnapshot& snapshot)
+{
+    Timer timer;
+    timer.Tick();
+
+    const auto& materialComponent = scene.ctx().get<MaterialStorageComponent>();
+
+    sortKeys.clear();
+    sortKeys.reserve(snapshot.drawObjects.size());
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(snapshot.drawObjects.size()); ++i)
+    {
+        const RenderObject& ro = snapshot.drawObjects[i].renderObject;
+
+        sortKeys.push_back(SortKey{
+            .pipeline = materialComponent.materials[ro.material].flags,
+            .material = ro.material.index,
+            .primitive = ro.primitive.index,
+            .drawObject = i
+        });
+    }
+
+    std::ranges::sort(sortKeys);
+
+    // Keys differing only by draw object share all state
+    const auto isSameState = [](const SortKey& a, const SortKey& b)
+        {
+            return a.pipeline == b.pipeline && a.material == b.material && a.primitive == b.primitive;
+        };
+
+    stats.sortKeyCount = static_cast<uint32_t>(sortKeys.size());
+    stats.uniqueSortKeyCount = 0;
+
+    for (size_t i = 0; i < sortKeys.size(); ++i)
+    {
+        if (i == 0 || !isSameState(sortKeys[i - 1], sortKeys[i]))
+        {
+            ++stats.uniqueSortKeyCount;
+        }
+    }
+
+    ++stats.rebuildCount;
+    stats.rebuildSeconds = timer.Tick();
+
+    valid = true;
+}
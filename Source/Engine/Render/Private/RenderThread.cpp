@@ -0,0 +1,146 @@
+#include "Engine/Render/RenderThread.hpp"
+
+#include "Engine/ConsoleVariable.hpp"
+#include "Engine/Render/RenderContext.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/TimeHelpers.hpp"
+
+namespace Details
+{
+    static bool renderThreadEnabled = true;
+    static CVarBool renderThreadEnabledCVar("r.RenderThreadEnabled", renderThreadEnabled);
+}
+
+RenderThread::RenderThread()
+    : enabled(Details::renderThreadEnabled)
+{}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::Start(const SnapshotRenderFunc& renderFunc_)
+{
+    Assert(!thread.joinable());
+
+    renderFunc = renderFunc_;
+
+    if (enabled)
+    {
+        stopRequested = false;
+
+        thread = std::thread(&RenderThread::Run, this);
+    }
+}
+
+void RenderThread::Stop()
+{
+    if (thread.joinable())
+    {
+        Flush();
+
+        stopRequested = true;
+
+        readySnapshots.release();
+
+        thread.join();
+    }
+}
+
+RenderSnapshot& RenderThread::AcquireSnapshot()
+{
+    EASY_FUNCTION()
+
+    if (thread.joinable())
+    {
+        freeSnapshots.acquire();
+    }
+
+    const uint32_t slotIndex = static_cast<uint32_t>(submittedCount % kSnapshotCount);
+
+    // Acquired semaphore orders the copy after the render thread writes, so stats of one frame stay consistent
+    stats = snapshotStats[slotIndex];
+
+    RenderSnapshot& snapshot = snapshots[slotIndex];
+
+    snapshot.frameIndex = submittedCount;
+
+    return snapshot;
+}
+
+void RenderThread::SubmitSnapshot()
+{
+    const RenderSnapshot& snapshot = snapshots[submittedCount % kSnapshotCount];
+
+    ++submittedCount;
+
+    if (thread.joinable())
+    {
+        readySnapshots.release();
+    }
+    else
+    {
+        Render(snapshot);
+    }
+}
+
+void RenderThread::Flush()
+{
+    if (!thread.joinable())
+    {
+        return;
+    }
+
+    Assert(std::this_thread::get_id() != thread.get_id());
+
+    EASY_FUNCTION()
+
+    for (uint32_t i = 0; i < kSnapshotCount; ++i)
+    {
+        freeSnapshots.acquire();
+    }
+
+    freeSnapshots.release(kSnapshotCount);
+}
+
+void RenderThread::Run()
+{
+    EASY_THREAD_SCOPE("RenderThread")
+
+    uint64_t renderedCount = 0;
+
+    while (true)
+    {
+        readySnapshots.acquire();
+
+        if (stopRequested)
+        {
+            break;
+        }
+
+        Render(snapshots[renderedCount % kSnapshotCount]);
+
+        ++renderedCount;
+
+        freeSnapshots.release();
+    }
+}
+
+void RenderThread::Render(const RenderSnapshot& snapshot)
+{
+    EASY_FUNCTION()
+
+    Timer timer;
+    timer.Tick();
+
+    renderFunc(snapshot);
+
+    RenderStats& slotStats = snapshotStats[snapshot.frameIndex % kSnapshotCount];
+
+    slotStats.renderSeconds = timer.Tick();
+    slotStats.latencySeconds = Timer::GetGlobalSeconds() - snapshot.globalSeconds;
+    slotStats.extract = snapshot.extractStats;
+    slotStats.record = RenderContext::stats;
+}
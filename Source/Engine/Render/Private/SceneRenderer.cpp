@@ -6,14 +6,28 @@
 #include "Engine/Scene/SceneHelpers.hpp"
 #include "Engine/Scene/Components/Components.hpp"
 #include "Engine/Scene/Components/EnvironmentComponent.hpp"
+#include "Engine/Render/CommandRecorder.hpp"
+#include "Engine/Render/FrameLoop.hpp"
 #include "Engine/Render/HybridRenderer.hpp"
+#include "Engine/Render/OcclusionCuller.hpp"
 #include "Engine/Render/PathTracingRenderer.hpp"
+#include "Engine/Render/RenderHelpers.hpp"
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderList.hpp"
+#include "Engine/Render/RenderSnapshot.hpp"
+#include "Engine/Render/RenderStats.hpp"
+#include "Engine/Render/RenderThread.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Resources/BufferHelpers.hpp"
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 
+#include "Utils/Frustum.hpp"
+#include "Utils/TimeHelpers.hpp"
+
 #include "Shaders/Common/Common.h"
 
+#include <bit>
+
 namespace Details
 {
     static bool reversedDepth = true;
@@ -28,6 +42,22 @@ namespace Details
     static bool pathTracingAllowed = true;
     static CVarBool pathTracingAllowedCVar("r.PathTracingAllowed", rayTracingAllowed);
 
+    static bool frustumCulling = true;
+    static CVarBool frustumCullingCVar("r.FrustumCulling", frustumCulling);
+
+    static bool occlusionCulling = true;
+    static CVarBool occlusionCullingCVar("r.OcclusionCulling", occlusionCulling);
+
+    static constexpr uint32_t kMinTlasCapacity = 64;
+    static constexpr uint32_t kMaxTlasRefitCount = 64;
+    static constexpr float kMaxTlasBoundsGrowth = 1.5f;
+
+    static constexpr uint32_t kInitialDrawCapacity = 1024;
+
+    static constexpr size_t kMaxOccluderCount = 32;
+    static constexpr uint32_t kMaxOccluderTriangleCount = 4096;
+    static constexpr float kMinOccluderSize = 0.1f;
+
     static void EmplaceDefaultCamera(Scene& scene)
     {
         const entt::entity entity = scene.CreateEntity(entt::null, {});
@@ -56,6 +86,86 @@ namespace Details
         scene.ctx().emplace<EnvironmentComponent>(ec);
     }
 
+    static vk::QueryPool CreateTimestampQueryPool()
+    {
+        const vk::QueryPoolCreateInfo createInfo{
+            {}, vk::QueryType::eTimestamp, 2 * RenderContext::frameLoop->GetFrameCount()
+        };
+
+        const auto [result, queryPool] = VulkanContext::device->Get().createQueryPool(createInfo);
+        Assert(result == vk::Result::eSuccess);
+
+        return queryPool;
+    }
+
+    static std::optional<float> GetTimestampSeconds(vk::QueryPool queryPool, uint32_t firstQuery)
+    {
+        const vk::Device device = VulkanContext::device->Get();
+
+        const auto [result, timestamps] = device.getQueryPoolResults<uint64_t>(queryPool, firstQuery, 2,
+                2 * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+        if (result != vk::Result::eSuccess)
+        {
+            return std::nullopt;
+        }
+
+        const float timestampPeriod = VulkanContext::device->GetLimits().timestampPeriod;
+
+        return static_cast<float>(timestamps[1] - timestamps[0]) * timestampPeriod * Metric::kNano;
+    }
+
+    static float GetSurfaceArea(const AABBox& bbox)
+    {
+        const glm::vec3 size = bbox.GetSize();
+
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    static void CreateDrawBuffers(RenderContextComponent& renderComponent, uint32_t capacity)
+    {
+        const uint32_t imageCount = VulkanContext::swapchain->GetImageCount();
+
+        renderComponent.instanceBuffers.resize(imageCount);
+        renderComponent.drawCommandBuffers.resize(imageCount);
+
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            renderComponent.instanceBuffers[i] = ResourceContext::CreateBuffer({
+                .type = BufferType::eStorage,
+                .size = sizeof(gpu::DrawInstance) * capacity,
+                .usage = vk::BufferUsageFlagBits::eTransferDst,
+                .stagingBuffer = true
+            });
+
+            renderComponent.drawCommandBuffers[i] = ResourceContext::CreateBuffer({
+                .size = sizeof(vk::DrawIndexedIndirectCommand) * capacity,
+                .usage = vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                .stagingBuffer = true
+            });
+        }
+
+        renderComponent.drawCapacity = capacity;
+    }
+
+    // Previous buffers can still be used by frames in flight
+    static void DestroyDrawBuffers(RenderContextComponent& renderComponent)
+    {
+        for (const vk::Buffer buffer : renderComponent.instanceBuffers)
+        {
+            ResourceContext::DestroyResourceSafe(buffer);
+        }
+
+        for (const vk::Buffer buffer : renderComponent.drawCommandBuffers)
+        {
+            ResourceContext::DestroyResourceSafe(buffer);
+        }
+
+        renderComponent.instanceBuffers.clear();
+        renderComponent.drawCommandBuffers.clear();
+        renderComponent.drawCapacity = 0;
+    }
+
     static RenderContextComponent CreateRenderContextComponent()
     {
         RenderContextComponent renderComponent;
@@ -69,7 +179,7 @@ namespace Details
 
         renderComponent.materialBuffer = ResourceContext::CreateBuffer({
             .type = BufferType::eUniform,
-            .size = sizeof(gpu::Light) * MAX_MATERIAL_COUNT,
+            .size = sizeof(gpu::Material) * MAX_MATERIAL_COUNT,
             .usage = vk::BufferUsageFlagBits::eTransferDst,
             .stagingBuffer = true
         });
@@ -86,82 +196,354 @@ namespace Details
             });
         }
 
+        CreateDrawBuffers(renderComponent, kInitialDrawCapacity);
+
         return renderComponent;
     }
 
-    static void UpdateLightBuffer(vk::CommandBuffer commandBuffer, const Scene& scene)
+    static void ExtractDrawObjects(const Scene& scene, RenderSnapshot& snapshot)
+    {
+        const auto& geometryComponent = scene.ctx().get<GeometryStorageComponent>();
+
+        snapshot.drawObjects.clear();
+        snapshot.drawBounds.Clear();
+
+        for (auto&& [entity, tc, rc] : scene.view<TransformComponent, RenderComponent>().each())
+        {
+            const glm::mat4 transform = tc.GetWorldTransform().GetMatrix();
+
+            for (const auto& ro : rc.renderObjects)
+            {
+                const Primitive& primitive = geometryComponent.primitives[ro.primitive];
+
+                snapshot.drawObjects.push_back(RenderSnapshot::DrawObject{ transform, ro, primitive.GetGeometryRange() });
+
+                snapshot.drawBounds.Add(primitive.GetBBox(), transform);
+            }
+        }
+
+        for (auto&& [entity, tc, sic] : scene.view<TransformComponent, SharedInstanceComponent>().each())
+        {
+            const auto& prefab = scene.get<ScenePrefabComponent>(sic.prefab);
+
+            const glm::mat4 instanceTransform = tc.GetWorldTransform().GetMatrix();
+
+            for (const auto& [nodeTransform, ro] : prefab.renderNodes)
+            {
+                const glm::mat4 transform = instanceTransform * nodeTransform;
+
+                const Primitive& primitive = geometryComponent.primitives[ro.primitive];
+
+                snapshot.drawObjects.push_back(RenderSnapshot::DrawObject{
+                    transform, SceneHelpers::GetInstanceRenderObject(sic, ro), primitive.GetGeometryRange()
+                });
+
+                snapshot.drawBounds.Add(primitive.GetBBox(), transform);
+            }
+        }
+    }
+
+    static void CullOccludedObjects(const Scene& scene, RenderSnapshot& snapshot,
+            OcclusionCuller& occlusionCuller, LinearArena& arena)
     {
-        const auto sceneLightsView = scene.view<TransformComponent, LightComponent>();
+        EASY_FUNCTION()
+
+        const auto& geometryComponent = scene.ctx().get<GeometryStorageComponent>();
 
-        std::vector<gpu::Light> lights;
-        lights.reserve(sceneLightsView.size_hint());
+        const glm::vec3& cameraPosition = snapshot.camera.location.position;
 
-        for (auto&& [entity, tc, lc] : sceneLightsView.each())
+        ArenaVector<std::pair<float, uint32_t>> occluders(arena);
+
+        for (const uint32_t index : snapshot.visibleObjects)
         {
-            gpu::Light light{};
+            const Primitive& primitive = geometryComponent.primitives[snapshot.drawObjects[index].renderObject.primitive];
 
-            if (lc.type == LightType::eDirectional)
+            if (primitive.GetIndexCount() / 3 > kMaxOccluderTriangleCount)
             {
-                const glm::vec3 direction = tc.GetWorldTransform().GetAxis(Axis::eX);
+                continue;
+            }
+
+            const AABBox bbox = snapshot.drawBounds.Get(index);
 
-                light.location = glm::vec4(-direction, 0.0f);
+            const float radius = glm::length(bbox.GetSize()) * 0.5f;
+            const float distance = std::max(glm::distance(bbox.GetCenter(), cameraPosition), radius);
+
+            const float size = radius / std::max(distance, snapshot.camera.projection.zNear);
+
+            if (size >= kMinOccluderSize)
+            {
+                occluders.emplace_back(size, index);
             }
-            else if (lc.type == LightType::ePoint)
+        }
+
+        const size_t occluderCount = std::min(occluders.size(), kMaxOccluderCount);
+
+        std::partial_sort(occluders.begin(), occluders.begin() + occluderCount, occluders.end(), std::greater<>());
+
+        occlusionCuller.Begin(snapshot.camera.projMatrix * snapshot.camera.viewMatrix);
+
+        for (size_t i = 0; i < occluderCount; ++i)
+        {
+            const RenderSnapshot::DrawObject& drawObject = snapshot.drawObjects[occluders[i].second];
+
+            const Primitive& primitive = geometryComponent.primitives[drawObject.renderObject.primitive];
+
+            occlusionCuller.RasterizeOccluder(primitive.GetPositions(), primitive.GetIndices(), drawObject.transform);
+        }
+
+        occlusionCuller.BuildHierarchy();
+
+        std::erase_if(snapshot.visibleObjects, [&](uint32_t index)
             {
-                const glm::vec3 position = tc.GetWorldTransform().GetTranslation();
+                return occlusionCuller.IsOccluded(snapshot.drawBounds.Get(index));
+            });
+    }
+
+    static void CullDrawObjects(const Scene& scene, RenderSnapshot& snapshot,
+            OcclusionCuller& occlusionCuller, LinearArena& arena)
+    {
+        Timer timer;
+        timer.Tick();
+
+        if (frustumCulling)
+        {
+            const Frustum frustum(snapshot.camera.projMatrix * snapshot.camera.viewMatrix);
 
-                light.location = glm::vec4(position, 1.0f);
+            CullingHelpers::CullFrustum(frustum, snapshot.drawBounds, snapshot.visibleObjects);
+        }
+        else
+        {
+            snapshot.visibleObjects.clear();
+
+            for (uint32_t i = 0; i < snapshot.drawBounds.GetSize(); ++i)
+            {
+                snapshot.visibleObjects.push_back(i);
             }
+        }
+
+        const uint32_t drawObjectCount = static_cast<uint32_t>(snapshot.drawObjects.size());
+        const uint32_t frustumVisibleCount = static_cast<uint32_t>(snapshot.visibleObjects.size());
 
-            light.color = lc.color;
+        snapshot.extractStats.cullingSeconds = timer.Tick();
 
-            lights.push_back(light);
+        if (occlusionCulling)
+        {
+            CullOccludedObjects(scene, snapshot, occlusionCuller, arena);
         }
 
-        if (!lights.empty())
+        const uint32_t visibleObjectCount = static_cast<uint32_t>(snapshot.visibleObjects.size());
+
+        const auto& geometryComponent = scene.ctx().get<GeometryStorageComponent>();
+
+        uint64_t visibleVertexCount = 0;
+
+        for (const uint32_t index : snapshot.visibleObjects)
         {
-            const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
+            const PrimitiveHandle primitive = snapshot.drawObjects[index].renderObject.primitive;
+
+            visibleVertexCount += geometryComponent.primitives[primitive].GetVertexCount();
+        }
 
-            const BufferUpdate bufferUpdate{
-                .data = GetByteView(lights),
-                .blockedScope = SyncScope::kUniformRead
-            };
+        snapshot.extractStats.drawObjectCount = drawObjectCount;
+        snapshot.extractStats.frustumCulledCount = drawObjectCount - frustumVisibleCount;
+        snapshot.extractStats.occludedCount = frustumVisibleCount - visibleObjectCount;
+        snapshot.extractStats.submittedCount = visibleObjectCount;
+        snapshot.extractStats.vertexFetchBytes = visibleVertexCount * GeometryArena::GetStats().vertexSize;
+        snapshot.extractStats.occlusionSeconds = timer.Tick();
+    }
+
+    static gpu::Light GetLight(const TransformComponent& tc, const LightComponent& lc)
+    {
+        gpu::Light light{};
 
-            ResourceContext::UpdateBuffer(commandBuffer,
-                    renderComponent.lightBuffer, bufferUpdate);
+        if (lc.type == LightType::eDirectional)
+        {
+            const glm::vec3 direction = tc.GetWorldTransform().GetAxis(Axis::eX);
+
+            light.location = glm::vec4(-direction, 0.0f);
         }
+        else if (lc.type == LightType::ePoint)
+        {
+            const glm::vec3 position = tc.GetWorldTransform().GetTranslation();
+
+            light.location = glm::vec4(position, 1.0f);
+        }
+
+        light.color = lc.color;
+
+        return light;
     }
 
-    static void UpdateMaterialBuffer(vk::CommandBuffer commandBuffer, const Scene& scene)
+    static void SortDrawObjects(const Scene& scene, const SceneChanges& changes, bool fullUpdate,
+            RenderSnapshot& snapshot, RenderList& renderList)
     {
         const auto& materialComponent = scene.ctx().get<MaterialStorageComponent>();
 
-        std::vector<gpu::Material> materials;
-        materials.reserve(materialComponent.materials.size());
+        // Material flags define pipeline part of the sort key
+        if (fullUpdate || changes.renderObjects || !changes.materials.empty() || materialComponent.updated)
+        {
+            renderList.Invalidate();
+        }
+
+        renderList.Apply(scene, snapshot);
+
+        const RenderListStats& stats = renderList.GetStats();
+
+        snapshot.extractStats.sortKeyCount = stats.sortKeyCount;
+        snapshot.extractStats.uniqueSortKeyCount = stats.uniqueSortKeyCount;
+        snapshot.extractStats.renderListRebuildCount = stats.rebuildCount;
+        snapshot.extractStats.renderListRebuildSeconds = stats.rebuildSeconds;
+        snapshot.extractStats.pipelineChangeCount = stats.pipelineChangeCount;
+        snapshot.extractStats.materialChangeCount = stats.materialChangeCount;
+        snapshot.extractStats.primitiveChangeCount = stats.primitiveChangeCount;
+    }
+
+    static void ExtractLights(const Scene& scene, const SceneChanges& changes, bool fullUpdate,
+            std::vector<gpu::Light>& lights, std::unordered_map<entt::entity, uint32_t>& lightIndices,
+            RenderSnapshot& snapshot)
+    {
+        snapshot.lightsRange = DirtyRange{};
 
-        for (const Material& material : materialComponent.materials)
+        if (fullUpdate || changes.lightsAddedOrRemoved)
         {
-            materials.push_back(material.data);
+            lights.clear();
+            lightIndices.clear();
+
+            for (auto&& [entity, tc, lc] : scene.view<TransformComponent, LightComponent>().each())
+            {
+                lightIndices.emplace(entity, static_cast<uint32_t>(lights.size()));
+
+                lights.push_back(GetLight(tc, lc));
+            }
+
+            snapshot.lightsRange = DirtyRange{ 0, static_cast<uint32_t>(lights.size()) };
         }
+        else
+        {
+            for (const auto entity : changes.lights)
+            {
+                const auto it = lightIndices.find(entity);
+
+                if (it != lightIndices.end())
+                {
+                    lights[it->second] = GetLight(scene.get<TransformComponent>(entity), scene.get<LightComponent>(entity));
 
-        if (!materials.empty())
+                    snapshot.lightsRange.Add(it->second);
+                }
+            }
+        }
+
+        snapshot.lights = lights;
+    }
+
+    static void ExtractMaterials(const Scene& scene, const SceneChanges& changes, bool fullUpdate,
+            RenderSnapshot& snapshot)
+    {
+        const auto& materialComponent = scene.ctx().get<MaterialStorageComponent>();
+
+        const auto& slots = materialComponent.materials.GetSlots();
+
+        snapshot.materialsRange = DirtyRange{};
+
+        if (fullUpdate)
+        {
+            snapshot.materialsRange = DirtyRange{ 0, static_cast<uint32_t>(slots.size()) };
+        }
+        else
+        {
+            for (const MaterialHandle handle : changes.materials)
+            {
+                if (handle.index < slots.size())
+                {
+                    snapshot.materialsRange.Add(handle.index);
+                }
+            }
+        }
+
+        snapshot.materials.clear();
+
+        const uint32_t materialsEnd = snapshot.materialsRange.offset + snapshot.materialsRange.count;
+
+        for (uint32_t i = snapshot.materialsRange.offset; i < materialsEnd; ++i)
+        {
+            snapshot.materials.push_back(slots[i].data);
+        }
+    }
+
+    // Primitive buffer and TLAS are rebuilt by the render thread only when these are updated
+    static void ExtractRayTracingData(const Scene& scene, RenderSnapshot& snapshot)
+    {
+        if (!scene.ctx().contains<RayTracingContextComponent>())
         {
-            const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
+            return;
+        }
+
+        if (snapshot.geometryUpdated)
+        {
+            snapshot.primitiveRanges.clear();
+
+            RenderHelpers::EnumeratePrimitiveSlots(scene, [&](const Primitive& primitive)
+                {
+                    snapshot.primitiveRanges.push_back(primitive.GetGeometryRange());
+                });
+        }
+
+        if (snapshot.drawObjectsUpdated || snapshot.geometryUpdated)
+        {
+            snapshot.tlasInstances.clear();
+            snapshot.tlasInstances.reserve(snapshot.drawObjects.size());
+
+            for (const RenderSnapshot::DrawObject& drawObject : snapshot.drawObjects)
+            {
+                snapshot.tlasInstances.push_back(SceneHelpers::GetTlasInstance(scene,
+                        drawObject.transform, drawObject.renderObject));
+            }
+        }
+    }
+
+    static void UpdateLightBuffer(const Scene& scene, const RenderSnapshot& snapshot)
+    {
+        if (snapshot.lightsRange.IsEmpty())
+        {
+            return;
+        }
+
+        const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
+
+        const DataView<gpu::Light> lights(snapshot.lights.data() + snapshot.lightsRange.offset,
+                snapshot.lightsRange.count);
+
+        const BufferUpdate bufferUpdate{
+            .data = lights.GetByteView(),
+            .offset = snapshot.lightsRange.offset * sizeof(gpu::Light),
+            .blockedScope = SyncScope::kUniformRead
+        };
 
-            const BufferUpdate bufferUpdate{
-                .data = GetByteView(materials),
-                .blockedScope = SyncScope::kUniformRead
-            };
+        ResourceContext::EnqueueBufferUpdate(renderComponent.lightBuffer, bufferUpdate);
+    }
 
-            ResourceContext::UpdateBuffer(commandBuffer,
-                    renderComponent.materialBuffer, bufferUpdate);
+    static void UpdateMaterialBuffer(const Scene& scene, const RenderSnapshot& snapshot)
+    {
+        if (snapshot.materialsRange.IsEmpty())
+        {
+            return;
         }
+
+        const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
+
+        const BufferUpdate bufferUpdate{
+            .data = GetByteView(snapshot.materials),
+            .offset = snapshot.materialsRange.offset * sizeof(gpu::Material),
+            .blockedScope = SyncScope::kUniformRead
+        };
+
+        ResourceContext::EnqueueBufferUpdate(renderComponent.materialBuffer, bufferUpdate);
     }
 
-    static void UpdateFrameBuffer(vk::CommandBuffer commandBuffer, const Scene& scene, uint32_t imageIndex)
+    static void UpdateFrameBuffer(const Scene& scene, const RenderSnapshot& snapshot, uint32_t imageIndex)
     {
         const auto& renderComponent = scene.ctx().get<RenderContextComponent>();
-        const auto& cameraComponent = scene.ctx().get<CameraComponent>();
+        const auto& cameraComponent = snapshot.camera;
 
         const glm::mat4 viewProjMatrix = cameraComponent.projMatrix * cameraComponent.viewMatrix;
 
@@ -178,7 +560,7 @@ namespace Details
             cameraComponent.location.position,
             cameraComponent.projection.zNear,
             cameraComponent.projection.zFar,
-            Timer::GetGlobalSeconds(),
+            snapshot.globalSeconds,
             {}
         };
 
@@ -187,55 +569,311 @@ namespace Details
             .blockedScope = SyncScope::kUniformRead
         };
 
-        ResourceContext::UpdateBuffer(commandBuffer,
-                renderComponent.frameBuffers[imageIndex], bufferUpdate);
+        ResourceContext::EnqueueBufferUpdate(renderComponent.frameBuffers[imageIndex], bufferUpdate);
     }
 
-    static void UpdateTlas(vk::CommandBuffer, Scene& scene)
+    static void UpdateDrawBuffers(Scene& scene, const RenderSnapshot& snapshot, uint32_t imageIndex)
     {
-        TlasInstances tlasInstances;
+        EASY_FUNCTION()
 
-        for (auto&& [entity, tc, rc] : scene.view<TransformComponent, RenderComponent>().each())
+        auto& renderComponent = scene.ctx().get<RenderContextComponent>();
+
+        renderComponent.drawCommands.clear();
+
+        const uint32_t drawCount = static_cast<uint32_t>(snapshot.visibleObjects.size());
+
+        if (drawCount == 0)
         {
-            for (const auto& ro : rc.renderObjects)
+            return;
+        }
+
+        if (drawCount > renderComponent.drawCapacity)
+        {
+            DestroyDrawBuffers(renderComponent);
+            CreateDrawBuffers(renderComponent, std::bit_ceil(drawCount));
+
+            renderComponent.drawBuffersUpdated = true;
+        }
+
+        // Visible objects are already sorted by render list, commands of each draw bucket are contiguous
+        renderComponent.drawCommands.reserve(drawCount);
+
+        for (uint32_t i = 0; i < drawCount; ++i)
+        {
+            const GeometryRange& geometryRange = snapshot.drawObjects[snapshot.visibleObjects[i]].geometryRange;
+
+            renderComponent.drawCommands.emplace_back(geometryRange.indexCount, 1,
+                    geometryRange.firstIndex, static_cast<int32_t>(geometryRange.vertexOffset), i);
+        }
+
+        const BufferUpdate instanceUpdate{
+            .size = drawCount * sizeof(gpu::DrawInstance),
+            .blockedScope = SyncScope::kVertexShaderRead,
+            .updater = [&](const ByteAccess& data)
+                {
+                    gpu::DrawInstance* instances = reinterpret_cast<gpu::DrawInstance*>(data.data);
+
+                    for (uint32_t i = 0; i < drawCount; ++i)
+                    {
+                        const RenderSnapshot::DrawObject& drawObject = snapshot.drawObjects[snapshot.visibleObjects[i]];
+
+                        instances[i] = gpu::DrawInstance{ drawObject.transform, drawObject.renderObject.material.index, {} };
+                    }
+                }
+        };
+
+        const BufferUpdate commandUpdate{
+            .data = GetByteView(renderComponent.drawCommands),
+            .blockedScope = SyncScope::kIndirectCommandRead
+        };
+
+        ResourceContext::EnqueueBufferUpdate(renderComponent.instanceBuffers[imageIndex], instanceUpdate);
+        ResourceContext::EnqueueBufferUpdate(renderComponent.drawCommandBuffers[imageIndex], commandUpdate);
+    }
+
+    static void UpdatePrimitiveBuffer(const Scene& scene, const RenderSnapshot& snapshot)
+    {
+        if (!snapshot.geometryUpdated)
+        {
+            return;
+        }
+
+        const auto& rayTracingComponent = scene.ctx().get<RayTracingContextComponent>();
+
+        if (snapshot.primitiveRanges.empty())
+        {
+            return;
+        }
+
+        ArenaVector<gpu::Primitive> primitives(RenderContext::frameLoop->GetArena());
+        primitives.reserve(snapshot.primitiveRanges.size());
+
+        for (const GeometryRange& geometryRange : snapshot.primitiveRanges)
+        {
+            primitives.push_back(gpu::Primitive{ geometryRange.firstIndex, geometryRange.vertexOffset });
+        }
+
+        Assert(primitives.size() <= MAX_PRIMITIVE_COUNT);
+
+        const BufferUpdate bufferUpdate{
+            .data = GetByteView(primitives),
+            .blockedScope = SyncScope::kShaderRead
+        };
+
+        ResourceContext::EnqueueBufferUpdate(rayTracingComponent.primitiveBuffer, bufferUpdate);
+    }
+
+    static void DestroyTlas(RayTracingContextComponent& rayTracingComponent, TlasState& tlasState)
+    {
+        if (!rayTracingComponent.tlases.empty())
+        {
+            for (const vk::AccelerationStructureKHR tlas : rayTracingComponent.tlases)
             {
-                tlasInstances.push_back(SceneHelpers::GetTlasInstance(scene, tc, ro));
+                ResourceContext::DestroyResourceSafe(tlas);
             }
+
+            rayTracingComponent.tlases.clear();
+            rayTracingComponent.updated = true;
         }
 
+        tlasState.instances.clear();
+        tlasState.copyDirtyRanges.clear();
+        tlasState.copyRebuildRequired.clear();
+        tlasState.capacity = 0;
+    }
+
+    static void CreateTlas(RayTracingContextComponent& rayTracingComponent, TlasState& tlasState, uint32_t capacity)
+    {
+        const uint32_t imageCount = VulkanContext::swapchain->GetImageCount();
+
+        rayTracingComponent.tlases.resize(imageCount);
+
+        for (vk::AccelerationStructureKHR& tlas : rayTracingComponent.tlases)
+        {
+            tlas = ResourceContext::CreateTlas(capacity);
+        }
+
+        rayTracingComponent.updated = true;
+
+        tlasState.copyDirtyRanges.resize(imageCount);
+        tlasState.copyRebuildRequired.resize(imageCount, true);
+        tlasState.capacity = capacity;
+    }
+
+    // Updates instances and marks ranges of TLAS copies to update, returns false if the TLAS is destroyed
+    static bool UpdateTlasInstances(Scene& scene, const RenderSnapshot& snapshot, TlasState& tlasState)
+    {
         auto& rayTracingComponent = scene.ctx().get<RayTracingContextComponent>();
 
-        if (rayTracingComponent.tlasInstanceCount != static_cast<uint32_t>(tlasInstances.size()))
+        const uint32_t instanceCount = static_cast<uint32_t>(snapshot.drawObjects.size());
+
+        if (instanceCount == 0)
+        {
+            DestroyTlas(rayTracingComponent, tlasState);
+
+            return false;
+        }
+
+        // Capacity is doubled, so adding instances rarely causes reallocation
+        if (instanceCount > tlasState.capacity)
+        {
+            DestroyTlas(rayTracingComponent, tlasState);
+
+            CreateTlas(rayTracingComponent, tlasState, std::max(std::bit_ceil(instanceCount), kMinTlasCapacity));
+        }
+
+        const uint32_t previousInstanceCount = static_cast<uint32_t>(tlasState.instances.size());
+
+        tlasState.instances.resize(instanceCount);
+
+        DirtyRange dirtyRange;
+
+        Assert(snapshot.tlasInstances.size() == instanceCount);
+
+        for (uint32_t i = 0; i < instanceCount; ++i)
+        {
+            const vk::AccelerationStructureInstanceKHR& instance = snapshot.tlasInstances[i];
+
+            if (i >= previousInstanceCount
+                    || std::memcmp(&tlasState.instances[i], &instance, sizeof(instance)) != 0)
+            {
+                tlasState.instances[i] = instance;
+
+                dirtyRange.Add(i);
+            }
+        }
+
+        AABBox bounds;
+
+        for (uint32_t i = 0; i < snapshot.drawBounds.GetSize(); ++i)
+        {
+            bounds.Add(snapshot.drawBounds.Get(i));
+        }
+
+        const float surfaceArea = GetSurfaceArea(bounds);
+
+        // Refits keep the tree topology, so it degrades when instances move far from their build positions
+        const bool rebuild = instanceCount != previousInstanceCount
+                || snapshot.geometryUpdated
+                || tlasState.refitCount >= kMaxTlasRefitCount
+                || surfaceArea > tlasState.buildSurfaceArea * kMaxTlasBoundsGrowth;
+
+        if (rebuild)
+        {
+            tlasState.copyRebuildRequired.assign(tlasState.copyRebuildRequired.size(), true);
+
+            tlasState.refitCount = 0;
+            tlasState.buildSurfaceArea = surfaceArea;
+        }
+        else if (!dirtyRange.IsEmpty())
         {
-            if (rayTracingComponent.tlas)
+            for (DirtyRange& copyDirtyRange : tlasState.copyDirtyRanges)
             {
-                ResourceContext::DestroyResourceSafe(rayTracingComponent.tlas);
+                copyDirtyRange.Add(dirtyRange);
             }
 
-            if (!tlasInstances.empty())
+            ++tlasState.refitCount;
+        }
+
+        return true;
+    }
+
+    static void UpdateTlas(vk::CommandBuffer commandBuffer, Scene& scene,
+            const RenderSnapshot& snapshot, uint32_t imageIndex, TlasState& tlasState)
+    {
+        const uint32_t frameIndex = RenderContext::frameLoop->GetCurrentFrameIndex();
+        const uint32_t firstQuery = frameIndex * 2;
+
+        // Timestamps of this frame slot were written frame count frames ago and are available after frame fence
+        if (tlasState.timestampsWritten[frameIndex])
+        {
+            if (const std::optional<float> gpuSeconds = GetTimestampSeconds(tlasState.queryPool, firstQuery))
             {
-                const uint32_t instanceCount = static_cast<uint32_t>(tlasInstances.size());
-                rayTracingComponent.tlas = ResourceContext::CreateTlas(instanceCount);
-                rayTracingComponent.tlasInstanceCount = instanceCount;
-                rayTracingComponent.updated = true;
+                RenderContext::stats.tlasGpuSeconds = gpuSeconds.value();
             }
-            else
+
+            tlasState.timestampsWritten[frameIndex] = false;
+        }
+
+        EASY_FUNCTION()
+
+        Timer timer;
+        timer.Tick();
+
+        if (snapshot.drawObjectsUpdated || snapshot.geometryUpdated)
+        {
+            if (!UpdateTlasInstances(scene, snapshot, tlasState))
             {
-                rayTracingComponent.tlas = nullptr;
-                rayTracingComponent.tlasInstanceCount = 0;
-                rayTracingComponent.updated = true;
+                RenderContext::stats.tlasCpuSeconds = timer.Tick();
+
+                return;
             }
         }
 
-        if (!tlasInstances.empty())
+        const auto& rayTracingComponent = scene.ctx().get<RayTracingContextComponent>();
+
+        if (rayTracingComponent.tlases.empty())
         {
-            // One time command is used to fix gpu crash caused by wrong synchronization
-            VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
-                {
-                    // TODO move TLAS building to async compute queue
-                    ResourceContext::BuildTlas(commandBuffer, rayTracingComponent.tlas, tlasInstances);
-                });
+            RenderContext::stats.tlasCpuSeconds = 0.0f;
+
+            return;
         }
+
+        // Copy of the image is read only by the frame that rendered it last, which is complete after image acquire
+        const bool rebuild = tlasState.copyRebuildRequired[imageIndex];
+        const DirtyRange dirtyRange = rebuild
+                ? DirtyRange{ 0, static_cast<uint32_t>(tlasState.instances.size()) }
+                : tlasState.copyDirtyRanges[imageIndex];
+
+        if (dirtyRange.IsEmpty())
+        {
+            RenderContext::stats.tlasCpuSeconds = timer.Tick();
+
+            return;
+        }
+
+        const bool asyncCompute = VulkanContext::device->HasAsyncComputeQueue();
+
+        // Compute-only queue families can lack timestamp support
+        const bool gpuTiming = !asyncCompute || VulkanContext::device->HasComputeTimestamps();
+
+        const TlasBuildInfo buildInfo{
+            .instanceCount = static_cast<uint32_t>(tlasState.instances.size()),
+            .instances = DataView<vk::AccelerationStructureInstanceKHR>(
+                    tlasState.instances.data() + dirtyRange.offset, dirtyRange.count),
+            .instanceOffset = dirtyRange.offset,
+            .update = !rebuild,
+            .blockedScope = asyncCompute ? SyncScope::kBlockNone : SyncScope::kShaderAccelerationStructureRead
+        };
+
+        // Ray query consumers (LightingStage, PathTracingRenderer) wait for the build with a semaphore,
+        // the build overlaps with the previous frame, which reads another TLAS copy
+        RenderContext::frameLoop->ExecuteAsyncCompute(commandBuffer, [&](vk::CommandBuffer computeCommandBuffer)
+            {
+                if (gpuTiming)
+                {
+                    computeCommandBuffer.resetQueryPool(tlasState.queryPool, firstQuery, 2);
+
+                    computeCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe,
+                            tlasState.queryPool, firstQuery);
+                }
+
+                ResourceContext::BuildTlas(computeCommandBuffer, rayTracingComponent.tlases[imageIndex], buildInfo);
+
+                if (gpuTiming)
+                {
+                    computeCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe,
+                            tlasState.queryPool, firstQuery + 1);
+                }
+            }, VulkanHelpers::kShaderPipelineStages);
+
+        tlasState.timestampsWritten[frameIndex] = gpuTiming;
+
+        tlasState.copyRebuildRequired[imageIndex] = false;
+        tlasState.copyDirtyRanges[imageIndex] = DirtyRange{};
+
+        RenderContext::stats.tlasRefitCount = tlasState.refitCount;
+        RenderContext::stats.tlasCpuSeconds = timer.Tick();
     }
 }
 
@@ -248,10 +886,26 @@ SceneRenderer::SceneRenderer()
         pathTracingRenderer = std::make_unique<PathTracingRenderer>();
     }
 
+    occlusionCuller = std::make_unique<OcclusionCuller>();
+    renderList = std::make_unique<RenderList>();
+
     renderComponent = Details::CreateRenderContextComponent();
 
     rayTracingComponent = RayTracingContextComponent{};
 
+    if (Details::rayTracingAllowed)
+    {
+        rayTracingComponent.primitiveBuffer = ResourceContext::CreateBuffer({
+            .type = BufferType::eStorage,
+            .size = sizeof(gpu::Primitive) * MAX_PRIMITIVE_COUNT,
+            .usage = vk::BufferUsageFlagBits::eTransferDst,
+            .stagingBuffer = true
+        });
+    }
+
+    tlasState.queryPool = Details::CreateTimestampQueryPool();
+    tlasState.timestampsWritten.resize(RenderContext::frameLoop->GetFrameCount(), false);
+
     Engine::AddEventHandler<vk::Extent2D>(EventType::eResize,
             MakeFunction(this, &SceneRenderer::HandleResizeEvent));
 
@@ -263,11 +917,18 @@ SceneRenderer::~SceneRenderer()
 {
     RemoveScene();
 
-    if (rayTracingComponent.tlas)
+    for (const vk::AccelerationStructureKHR tlas : rayTracingComponent.tlases)
+    {
+        ResourceContext::DestroyResource(tlas);
+    }
+
+    if (rayTracingComponent.primitiveBuffer)
     {
-        ResourceContext::DestroyResource(rayTracingComponent.tlas);
+        ResourceContext::DestroyResource(rayTracingComponent.primitiveBuffer);
     }
 
+    VulkanContext::device->Get().destroyQueryPool(tlasState.queryPool);
+
     if (renderComponent.lightBuffer)
     {
         ResourceContext::DestroyResource(renderComponent.lightBuffer);
@@ -279,6 +940,16 @@ SceneRenderer::~SceneRenderer()
     {
         ResourceContext::DestroyResource(frameBuffer);
     }
+
+    for (const auto instanceBuffer : renderComponent.instanceBuffers)
+    {
+        ResourceContext::DestroyResource(instanceBuffer);
+    }
+
+    for (const auto drawCommandBuffer : renderComponent.drawCommandBuffers)
+    {
+        ResourceContext::DestroyResource(drawCommandBuffer);
+    }
 }
 
 void SceneRenderer::RegisterScene(Scene* scene_)
@@ -290,6 +961,12 @@ void SceneRenderer::RegisterScene(Scene* scene_)
     scene = scene_;
     Assert(scene);
 
+    scene->ConsumeChanges();
+
+    fullUpdateRequired = true;
+
+    tlasState.instances.clear();
+
     if (!scene->ctx().contains<CameraComponent&>())
     {
         Details::EmplaceDefaultCamera(*scene);
@@ -336,50 +1013,106 @@ void SceneRenderer::RemoveScene()
     scene = nullptr;
 }
 
-void SceneRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
+void SceneRenderer::ExtractSnapshot(RenderSnapshot& snapshot)
+{
+    EASY_FUNCTION()
+
+    snapshot.globalSeconds = Timer::GetGlobalSeconds();
+    snapshot.extractStats = ExtractStats();
+
+    if (scene)
+    {
+        snapshot.camera = scene->ctx().get<CameraComponent>();
+        snapshot.geometryBuffers = GeometryArena::GetBuffers();
+
+        const SceneChanges changes = scene->ConsumeChanges();
+
+        const bool fullUpdate = std::exchange(fullUpdateRequired, false);
+
+        snapshotArena.Reset();
+
+        Details::ExtractDrawObjects(*scene, snapshot);
+        Details::CullDrawObjects(*scene, snapshot, *occlusionCuller, snapshotArena);
+        Details::SortDrawObjects(*scene, changes, fullUpdate, snapshot, *renderList);
+        Details::ExtractLights(*scene, changes, fullUpdate, lights, lightIndices, snapshot);
+        Details::ExtractMaterials(*scene, changes, fullUpdate, snapshot);
+
+        snapshot.drawObjectsUpdated = fullUpdate || changes.drawObjects;
+
+        auto& textureComponent = scene->ctx().get<TextureStorageComponent>();
+        auto& materialComponent = scene->ctx().get<MaterialStorageComponent>();
+        auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
+
+        snapshot.texturesUpdated = std::exchange(textureComponent.updated, false);
+        snapshot.materialsUpdated = std::exchange(materialComponent.updated, false);
+        snapshot.geometryUpdated = std::exchange(geometryComponent.updated, false) || fullUpdate;
+
+        Details::ExtractRayTracingData(*scene, snapshot);
+    }
+}
+
+void SceneRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot)
 {
     if (scene)
     {
-        Details::UpdateLightBuffer(commandBuffer, *scene);
+        const BufferUpdateStats previousUpdateStats = ResourceContext::GetBufferUpdateStats();
 
-        Details::UpdateFrameBuffer(commandBuffer, *scene, imageIndex);
+        Details::UpdateLightBuffer(*scene, snapshot);
 
-        if (scene->ctx().get<MaterialStorageComponent>().updated)
+        Details::UpdateFrameBuffer(*scene, snapshot, imageIndex);
+
+        Details::UpdateMaterialBuffer(*scene, snapshot);
+
+        Details::UpdateDrawBuffers(*scene, snapshot, imageIndex);
+
+        if (scene->ctx().contains<RayTracingContextComponent>())
         {
-            Details::UpdateMaterialBuffer(commandBuffer, *scene);
+            Details::UpdatePrimitiveBuffer(*scene, snapshot);
         }
 
+        ResourceContext::FlushBufferUpdates(commandBuffer);
+
         if (scene->ctx().contains<RayTracingContextComponent>())
         {
-            Details::UpdateTlas(commandBuffer, *scene);
+            Details::UpdateTlas(commandBuffer, *scene, snapshot, imageIndex, tlasState);
         }
 
-        hybridRenderer->Update();
+        const BufferUpdateStats updateStats = ResourceContext::GetBufferUpdateStats();
+
+        RenderContext::stats.uploadedBytes = updateStats.uploadedBytes - previousUpdateStats.uploadedBytes;
+        RenderContext::stats.bufferCopyRegionCount = updateStats.copyRegionCount - previousUpdateStats.copyRegionCount;
+        RenderContext::stats.bufferBarrierCount = updateStats.barrierCount - previousUpdateStats.barrierCount;
+
+        hybridRenderer->Update(snapshot);
 
         if (pathTracingRenderer)
         {
-            pathTracingRenderer->Update();
+            pathTracingRenderer->Update(snapshot);
         }
 
-        scene->ctx().get<TextureStorageComponent>().updated = false;
-        scene->ctx().get<MaterialStorageComponent>().updated = false;
-        scene->ctx().get<GeometryStorageComponent>().updated = false;
-
         rayTracingComponent.updated = false;
+        renderComponent.drawBuffersUpdated = false;
     }
 
+    RenderContext::stats.drawCallCount = 0;
+    RenderContext::stats.drawRecordSeconds = 0.0f;
+    RenderContext::stats.recordingThreadCount = RenderContext::commandRecorder->GetActiveThreadCount();
+    RenderContext::stats.secondaryCommandBufferCount = 0;
+
     if (pathTracingRenderer && renderMode == RenderMode::ePathTracing)
     {
-        pathTracingRenderer->Render(commandBuffer, imageIndex);
+        pathTracingRenderer->Render(commandBuffer, imageIndex, snapshot);
     }
     else
     {
-        hybridRenderer->Render(commandBuffer, imageIndex);
+        hybridRenderer->Render(commandBuffer, imageIndex, snapshot);
     }
 }
 
 void SceneRenderer::HandleResizeEvent(const vk::Extent2D& extent) const
 {
+    RenderContext::renderThread->Flush();
+
     VulkanContext::device->WaitIdle();
 
     if (extent.width != 0 && extent.height != 0)
@@ -410,6 +1143,8 @@ void SceneRenderer::HandleKeyInputEvent(const KeyInput& keyInput)
 
 void SceneRenderer::ToggleRenderMode()
 {
+    RenderContext::renderThread->Flush();
+
     uint32_t i = static_cast<const uint32_t>(renderMode);
 
     i = (i + 1) % kRenderModeCount;
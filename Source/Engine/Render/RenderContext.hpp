@@ -1,8 +1,11 @@
 #pragma once
 
 class FrameLoop;
+class CommandRecorder;
+class RenderThread;
 class ImageBasedLighting;
 class GlobalIllumination;
+struct RecordStats;
 
 class RenderContext
 {
@@ -12,6 +15,13 @@ public:
 
     static std::unique_ptr<FrameLoop> frameLoop;
 
+    static std::unique_ptr<CommandRecorder> commandRecorder;
+
+    static std::unique_ptr<RenderThread> renderThread;
+
     static std::unique_ptr<ImageBasedLighting> imageBasedLighting;
     static std::unique_ptr<GlobalIllumination> globalIllumination;
+
+    // Written only by the render thread and its recording workers, published by RenderThread
+    static RecordStats stats;
 };
@@ -3,10 +3,15 @@
 #include "Engine/Scene/Material.hpp"
 #include "Engine/Scene/Scene.hpp"
 
+#include "Utils/LinearArena.hpp"
+
+class Primitive;
 class RenderPass;
 class GraphicsPipeline;
 class DescriptorProvider;
 class MaterialPipelineCache;
+struct RenderContextComponent;
+struct DrawBucket;
 
 using MaterialPipelinePred = std::function<bool(MaterialFlags)>;
 
@@ -19,7 +24,22 @@ namespace RenderHelpers
     void PushEnvironmentDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider);
     void PushLightVolumeDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider);
     void PushRayTracingDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider);
+    // TLAS copies are pushed as slice data, so the "tlas" binding has to be in a per-frame descriptor set
+    void PushTlasDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider);
+    void PushDrawDescriptorData(const Scene& scene, DescriptorProvider& descriptorProvider);
+
+    // Free slots are substituted with an alive primitive, descriptor arrays can't contain null buffers
+    void EnumeratePrimitiveSlots(const Scene& scene, const std::function<void(const Primitive&)>& func);
 
     std::set<MaterialFlags> CacheMaterialPipelines(const Scene& scene,
             MaterialPipelineCache& cache, const MaterialPipelinePred& pred);
+
+    // Records one indirect draw for the bucket, or a draw per command when r.IndirectDraws is disabled
+    void DrawObjects(vk::CommandBuffer commandBuffer, const RenderContextComponent& renderComponent,
+            uint32_t imageIndex, const DrawBucket& drawBucket);
+
+    // Splits buckets of the pipelines into chunks recorded to separate secondary command buffers,
+    // each thread gets several chunks to balance recording. Chunks are allocated from the frame arena
+    ArenaVector<DrawBucket> SplitDrawBuckets(const std::vector<DrawBucket>& drawBuckets,
+            const std::set<MaterialFlags>& pipelines, uint32_t threadCount);
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Engine/Scene/Material.hpp"
+
+class Scene;
+struct RenderSnapshot;
+
+// Range of visible objects drawn with the same material pipeline
+struct DrawBucket
+{
+    MaterialFlags pipeline;
+    uint32_t offset = 0;
+    uint32_t count = 0;
+};
+
+struct RenderListStats
+{
+    uint32_t sortKeyCount = 0;
+    uint32_t uniqueSortKeyCount = 0;
+    uint32_t rebuildCount = 0;
+    float rebuildSeconds = 0.0f;
+    // Changes between consecutive visible objects in draw order
+    uint32_t pipelineChangeCount = 0;
+    uint32_t materialChangeCount = 0;
+    uint32_t primitiveChangeCount = 0;
+};
+
+// Keeps draw objects sorted by pipeline, material and primitive. The order is rebuilt only when
+// render objects or materials change, per frame visible objects are picked from it in one pass
+class RenderList
+{
+public:
+    void Invalidate();
+
+    // Reorders visible objects of the snapshot and splits them into pipeline buckets
+    void Apply(const Scene& scene, RenderSnapshot& snapshot);
+
+    const RenderListStats& GetStats() const { return stats; }
+
+private:
+    struct SortKey
+    {
+        MaterialFlags pipeline;
+        uint32_t material = 0;
+        uint32_t primitive = 0;
+        uint32_t drawObject = 0;
+
+        auto operator<=>(const SortKey&) const = default;
+    };
+
+    std::vector<SortKey> sortKeys;
+    std::vector<uint8_t> visibility;
+
+    bool valid = false;
+
+    RenderListStats stats;
+
+    void Rebuild(const Scene& scene, const RenderSnapshot& snapshot);
+};
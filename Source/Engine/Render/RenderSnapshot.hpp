@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Engine/Scene/Components/CameraComponent.hpp"
+#include "Engine/Scene/Components/Components.hpp"
+#include "Engine/Render/Culling.hpp"
+#include "Engine/Render/RenderList.hpp"
+#include "Engine/Render/RenderStats.hpp"
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
+
+// Elements changed since the previous snapshot, only they are uploaded to GPU buffers
+struct DirtyRange
+{
+    uint32_t offset = 0;
+    uint32_t count = 0;
+
+    bool IsEmpty() const { return count == 0; }
+
+    void Add(uint32_t index)
+    {
+        if (IsEmpty())
+        {
+            offset = index;
+            count = 1;
+        }
+        else
+        {
+            const uint32_t end = std::max(offset + count, index + 1);
+
+            offset = std::min(offset, index);
+            count = end - offset;
+        }
+    }
+
+    void Add(const DirtyRange& range)
+    {
+        if (!range.IsEmpty())
+        {
+            Add(range.offset);
+            Add(range.offset + range.count - 1);
+        }
+    }
+};
+
+struct RenderSnapshot
+{
+    struct DrawObject
+    {
+        glm::mat4 transform;
+        RenderObject renderObject;
+        GeometryRange geometryRange;
+    };
+
+    uint64_t frameIndex = 0;
+    float globalSeconds = 0.0f;
+
+    CameraComponent camera;
+
+    std::vector<DrawObject> drawObjects;
+    CullingBounds drawBounds;
+
+    // Copied from scene storages, so the render thread doesn't read them while the main thread runs systems.
+    // Primitive ranges are extracted only when geometry is updated, TLAS instances also when draw objects are
+    std::vector<GeometryRange> primitiveRanges;
+    std::vector<vk::AccelerationStructureInstanceKHR> tlasInstances;
+
+    // Geometry buffers at the time of extraction, recording binds them without locking the arena
+    GeometryBuffers geometryBuffers;
+
+    // Indices of draw objects that passed culling, rasterization stages draw only these.
+    // Sorted by RenderList, so objects of each pipeline bucket are contiguous
+    std::vector<uint32_t> visibleObjects;
+    std::vector<DrawBucket> drawBuckets;
+
+    std::vector<gpu::Light> lights;
+    DirtyRange lightsRange;
+
+    // Contains only materials from materialsRange
+    std::vector<gpu::Material> materials;
+    DirtyRange materialsRange;
+
+    ExtractStats extractStats;
+
+    bool drawObjectsUpdated = false;
+    bool texturesUpdated = false;
+    bool materialsUpdated = false;
+    bool geometryUpdated = false;
+};
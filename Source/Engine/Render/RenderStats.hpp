@@ -0,0 +1,52 @@
+#pragma once
+
+// Gathered by the main thread while the snapshot is extracted and passed to the render thread with it
+struct ExtractStats
+{
+    uint32_t drawObjectCount = 0;
+    uint32_t frustumCulledCount = 0;
+    uint32_t occludedCount = 0;
+    uint32_t submittedCount = 0;
+    // Estimated from vertex count of submitted objects and vertex size of the current layout
+    uint64_t vertexFetchBytes = 0;
+    float cullingSeconds = 0.0f;
+    float occlusionSeconds = 0.0f;
+    // Draw order of the render list, rebuilt when render objects or materials change
+    uint32_t sortKeyCount = 0;
+    uint32_t uniqueSortKeyCount = 0;
+    uint32_t renderListRebuildCount = 0;
+    float renderListRebuildSeconds = 0.0f;
+    uint32_t pipelineChangeCount = 0;
+    uint32_t materialChangeCount = 0;
+    uint32_t primitiveChangeCount = 0;
+};
+
+// Gathered by the render thread while the snapshot is recorded and submitted
+struct RecordStats
+{
+    // Accumulated by stages while recording draws of submitted objects, recording workers add to it atomically
+    uint32_t drawCallCount = 0;
+    float drawRecordSeconds = 0.0f;
+    uint32_t recordingThreadCount = 0;
+    uint32_t secondaryCommandBufferCount = 0;
+    uint64_t uploadedBytes = 0;
+    uint32_t bufferCopyRegionCount = 0;
+    uint32_t bufferBarrierCount = 0;
+    uint32_t tlasRefitCount = 0;
+    float tlasCpuSeconds = 0.0f;
+    float tlasGpuSeconds = 0.0f;
+    // Heap allocations between consecutive frames, steady state target is zero
+    uint32_t frameAllocationCount = 0;
+    uint32_t renderThreadAllocationCount = 0;
+    uint64_t frameArenaUsedBytes = 0;
+};
+
+// Stats of one completed frame, published by the render thread and displayed by StatWidget
+struct RenderStats
+{
+    float renderSeconds = 0.0f;
+    float latencySeconds = 0.0f;
+
+    ExtractStats extract;
+    RecordStats record;
+};
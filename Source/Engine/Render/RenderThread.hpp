@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Engine/Render/RenderSnapshot.hpp"
+#include "Engine/Render/RenderStats.hpp"
+
+#include <atomic>
+#include <semaphore>
+#include <thread>
+
+using SnapshotRenderFunc = std::function<void(const RenderSnapshot&)>;
+
+// Records and submits frame N from its snapshot while the main thread simulates frame N + 1.
+// Main thread code that mutates scene storages or render resources has to call Flush() first.
+class RenderThread
+{
+public:
+    static constexpr uint32_t kSnapshotCount = 2;
+
+    RenderThread();
+
+    ~RenderThread();
+
+    bool IsEnabled() const { return enabled; }
+
+    void Start(const SnapshotRenderFunc& renderFunc_);
+
+    void Stop();
+
+    RenderSnapshot& AcquireSnapshot();
+
+    void SubmitSnapshot();
+
+    void Flush();
+
+    // Stats of the frame whose snapshot slot was acquired last, main thread only
+    const RenderStats& GetStats() const { return stats; }
+
+private:
+    bool enabled = false;
+
+    SnapshotRenderFunc renderFunc;
+
+    std::array<RenderSnapshot, kSnapshotCount> snapshots;
+
+    // Written by the render thread after the slot is rendered, copied when the slot is acquired again
+    std::array<RenderStats, kSnapshotCount> snapshotStats;
+    RenderStats stats;
+
+    std::counting_semaphore<kSnapshotCount> freeSnapshots{ kSnapshotCount };
+    std::counting_semaphore<kSnapshotCount> readySnapshots{ 0 };
+
+    uint64_t submittedCount = 0;
+
+    std::atomic<bool> stopRequested = false;
+
+    std::thread thread;
+
+    void Run();
+
+    void Render(const RenderSnapshot& snapshot);
+};
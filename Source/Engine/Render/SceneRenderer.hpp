@@ -1,10 +1,17 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "Engine/Scene/Components/Components.hpp"
+#include "Engine/Render/RenderSnapshot.hpp"
+
+#include "Utils/LinearArena.hpp"
 
 class Scene;
 class HybridRenderer;
 class PathTracingRenderer;
+class OcclusionCuller;
+class RenderList;
 struct KeyInput;
 
 enum class RenderMode
@@ -13,6 +20,20 @@ enum class RenderMode
     ePathTracing
 };
 
+// Render thread state of incremental TLAS updates
+struct TlasState
+{
+    std::vector<vk::AccelerationStructureInstanceKHR> instances;
+    // Each TLAS copy is built when its image is rendered, so it catches up with changes made since its last build
+    std::vector<DirtyRange> copyDirtyRanges;
+    std::vector<bool> copyRebuildRequired;
+    uint32_t capacity = 0;
+    uint32_t refitCount = 0;
+    float buildSurfaceArea = 0.0f;
+    vk::QueryPool queryPool;
+    std::vector<bool> timestampsWritten;
+};
+
 class SceneRenderer
 {
 public:
@@ -24,19 +45,36 @@ public:
 
     void RemoveScene();
 
-    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex);
+    void ExtractSnapshot(RenderSnapshot& snapshot);
+
+    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot);
 
 private:
+    static constexpr size_t kSnapshotArenaBlockSize = 256 * 1024;
+
     Scene* scene = nullptr;
 
     RenderMode renderMode = RenderMode::eHybrid;
 
     RenderContextComponent renderComponent;
     RayTracingContextComponent rayTracingComponent;
+    TlasState tlasState;
 
     std::unique_ptr<HybridRenderer> hybridRenderer;
     std::unique_ptr<PathTracingRenderer> pathTracingRenderer;
 
+    std::unique_ptr<OcclusionCuller> occlusionCuller;
+    std::unique_ptr<RenderList> renderList;
+
+    // Transient main thread memory of snapshot extraction, reset for each snapshot
+    LinearArena snapshotArena{ kSnapshotArenaBlockSize };
+
+    // Main thread copy of light buffer content, only changed lights are updated in it
+    std::vector<gpu::Light> lights;
+    std::unordered_map<entt::entity, uint32_t> lightIndices;
+
+    bool fullUpdateRequired = true;
+
     void HandleResizeEvent(const vk::Extent2D& extent) const;
 
     void HandleKeyInputEvent(const KeyInput& keyInput);
@@ -2,11 +2,15 @@
 
 #include "Engine/Render/RenderHelpers.hpp"
 #include "Engine/Render/Vulkan/Pipelines/MaterialPipelineCache.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineBase.hpp"
 #include "Engine/Render/Vulkan/Resources/DescriptorProvider.hpp"
 #include "Engine/Render/Vulkan/Resources/ImageHelpers.hpp"
 
+#include <span>
+
 class Scene;
 class RenderPass;
+struct RenderSnapshot;
 class GraphicsPipeline;
 
 class ForwardStage
@@ -20,9 +24,9 @@ public:
 
     void RemoveScene();
 
-    void Update();
+    void Update(const RenderSnapshot& snapshot);
 
-    void Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const;
 
     void Resize(const RenderTarget& depthTarget);
 
@@ -43,11 +47,16 @@ private:
 
     std::unique_ptr<MaterialPipelineCache> materialPipelineCache;
     std::set<MaterialFlags> uniqueMaterialPipelines;
+    // Material pipelines share the push constant layout, so the handle is resolved from any of them
+    PushConstantHandle lightCountHandle;
 
     EnvironmentData environmentData;
     std::unique_ptr<GraphicsPipeline> environmentPipeline;
     std::unique_ptr<DescriptorProvider> environmentDescriptorProvider;
 
-    void DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void CacheMaterialPipelines();
+
+    void DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex,
+            const RenderSnapshot& snapshot, std::span<const DrawBucket> drawBuckets) const;
     void DrawEnvironment(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
 };
@@ -3,8 +3,11 @@
 #include "Engine/Render/RenderHelpers.hpp"
 #include "Engine/Render/Vulkan/Resources/ImageHelpers.hpp"
 
+#include <span>
+
 class Scene;
 class RenderPass;
+struct RenderSnapshot;
 class DescriptorProvider;
 class MaterialPipelineCache;
 
@@ -37,9 +40,9 @@ public:
 
     void RemoveScene();
 
-    void Update();
+    void Update(const RenderSnapshot& snapshot);
 
-    void Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const;
 
     void Resize();
 
@@ -56,5 +59,6 @@ private:
     std::unique_ptr<MaterialPipelineCache> pipelineCache;
     std::set<MaterialFlags> uniquePipelines;
 
-    void DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex,
+            const RenderSnapshot& snapshot, std::span<const DrawBucket> drawBuckets) const;
 };
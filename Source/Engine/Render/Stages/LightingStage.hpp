@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Engine/Render/RenderHelpers.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineBase.hpp"
 #include "Engine/Render/Vulkan/Resources/DescriptorProvider.hpp"
 #include "Engine/Render/Vulkan/Resources/ImageHelpers.hpp"
 
 class Scene;
 class ComputePipeline;
+struct RenderSnapshot;
 
 class LightingStage
 {
@@ -18,9 +20,9 @@ public:
 
     void RemoveScene();
 
-    void Update() const;
+    void Update(const RenderSnapshot& snapshot) const;
 
-    void Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const;
 
     void Resize(const std::vector<RenderTarget>& gBufferTargets_);
 
@@ -32,6 +34,7 @@ private:
     std::vector<RenderTarget> gBufferTargets;
 
     std::unique_ptr<ComputePipeline> pipeline;
+    PushConstantHandle lightCountHandle;
 
     std::unique_ptr<DescriptorProvider> descriptorProvider;
 };
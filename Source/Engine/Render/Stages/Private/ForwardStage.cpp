@@ -2,6 +2,10 @@
 
 #include "Engine/ConsoleVariable.hpp"
 #include "Engine/Engine.hpp"
+#include "Engine/Render/CommandRecorder.hpp"
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderSnapshot.hpp"
+#include "Engine/Render/RenderStats.hpp"
 #include "Engine/Render/Stages/GBufferStage.hpp"
 #include "Engine/Render/Vulkan/RenderPass.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
@@ -10,6 +14,8 @@
 #include "Engine/Scene/Components/Components.hpp"
 #include "Engine/Scene/Components/EnvironmentComponent.hpp"
 
+#include "Utils/TimeHelpers.hpp"
+
 namespace Details
 {
     static const std::vector<uint16_t> kEnvironmentIndices{
@@ -116,7 +122,7 @@ namespace Details
 
         descriptorProvider.PushGlobalData("lights", renderComponent.lightBuffer);
         descriptorProvider.PushGlobalData("materials", renderComponent.materialBuffer);
-        descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures);
+        descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
 
         RenderHelpers::PushEnvironmentDescriptorData(scene, descriptorProvider);
         RenderHelpers::PushLightVolumeDescriptorData(scene, descriptorProvider);
@@ -131,6 +137,8 @@ namespace Details
             descriptorProvider.PushSliceData("frame", frameBuffer);
         }
 
+        RenderHelpers::PushDrawDescriptorData(scene, descriptorProvider);
+
         descriptorProvider.FlushData();
     }
 
@@ -187,7 +195,7 @@ namespace Details
         descriptorProvider.FlushData();
     }
 
-    static std::vector<vk::ClearValue> GetClearValues()
+    static std::array<vk::ClearValue, 2> GetClearValues()
     {
         return { VulkanHelpers::kDefaultClearColorValue, VulkanHelpers::GetDefaultClearDepthStencilValue() };
     }
@@ -224,8 +232,7 @@ void ForwardStage::RegisterScene(const Scene* scene_)
     scene = scene_;
     Assert(scene);
 
-    uniqueMaterialPipelines = RenderHelpers::CacheMaterialPipelines(
-            *scene, *materialPipelineCache, &Details::ShouldRenderMaterial);
+    CacheMaterialPipelines();
 
     if (!uniqueMaterialPipelines.empty())
     {
@@ -247,56 +254,106 @@ void ForwardStage::RemoveScene()
     scene = nullptr;
 }
 
-void ForwardStage::Update()
+void ForwardStage::Update(const RenderSnapshot& snapshot)
 {
     Assert(scene);
 
-    if (scene->ctx().get<MaterialStorageComponent>().updated)
+    if (snapshot.materialsUpdated)
     {
-        uniqueMaterialPipelines = RenderHelpers::CacheMaterialPipelines(
-                *scene, *materialPipelineCache, &Details::ShouldRenderMaterial);
+        CacheMaterialPipelines();
     }
 
     if (!uniqueMaterialPipelines.empty())
     {
+        const auto& renderComponent = scene->ctx().get<RenderContextComponent>();
         const auto& textureComponent = scene->ctx().get<TextureStorageComponent>();
-        const auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
 
         DescriptorProvider& descriptorProvider = materialPipelineCache->GetDescriptorProvider();
 
         if (const auto* rayTracingComponent = scene->ctx().find<RayTracingContextComponent>())
         {
-            if (geometryComponent.updated || rayTracingComponent->updated)
+            if (snapshot.geometryUpdated || rayTracingComponent->updated)
             {
                 RenderHelpers::PushRayTracingDescriptorData(*scene, descriptorProvider);
             }
         }
 
-        if (textureComponent.updated)
+        if (snapshot.texturesUpdated)
         {
-            descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures);
+            descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
+        }
+
+        if (renderComponent.drawBuffersUpdated)
+        {
+            RenderHelpers::PushDrawDescriptorData(*scene, descriptorProvider);
         }
 
         descriptorProvider.FlushData();
     }
 }
 
-void ForwardStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void ForwardStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const
 {
     const vk::Rect2D renderArea = RenderHelpers::GetSwapchainRenderArea();
-    const std::vector<vk::ClearValue> clearValues = Details::GetClearValues();
+    const auto clearValues = Details::GetClearValues();
 
     const vk::RenderPassBeginInfo beginInfo(
             renderPass->Get(), framebuffers[imageIndex],
             renderArea, clearValues);
 
-    commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+    Timer timer;
+    timer.Tick();
+
+    const uint32_t threadCount = RenderContext::commandRecorder->GetActiveThreadCount();
+
+    if (threadCount > 1)
+    {
+        const ArenaVector<DrawBucket> drawChunks
+                = RenderHelpers::SplitDrawBuckets(snapshot.drawBuckets, uniqueMaterialPipelines, threadCount);
+
+        const vk::CommandBufferInheritanceInfo inheritanceInfo(renderPass->Get(), 0, framebuffers[imageIndex]);
 
-    DrawEnvironment(commandBuffer, imageIndex);
+        // Environment is recorded by the first task, secondary command buffers are executed in task order
+        const std::vector<vk::CommandBuffer>& secondaryCommandBuffers = RenderContext::commandRecorder->Record(
+                inheritanceInfo, threadCount, static_cast<uint32_t>(drawChunks.size()) + 1,
+                [&](vk::CommandBuffer secondaryCommandBuffer, uint32_t taskIndex)
+                    {
+                        if (taskIndex == 0)
+                        {
+                            DrawEnvironment(secondaryCommandBuffer, imageIndex);
+                        }
+                        else
+                        {
+                            const vk::Viewport viewport = RenderHelpers::GetSwapchainViewport();
 
-    DrawScene(commandBuffer, imageIndex);
+                            secondaryCommandBuffer.setViewport(0, { viewport });
+                            secondaryCommandBuffer.setScissor(0, { renderArea });
+
+                            DrawScene(secondaryCommandBuffer, imageIndex, snapshot,
+                                    std::span(drawChunks).subspan(taskIndex - 1, 1));
+                        }
+                    });
+
+        commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+
+        commandBuffer.executeCommands(secondaryCommandBuffers);
+
+        commandBuffer.endRenderPass();
+
+        RenderContext::stats.secondaryCommandBufferCount += static_cast<uint32_t>(secondaryCommandBuffers.size());
+    }
+    else
+    {
+        commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+
+        DrawEnvironment(commandBuffer, imageIndex);
+
+        DrawScene(commandBuffer, imageIndex, snapshot, snapshot.drawBuckets);
+
+        commandBuffer.endRenderPass();
+    }
 
-    commandBuffer.endRenderPass();
+    RenderContext::stats.drawRecordSeconds += timer.Tick();
 }
 
 void ForwardStage::Resize(const RenderTarget& depthTarget)
@@ -313,8 +370,7 @@ void ForwardStage::Resize(const RenderTarget& depthTarget)
 
     if (scene)
     {
-        uniqueMaterialPipelines = RenderHelpers::CacheMaterialPipelines(
-                *scene, *materialPipelineCache, &Details::ShouldRenderMaterial);
+        CacheMaterialPipelines();
 
         if (!uniqueMaterialPipelines.empty())
         {
@@ -334,6 +390,8 @@ void ForwardStage::ReloadShaders()
 
     materialPipelineCache->ReloadPipelines();
 
+    CacheMaterialPipelines();
+
     environmentPipeline = Details::CreateEnvironmentPipeline(*renderPass);
     environmentDescriptorProvider = environmentPipeline->CreateDescriptorProvider();
 
@@ -350,18 +408,38 @@ ForwardStage::EnvironmentData ForwardStage::CreateEnvironmentData()
     return EnvironmentData{ indexBuffer };
 }
 
-void ForwardStage::DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void ForwardStage::CacheMaterialPipelines()
+{
+    uniqueMaterialPipelines = RenderHelpers::CacheMaterialPipelines(
+            *scene, *materialPipelineCache, &Details::ShouldRenderMaterial);
+
+    if (!uniqueMaterialPipelines.empty())
+    {
+        const GraphicsPipeline& pipeline = materialPipelineCache->GetPipeline(*uniqueMaterialPipelines.begin());
+
+        lightCountHandle = pipeline.GetPushConstantHandle("lightCount");
+    }
+}
+
+void ForwardStage::DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex,
+        const RenderSnapshot& snapshot, std::span<const DrawBucket> drawBuckets) const
 {
     Assert(scene);
 
-    const auto sceneRenderView = scene->view<TransformComponent, RenderComponent>();
+    const auto& renderComponent = scene->ctx().get<RenderContextComponent>();
 
-    const auto& materialComponent = scene->ctx().get<MaterialStorageComponent>();
-    const auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
+    const uint32_t lightCount = static_cast<uint32_t>(snapshot.lights.size());
 
-    for (const auto& materialFlags : uniqueMaterialPipelines)
+    GeometryArena::Bind(commandBuffer, snapshot.geometryBuffers);
+
+    for (const DrawBucket& drawBucket : drawBuckets)
     {
-        const GraphicsPipeline& pipeline = materialPipelineCache->GetPipeline(materialFlags);
+        if (!uniqueMaterialPipelines.contains(drawBucket.pipeline))
+        {
+            continue;
+        }
+
+        const GraphicsPipeline& pipeline = materialPipelineCache->GetPipeline(drawBucket.pipeline);
 
         const DescriptorProvider& descriptorProvider = materialPipelineCache->GetDescriptorProvider();
 
@@ -369,22 +447,9 @@ void ForwardStage::DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageInde
 
         pipeline.BindDescriptorSets(commandBuffer, descriptorProvider.GetDescriptorSlice(imageIndex));
 
-        for (auto&& [entity, tc, rc] : sceneRenderView.each())
-        {
-            for (const auto& ro : rc.renderObjects)
-            {
-                if (materialComponent.materials[ro.material].flags == materialFlags)
-                {
-                    pipeline.PushConstant(commandBuffer, "transform", tc.GetWorldTransform().GetMatrix());
-
-                    pipeline.PushConstant(commandBuffer, "materialIndex", ro.material);
-
-                    const Primitive& primitive = geometryComponent.primitives[ro.primitive];
+        pipeline.PushConstant(commandBuffer, lightCountHandle, lightCount);
 
-                    primitive.Draw(commandBuffer);
-                }
-            }
-        }
+        RenderHelpers::DrawObjects(commandBuffer, renderComponent, imageIndex, drawBucket);
     }
 }
 
@@ -2,6 +2,10 @@
 
 #include "Engine/ConsoleVariable.hpp"
 #include "Engine/Engine.hpp"
+#include "Engine/Render/CommandRecorder.hpp"
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderSnapshot.hpp"
+#include "Engine/Render/RenderStats.hpp"
 #include "Engine/Render/Vulkan/Pipelines/GraphicsPipeline.hpp"
 #include "Engine/Render/Vulkan/RenderPass.hpp"
 #include "Engine/Render/Vulkan/VulkanHelpers.hpp"
@@ -12,6 +16,8 @@
 #include "Engine/Scene/Primitive.hpp"
 #include "Engine/Scene/Scene.hpp"
 
+#include "Utils/TimeHelpers.hpp"
+
 namespace Details
 {
     static std::unique_ptr<RenderPass> CreateRenderPass()
@@ -168,19 +174,21 @@ namespace Details
         const auto& textureComponent = scene.ctx().get<TextureStorageComponent>();
 
         descriptorProvider.PushGlobalData("materials", renderComponent.materialBuffer);
-        descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures);
+        descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
 
         for (const auto& frameBuffer : renderComponent.frameBuffers)
         {
             descriptorProvider.PushSliceData("frame", frameBuffer);
         }
 
+        RenderHelpers::PushDrawDescriptorData(scene, descriptorProvider);
+
         descriptorProvider.FlushData();
     }
 
-    static std::vector<vk::ClearValue> GetClearValues()
+    static std::array<vk::ClearValue, GBufferStage::kAttachmentCount> GetClearValues()
     {
-        std::vector<vk::ClearValue> clearValues(GBufferStage::kAttachmentCount);
+        std::array<vk::ClearValue, GBufferStage::kAttachmentCount> clearValues;
 
         for (size_t i = 0; i < clearValues.size(); ++i)
         {
@@ -248,11 +256,11 @@ void GBufferStage::RemoveScene()
     scene = nullptr;
 }
 
-void GBufferStage::Update()
+void GBufferStage::Update(const RenderSnapshot& snapshot)
 {
     Assert(scene);
 
-    if (scene->ctx().get<MaterialStorageComponent>().updated)
+    if (snapshot.materialsUpdated)
     {
         uniquePipelines = RenderHelpers::CacheMaterialPipelines(
                 *scene, *pipelineCache, &Details::ShouldRenderMaterial);
@@ -260,37 +268,85 @@ void GBufferStage::Update()
 
     if (!uniquePipelines.empty())
     {
+        const auto& renderComponent = scene->ctx().get<RenderContextComponent>();
         const auto& textureComponent = scene->ctx().get<TextureStorageComponent>();
 
-        if (textureComponent.updated)
+        DescriptorProvider& descriptorProvider = pipelineCache->GetDescriptorProvider();
+
+        if (snapshot.texturesUpdated)
         {
-            DescriptorProvider& descriptorProvider = pipelineCache->GetDescriptorProvider();
+            descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
+        }
 
-            descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures);
+        if (renderComponent.drawBuffersUpdated)
+        {
+            RenderHelpers::PushDrawDescriptorData(*scene, descriptorProvider);
+        }
 
+        if (snapshot.texturesUpdated || renderComponent.drawBuffersUpdated)
+        {
             descriptorProvider.FlushData();
         }
     }
 }
 
-void GBufferStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void GBufferStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const
 {
     const vk::Rect2D renderArea = RenderHelpers::GetSwapchainRenderArea();
     const vk::Viewport viewport = RenderHelpers::GetSwapchainViewport();
-    const std::vector<vk::ClearValue> clearValues = Details::GetClearValues();
+    const auto clearValues = Details::GetClearValues();
 
     const vk::RenderPassBeginInfo beginInfo(
             renderPass->Get(), framebuffer,
             renderArea, clearValues);
 
-    commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+    Timer timer;
+    timer.Tick();
+
+    const uint32_t threadCount = RenderContext::commandRecorder->GetActiveThreadCount();
+
+    if (threadCount > 1)
+    {
+        const ArenaVector<DrawBucket> drawChunks
+                = RenderHelpers::SplitDrawBuckets(snapshot.drawBuckets, uniquePipelines, threadCount);
+
+        const vk::CommandBufferInheritanceInfo inheritanceInfo(renderPass->Get(), 0, framebuffer);
+
+        const std::vector<vk::CommandBuffer>& secondaryCommandBuffers = RenderContext::commandRecorder->Record(
+                inheritanceInfo, threadCount, static_cast<uint32_t>(drawChunks.size()),
+                [&](vk::CommandBuffer secondaryCommandBuffer, uint32_t chunkIndex)
+                    {
+                        secondaryCommandBuffer.setViewport(0, { viewport });
+                        secondaryCommandBuffer.setScissor(0, { renderArea });
+
+                        DrawScene(secondaryCommandBuffer, imageIndex, snapshot,
+                                std::span(drawChunks).subspan(chunkIndex, 1));
+                    });
+
+        commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+
+        if (!secondaryCommandBuffers.empty())
+        {
+            commandBuffer.executeCommands(secondaryCommandBuffers);
+        }
+
+        commandBuffer.endRenderPass();
 
-    commandBuffer.setViewport(0, { viewport });
-    commandBuffer.setScissor(0, { renderArea });
+        RenderContext::stats.secondaryCommandBufferCount += static_cast<uint32_t>(secondaryCommandBuffers.size());
+    }
+    else
+    {
+        commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+
+        commandBuffer.setViewport(0, { viewport });
+        commandBuffer.setScissor(0, { renderArea });
 
-    DrawScene(commandBuffer, imageIndex);
+        DrawScene(commandBuffer, imageIndex, snapshot, snapshot.drawBuckets);
+
+        commandBuffer.endRenderPass();
+    }
 
-    commandBuffer.endRenderPass();
+    RenderContext::stats.drawRecordSeconds += timer.Tick();
 }
 
 void GBufferStage::Resize()
@@ -312,16 +368,23 @@ void GBufferStage::ReloadShaders() const
     pipelineCache->ReloadPipelines();
 }
 
-void GBufferStage::DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void GBufferStage::DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageIndex,
+        const RenderSnapshot& snapshot, std::span<const DrawBucket> drawBuckets) const
 {
     Assert(scene);
 
-    const auto& materialComponent = scene->ctx().get<MaterialStorageComponent>();
-    const auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
+    const auto& renderComponent = scene->ctx().get<RenderContextComponent>();
 
-    for (const auto& materialFlags : uniquePipelines)
+    GeometryArena::Bind(commandBuffer, snapshot.geometryBuffers);
+
+    for (const DrawBucket& drawBucket : drawBuckets)
     {
-        const GraphicsPipeline& pipeline = pipelineCache->GetPipeline(materialFlags);
+        if (!uniquePipelines.contains(drawBucket.pipeline))
+        {
+            continue;
+        }
+
+        const GraphicsPipeline& pipeline = pipelineCache->GetPipeline(drawBucket.pipeline);
 
         const DescriptorProvider& descriptorProvider = pipelineCache->GetDescriptorProvider();
 
@@ -329,21 +392,6 @@ void GBufferStage::DrawScene(vk::CommandBuffer commandBuffer, uint32_t imageInde
 
         pipeline.BindDescriptorSets(commandBuffer, descriptorProvider.GetDescriptorSlice(imageIndex));
 
-        for (auto&& [entity, tc, rc] : scene->view<TransformComponent, RenderComponent>().each())
-        {
-            for (const auto& ro : rc.renderObjects)
-            {
-                if (materialComponent.materials[ro.material].flags == materialFlags)
-                {
-                    pipeline.PushConstant(commandBuffer, "transform", tc.GetWorldTransform().GetMatrix());
-
-                    pipeline.PushConstant(commandBuffer, "materialIndex", ro.material);
-
-                    const Primitive& primitive = geometryComponent.primitives[ro.primitive];
-
-                    primitive.Draw(commandBuffer);
-                }
-            }
-        }
+        RenderHelpers::DrawObjects(commandBuffer, renderComponent, imageIndex, drawBucket);
     }
 }
@@ -1,10 +1,12 @@
 #include "Engine/Render/Stages/LightingStage.hpp"
 
 #include "Engine/ConsoleVariable.hpp"
+#include "Engine/Render/RenderSnapshot.hpp"
 #include "Engine/Render/Stages/GBufferStage.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Pipelines/PipelineHelpers.hpp"
 #include "Engine/Render/Vulkan/Pipelines/ComputePipeline.hpp"
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
 #include "Engine/Render/Vulkan/Resources/ImageHelpers.hpp"
 #include "Engine/Scene/Components/Components.hpp"
 #include "Engine/Scene/Scene.hpp"
@@ -20,6 +22,7 @@ namespace Details
         const ShaderDefines shaderDefines{
             { "RAY_TRACING_ENABLED", rayTracingAllowedCVar.GetValue() },
             { "LIGHT_VOLUME_ENABLED", 0 },
+            { "VERTEX_LAYOUT", static_cast<uint32_t>(GeometryArena::GetVertexLayout()) },
         };
 
         const ShaderModule shaderModule = VulkanContext::shaderManager->CreateComputeShaderModule(
@@ -59,7 +62,7 @@ namespace Details
             RenderHelpers::PushRayTracingDescriptorData(scene, descriptorProvider);
 
             descriptorProvider.PushGlobalData("materials", renderComponent.materialBuffer);
-            descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures);
+            descriptorProvider.PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
         }
 
         for (uint32_t i = 0; i < VulkanContext::swapchain->GetImageCount(); ++i)
@@ -76,6 +79,7 @@ LightingStage::LightingStage(const std::vector<RenderTarget>& gBufferTargets_)
     : gBufferTargets(gBufferTargets_)
 {
     pipeline = Details::CreatePipeline();
+    lightCountHandle = pipeline->GetPushConstantHandle("lightCount");
 
     descriptorProvider = pipeline->CreateDescriptorProvider();
 }
@@ -107,35 +111,34 @@ void LightingStage::RemoveScene()
     scene = nullptr;
 }
 
-void LightingStage::Update() const
+void LightingStage::Update(const RenderSnapshot& snapshot) const
 {
     Assert(scene);
 
     if (const auto* rayTracingComponent = scene->ctx().find<RayTracingContextComponent>())
     {
         const auto& textureComponent = scene->ctx().get<TextureStorageComponent>();
-        const auto& geometryComponent = scene->ctx().get<GeometryStorageComponent>();
 
-        if (geometryComponent.updated || rayTracingComponent->updated)
+        if (snapshot.geometryUpdated || rayTracingComponent->updated)
         {
             RenderHelpers::PushRayTracingDescriptorData(*scene, *descriptorProvider);
         }
 
-        if (textureComponent.updated)
+        if (snapshot.texturesUpdated)
         {
-            descriptorProvider->PushGlobalData("materialTextures", &textureComponent.textures);
+            descriptorProvider->PushGlobalData("materialTextures", &textureComponent.textures.GetSlots());
         }
 
         descriptorProvider->FlushData();
     }
 }
 
-void LightingStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void LightingStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const
 {
     const vk::Image swapchainImage = VulkanContext::swapchain->GetImages()[imageIndex];
     const vk::Extent2D& extent = VulkanContext::swapchain->GetExtent();
 
-    const uint32_t lightCount = static_cast<uint32_t>(scene->view<LightComponent>().size());
+    const uint32_t lightCount = static_cast<uint32_t>(snapshot.lights.size());
 
     const ImageLayoutTransition layoutTransition{
         vk::ImageLayout::ePresentSrcKHR,
@@ -153,7 +156,7 @@ void LightingStage::Execute(vk::CommandBuffer commandBuffer, uint32_t imageIndex
 
     pipeline->BindDescriptorSets(commandBuffer, descriptorProvider->GetDescriptorSlice(imageIndex));
 
-    pipeline->PushConstant(commandBuffer, "lightCount", lightCount);
+    pipeline->PushConstant(commandBuffer, lightCountHandle, lightCount);
 
     const glm::uvec3 groupCount = PipelineHelpers::CalculateWorkGroupCount(extent, Details::kWorkGroupSize);
 
@@ -175,6 +178,7 @@ void LightingStage::ReloadShaders()
     Assert(scene);
 
     pipeline = Details::CreatePipeline();
+    lightCountHandle = pipeline->GetPushConstantHandle("lightCount");
 
     descriptorProvider = pipeline->CreateDescriptorProvider();
 
@@ -2,6 +2,8 @@
 
 #include "Engine/Render/Vulkan/VulkanHelpers.hpp"
 
+#include <mutex>
+
 struct DeviceFeatures;
 
 struct Queues
@@ -10,10 +12,12 @@ struct Queues
     {
         uint32_t graphicsFamilyIndex;
         uint32_t presentFamilyIndex;
+        std::optional<uint32_t> computeFamilyIndex;
     };
 
     vk::Queue graphics;
     vk::Queue present;
+    vk::Queue compute;
 };
 
 class Device
@@ -35,6 +39,8 @@ public:
 
     vk::PhysicalDevice GetPhysicalDevice() const { return physicalDevice; }
 
+    const vk::PhysicalDeviceProperties& GetProperties() const { return properties; }
+
     const vk::PhysicalDeviceLimits& GetLimits() const { return properties.limits; }
 
     const RayTracingProperties& GetRayTracingProperties() const { return rayTracingProperties; }
@@ -47,6 +53,12 @@ public:
 
     const Queues& GetQueues() const { return queues; }
 
+    // Compute queue from a family without graphics support, runs in parallel with frame rendering
+    bool HasAsyncComputeQueue() const { return queuesDescription.computeFamilyIndex.has_value(); }
+
+    // Timestamp queries are optional on compute-only queue families
+    bool HasComputeTimestamps() const { return computeTimestampValidBits > 0; }
+
     uint32_t GetMemoryTypeIndex(uint32_t typeBits, vk::MemoryPropertyFlags requiredProperties) const;
 
     vk::DeviceAddress GetAddress(vk::Buffer buffer) const;
@@ -55,8 +67,13 @@ public:
 
     void ExecuteOneTimeCommands(const DeviceCommands& commands) const; // TODO rename to Execute
 
+    // Invoked before one-time commands are submitted, so that work batched earlier reaches the queue first
+    void SetPendingWorkSubmitter(std::function<void()> submitter);
+
     vk::CommandBuffer AllocateCommandBuffer(CommandBufferType type) const;
 
+    std::unique_lock<std::recursive_mutex> LockQueues() const;
+
     void WaitIdle() const;
 
 private:
@@ -65,11 +82,15 @@ private:
     vk::PhysicalDeviceProperties properties;
 
     RayTracingProperties rayTracingProperties;
+    uint32_t computeTimestampValidBits = 0;
 
     Queues::Description queuesDescription;
     Queues queues;
 
+    mutable std::recursive_mutex queuesMutex;
+
     CommandBufferSync oneTimeCommandsSync;
+    std::function<void()> pendingWorkSubmitter;
     std::map<CommandBufferType, vk::CommandPool> commandPools;
 
     Device(vk::Device device_, vk::PhysicalDevice physicalDevice_, const Queues::Description& queuesDescription_);
@@ -4,6 +4,38 @@
 #include "Engine/Render/Vulkan/Shaders/ShaderHelpers.hpp"
 #include "Utils/Assert.hpp"
 
+#include <array>
+
+// Push constant member resolved from pipeline reflection once, so that per draw writes skip name lookup.
+// Valid for any pipeline with the same push constant layout
+struct PushConstantHandle
+{
+    vk::ShaderStageFlags stageFlags;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+};
+
+// Collects push constants visible to the same stages and writes them with a single command,
+// bytes between the set members are written as zeros
+class PushConstantBlock
+{
+public:
+    // Minimal push constants size guaranteed by Vulkan
+    static constexpr uint32_t kMaxSize = 128;
+
+    template <class T>
+    PushConstantBlock& Set(const PushConstantHandle& handle, const T& value);
+
+private:
+    std::array<uint8_t, kMaxSize> data = {};
+
+    vk::ShaderStageFlags stageFlags;
+    uint32_t begin = kMaxSize;
+    uint32_t end = 0;
+
+    friend class PipelineBase;
+};
+
 class PipelineBase
 {
 public:
@@ -23,10 +55,20 @@ public:
     void BindDescriptorSets(vk::CommandBuffer commandBuffer,
             const std::vector<vk::DescriptorSet>& descriptorSets) const;
 
+    PushConstantHandle GetPushConstantHandle(const std::string& name) const;
+
+    template <class T>
+    void PushConstant(vk::CommandBuffer commandBuffer,
+            const PushConstantHandle& handle, const T& value) const;
+
+    // Looks the name up in reflection on each call, meant for one-time commands,
+    // per frame recording resolves handles when the pipeline is created
     template <class T>
     void PushConstant(vk::CommandBuffer commandBuffer,
             const std::string& name, const T& value) const;
 
+    void PushConstants(vk::CommandBuffer commandBuffer, const PushConstantBlock& block) const;
+
     std::unique_ptr<DescriptorProvider> CreateDescriptorProvider() const;
 
 protected:
@@ -46,11 +88,35 @@ private:
 };
 
 template <class T>
-void PipelineBase::PushConstant(vk::CommandBuffer commandBuffer, const std::string& name, const T& value) const
+PushConstantBlock& PushConstantBlock::Set(const PushConstantHandle& handle, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    Assert(handle.size == sizeof(T));
+    Assert(handle.offset + handle.size <= kMaxSize);
+    Assert(!stageFlags || stageFlags == handle.stageFlags);
+
+    std::memcpy(data.data() + handle.offset, &value, sizeof(T));
+
+    stageFlags = handle.stageFlags;
+    begin = std::min(begin, handle.offset);
+    end = std::max(end, handle.offset + handle.size);
+
+    return *this;
+}
+
+template <class T>
+void PipelineBase::PushConstant(vk::CommandBuffer commandBuffer, const PushConstantHandle& handle, const T& value) const
 {
-    Assert(reflection.pushConstants.contains(name));
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    Assert(handle.size == sizeof(T));
 
-    const vk::PushConstantRange& pushConstantRange = reflection.pushConstants.at(name);
+    commandBuffer.pushConstants<T>(layout, handle.stageFlags, handle.offset, { value });
+}
 
-    commandBuffer.pushConstants<T>(layout, pushConstantRange.stageFlags, pushConstantRange.offset, { value });
+template <class T>
+void PipelineBase::PushConstant(vk::CommandBuffer commandBuffer, const std::string& name, const T& value) const
+{
+    PushConstant(commandBuffer, GetPushConstantHandle(name), value);
 }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Filesystem/Filepath.hpp"
+
+#include <atomic>
+
+struct PipelineCacheStats
+{
+    // Cache data was loaded from disk and matched the device
+    bool warm = false;
+    uint32_t pipelineCount = 0;
+    float creationSeconds = 0.0f;
+};
+
+// Driver pipeline cache shared by all pipelines, loaded on creation and saved on destruction.
+// Stored data is dropped if it was saved for another device or driver version
+class PipelineCache
+{
+public:
+    PipelineCache(const Filepath& path_);
+    ~PipelineCache();
+
+    vk::PipelineCache Get() const { return cache; }
+
+    void AddPipelineCreation(float seconds);
+
+    PipelineCacheStats GetStats() const;
+
+private:
+    Filepath path;
+
+    vk::PipelineCache cache;
+
+    bool warm = false;
+    std::atomic<uint32_t> pipelineCount = 0;
+    std::atomic<float> creationSeconds = 0.0f;
+
+    void Save() const;
+};
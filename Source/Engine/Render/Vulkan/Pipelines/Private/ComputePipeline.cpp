@@ -3,6 +3,8 @@
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderHelpers.hpp"
 
+#include "Utils/TimeHelpers.hpp"
+
 std::unique_ptr<ComputePipeline> ComputePipeline::Create(const ShaderModule& shaderModule)
 {
     const std::vector<ShaderModule> shaderModules{ shaderModule };
@@ -21,9 +23,15 @@ std::unique_ptr<ComputePipeline> ComputePipeline::Create(const ShaderModule& sha
 
     const vk::ComputePipelineCreateInfo createInfo({}, shaderStageCreateInfo, layout);
 
-    const auto [result, pipeline] = VulkanContext::device->Get().createComputePipeline(nullptr, createInfo);
+    Timer timer;
+    timer.Tick();
+
+    const auto [result, pipeline] = VulkanContext::device->Get().createComputePipeline(
+            VulkanContext::pipelineCache->Get(), createInfo);
     Assert(result == vk::Result::eSuccess);
 
+    VulkanContext::pipelineCache->AddPipelineCreation(timer.Tick());
+
     return std::unique_ptr<ComputePipeline>(new ComputePipeline(pipeline, layout,
             descriptorSetLayouts, shaderModule.reflection));
 }
@@ -5,6 +5,7 @@
 #include "Engine/Render/Vulkan/Shaders/ShaderHelpers.hpp"
 
 #include "Utils/Assert.hpp"
+#include "Utils/TimeHelpers.hpp"
 
 namespace Details
 {
@@ -215,9 +216,15 @@ std::unique_ptr<GraphicsPipeline> GraphicsPipeline::Create(
             &depthStencilState, &colorBlendState, &dynamicState,
             layout, renderPass, 0, nullptr, 0);
 
-    const auto [result, pipeline] = VulkanContext::device->Get().createGraphicsPipeline(nullptr, createInfo);
+    Timer timer;
+    timer.Tick();
+
+    const auto [result, pipeline] = VulkanContext::device->Get().createGraphicsPipeline(
+            VulkanContext::pipelineCache->Get(), createInfo);
     Assert(result == vk::Result::eSuccess);
 
+    VulkanContext::pipelineCache->AddPipelineCreation(timer.Tick());
+
     return std::unique_ptr<GraphicsPipeline>(new GraphicsPipeline(pipeline, layout,
             descriptorSetLayouts, reflection));
 }
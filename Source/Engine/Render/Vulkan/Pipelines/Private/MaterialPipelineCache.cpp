@@ -4,7 +4,7 @@
 #include "Engine/Render/Stages/GBufferStage.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/Pipelines/GraphicsPipeline.hpp"
-#include "Engine/Scene/Primitive.hpp"
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
 
 namespace Details
 {
@@ -31,6 +31,8 @@ namespace Details
     {
         ShaderDefines shaderDefines = MaterialHelpers::GetShaderDefines(flags);
 
+        shaderDefines.emplace("VERTEX_LAYOUT", static_cast<uint32_t>(GeometryArena::GetVertexLayout()));
+
         if (stage == MaterialPipelineStage::eForward)
         {
             static const CVarBool& rayTracingAllowedCVar = CVarBool::Get("r.RayTracingAllowed");
@@ -93,7 +95,7 @@ namespace Details
             vk::SampleCountFlagBits::e1,
             vk::CompareOp::eLess,
             shaderModules,
-            Primitive::kVertexInputs,
+            GeometryArena::GetVertexInputs(),
             blendModes
         };
 
@@ -25,6 +25,24 @@ void PipelineBase::BindDescriptorSets(vk::CommandBuffer commandBuffer,
     commandBuffer.bindDescriptorSets(GetBindPoint(), layout, 0, descriptorSets, {});
 }
 
+PushConstantHandle PipelineBase::GetPushConstantHandle(const std::string& name) const
+{
+    const auto it = reflection.pushConstants.find(name);
+    Assert(it != reflection.pushConstants.end());
+
+    const vk::PushConstantRange& pushConstantRange = it->second;
+
+    return PushConstantHandle{ pushConstantRange.stageFlags, pushConstantRange.offset, pushConstantRange.size };
+}
+
+void PipelineBase::PushConstants(vk::CommandBuffer commandBuffer, const PushConstantBlock& block) const
+{
+    Assert(block.begin < block.end);
+
+    commandBuffer.pushConstants(layout, block.stageFlags, block.begin,
+            block.end - block.begin, block.data.data() + block.begin);
+}
+
 std::unique_ptr<DescriptorProvider> PipelineBase::CreateDescriptorProvider() const
 {
     return std::make_unique<DescriptorProvider>(reflection.descriptors, descriptorSetLayouts);
@@ -0,0 +1,150 @@
+#include "Engine/Render/Vulkan/Pipelines/PipelineCache.hpp"
+
+#include "Engine/Filesystem/Filesystem.hpp"
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/TimeHelpers.hpp"
+
+#include <array>
+
+namespace Details
+{
+    static constexpr uint32_t kMagic = 0x48435050;
+    static constexpr uint32_t kVersion = 1;
+
+    // Driver validates its own data too, but not all drivers handle foreign data gracefully
+    struct Header
+    {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint32_t vendorId = 0;
+        uint32_t deviceId = 0;
+        uint32_t driverVersion = 0;
+        std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUuid = {};
+        uint64_t dataSize = 0;
+    };
+
+    static Header CreateHeader(uint64_t dataSize)
+    {
+        const vk::PhysicalDeviceProperties& properties = VulkanContext::device->GetProperties();
+
+        Header header{
+            .vendorId = properties.vendorID,
+            .deviceId = properties.deviceID,
+            .driverVersion = properties.driverVersion,
+            .dataSize = dataSize
+        };
+
+        std::ranges::copy(properties.pipelineCacheUUID, header.pipelineCacheUuid.begin());
+
+        return header;
+    }
+
+    static bool IsHeaderValid(const Header& header, uint64_t dataSize)
+    {
+        const Header expectedHeader = CreateHeader(dataSize);
+
+        return header.magic == expectedHeader.magic
+                && header.version == expectedHeader.version
+                && header.vendorId == expectedHeader.vendorId
+                && header.deviceId == expectedHeader.deviceId
+                && header.driverVersion == expectedHeader.driverVersion
+                && header.pipelineCacheUuid == expectedHeader.pipelineCacheUuid
+                && header.dataSize == expectedHeader.dataSize;
+    }
+
+    static ByteView GetCacheData(const Bytes& bytes)
+    {
+        if (bytes.size() < sizeof(Header))
+        {
+            return ByteView();
+        }
+
+        Header header;
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+
+        const uint64_t dataSize = bytes.size() - sizeof(Header);
+
+        if (!IsHeaderValid(header, dataSize))
+        {
+            return ByteView();
+        }
+
+        return ByteView(bytes.data() + sizeof(Header), static_cast<size_t>(dataSize));
+    }
+}
+
+PipelineCache::PipelineCache(const Filepath& path_)
+    : path(path_)
+{
+    EASY_FUNCTION()
+
+    const Bytes bytes = path.Exists() ? Filesystem::ReadBinaryFile(path) : Bytes();
+
+    const ByteView data = Details::GetCacheData(bytes);
+
+    warm = data.size > 0;
+
+    if (!warm && !bytes.empty())
+    {
+        LogW << "Pipeline cache is dropped, it was saved for another device or driver: " << path.GetAbsolute() << "\n";
+    }
+
+    const vk::PipelineCacheCreateInfo createInfo({}, data.size, data.data);
+
+    const auto [result, pipelineCache] = VulkanContext::device->Get().createPipelineCache(createInfo);
+    Assert(result == vk::Result::eSuccess);
+
+    cache = pipelineCache;
+}
+
+PipelineCache::~PipelineCache()
+{
+    LogI << "Pipeline cache (" << (warm ? "warm" : "cold") << "): " << pipelineCount << " pipelines created in "
+            << creationSeconds / Metric::kMili << " ms\n";
+
+    Save();
+
+    VulkanContext::device->Get().destroyPipelineCache(cache);
+}
+
+void PipelineCache::AddPipelineCreation(float seconds)
+{
+    ++pipelineCount;
+    creationSeconds += seconds;
+}
+
+PipelineCacheStats PipelineCache::GetStats() const
+{
+    return PipelineCacheStats{
+        .warm = warm,
+        .pipelineCount = pipelineCount,
+        .creationSeconds = creationSeconds
+    };
+}
+
+void PipelineCache::Save() const
+{
+    EASY_FUNCTION()
+
+    const auto [result, data] = VulkanContext::device->Get().getPipelineCacheData(cache);
+
+    if (result != vk::Result::eSuccess || data.empty())
+    {
+        return;
+    }
+
+    const Details::Header header = Details::CreateHeader(data.size());
+
+    Bytes bytes(sizeof(Details::Header) + data.size());
+
+    std::memcpy(bytes.data(), &header, sizeof(Details::Header));
+    std::memcpy(bytes.data() + sizeof(Details::Header), data.data(), data.size());
+
+    if (!Filesystem::WriteBinaryFile(path, ByteView(bytes)))
+    {
+        LogE << "Failed to save pipeline cache: " << path.GetAbsolute() << "\n";
+    }
+}
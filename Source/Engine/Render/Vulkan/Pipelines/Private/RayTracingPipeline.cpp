@@ -6,6 +6,7 @@
 #include "Engine/Render/Vulkan/Shaders/ShaderHelpers.hpp"
 
 #include "Utils/Assert.hpp"
+#include "Utils/TimeHelpers.hpp"
 
 namespace Details
 {
@@ -146,11 +147,16 @@ std::unique_ptr<RayTracingPipeline> RayTracingPipeline::Create(const Description
             static_cast<uint32_t>(shaderGroupsCreateInfo.size()), shaderGroupsCreateInfo.data(),
             8, nullptr, nullptr, nullptr, layout);
 
+    Timer timer;
+    timer.Tick();
+
     const auto [result, pipeline] = VulkanContext::device->Get().createRayTracingPipelineKHR(
-            vk::DeferredOperationKHR(), vk::PipelineCache(), createInfo);
+            vk::DeferredOperationKHR(), VulkanContext::pipelineCache->Get(), createInfo);
 
     Assert(result == vk::Result::eSuccess);
 
+    VulkanContext::pipelineCache->AddPipelineCreation(timer.Tick());
+
     return std::unique_ptr<RayTracingPipeline>(new RayTracingPipeline(pipeline, layout,
             descriptorSetLayouts, reflection, description.shaderGroupMap));
 }
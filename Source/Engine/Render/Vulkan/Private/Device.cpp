@@ -70,6 +70,26 @@ namespace Details
         return static_cast<uint32_t>(std::distance(queueFamilies.begin(), it));
     }
 
+    static std::optional<uint32_t> FindAsyncComputeQueueFamilyIndex(vk::PhysicalDevice physicalDevice)
+    {
+        const auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+
+        constexpr auto pred = [](const vk::QueueFamilyProperties& queueFamily)
+            {
+                return queueFamily.queueCount > 0 && queueFamily.queueFlags & vk::QueueFlagBits::eCompute
+                        && !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics);
+            };
+
+        const auto it = std::ranges::find_if(queueFamilies, pred);
+
+        if (it == queueFamilies.end())
+        {
+            return std::nullopt;
+        }
+
+        return static_cast<uint32_t>(std::distance(queueFamilies.begin(), it));
+    }
+
     static std::optional<uint32_t> FindCommonQueueFamilyIndex(
             vk::PhysicalDevice physicalDevice, vk::SurfaceKHR surface)
     {
@@ -153,6 +173,13 @@ namespace Details
                     queuesDescription.presentFamilyIndex, 1, &queuePriority);
         }
 
+        if (queuesDescription.computeFamilyIndex.has_value()
+                && queuesDescription.computeFamilyIndex != queuesDescription.presentFamilyIndex)
+        {
+            queuesCreateInfo.emplace_back(vk::DeviceQueueCreateFlags(),
+                    queuesDescription.computeFamilyIndex.value(), 1, &queuePriority);
+        }
+
         return queuesCreateInfo;
     }
 
@@ -160,6 +187,8 @@ namespace Details
     {
         vk::PhysicalDeviceFeatures features;
         features.setSamplerAnisotropy(deviceFeatures.samplerAnisotropy);
+        features.setMultiDrawIndirect(deviceFeatures.multiDrawIndirect);
+        features.setDrawIndirectFirstInstance(deviceFeatures.drawIndirectFirstInstance);
 
         vk::PhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructureFeatures;
         accelerationStructureFeatures.setAccelerationStructure(deviceFeatures.accelerationStructure);
@@ -249,9 +278,11 @@ std::unique_ptr<Device> Device::Create(const DeviceFeatures& requiredFeatures,
     const auto physicalDevice = Details::FindSuitablePhysicalDevice(
             VulkanContext::instance->Get(), requiredExtensions);
 
-    const Queues::Description queuesDescription = Details::GetQueuesDescription(physicalDevice,
+    Queues::Description queuesDescription = Details::GetQueuesDescription(physicalDevice,
             VulkanContext::surface->Get());
 
+    queuesDescription.computeFamilyIndex = Details::FindAsyncComputeQueueFamilyIndex(physicalDevice);
+
     const std::vector<vk::DeviceQueueCreateInfo> queueCreatesInfo
             = Details::CreateQueuesCreateInfo(queuesDescription);
 
@@ -270,6 +301,11 @@ std::unique_ptr<Device> Device::Create(const DeviceFeatures& requiredFeatures,
     const vk::PhysicalDeviceProperties properties = physicalDevice.getProperties();
     LogI << "GPU selected: " << properties.deviceName << "\n";
 
+    if (queuesDescription.computeFamilyIndex.has_value())
+    {
+        LogI << "Async compute queue family: " << queuesDescription.computeFamilyIndex.value() << "\n";
+    }
+
     LogD << "Device created" << "\n";
 
     return std::unique_ptr<Device>(new Device(device, physicalDevice, queuesDescription));
@@ -286,6 +322,18 @@ Device::Device(vk::Device device_, vk::PhysicalDevice physicalDevice_, const Que
     queues.graphics = device.getQueue(queuesDescription.graphicsFamilyIndex, 0);
     queues.present = device.getQueue(queuesDescription.presentFamilyIndex, 0);
 
+    if (queuesDescription.computeFamilyIndex.has_value())
+    {
+        queues.compute = device.getQueue(queuesDescription.computeFamilyIndex.value(), 0);
+
+        const auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+        computeTimestampValidBits = queueFamilies[queuesDescription.computeFamilyIndex.value()].timestampValidBits;
+
+        commandPools[CommandBufferType::eAsyncCompute] = Details::CreateCommandPool(device,
+                vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                queuesDescription.computeFamilyIndex.value());
+    }
+
     commandPools[CommandBufferType::eOneTime] = Details::CreateCommandPool(device,
             vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient,
             queuesDescription.graphicsFamilyIndex);
@@ -294,6 +342,10 @@ Device::Device(vk::Device device_, vk::PhysicalDevice physicalDevice_, const Que
             vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
             queuesDescription.graphicsFamilyIndex);
 
+    commandPools[CommandBufferType::eUpload] = Details::CreateCommandPool(device,
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient,
+            queuesDescription.graphicsFamilyIndex);
+
     oneTimeCommandsSync.fence = VulkanHelpers::CreateFence(device, vk::FenceCreateFlags());
 }
 
@@ -358,6 +410,14 @@ vk::DeviceAddress Device::GetAddress(vk::AccelerationStructureKHR accelerationSt
 
 void Device::ExecuteOneTimeCommands(const DeviceCommands& commands) const
 {
+    // Called before locking queues, submitter may hold its own lock while locking them
+    if (pendingWorkSubmitter)
+    {
+        pendingWorkSubmitter();
+    }
+
+    const std::unique_lock lock = LockQueues();
+
     vk::CommandBuffer commandBuffer;
 
     const vk::CommandPool commandPool = commandPools.at(CommandBufferType::eOneTime);
@@ -379,8 +439,15 @@ void Device::ExecuteOneTimeCommands(const DeviceCommands& commands) const
     device.freeCommandBuffers(commandPool, { commandBuffer });
 }
 
+void Device::SetPendingWorkSubmitter(std::function<void()> submitter)
+{
+    pendingWorkSubmitter = std::move(submitter);
+}
+
 vk::CommandBuffer Device::AllocateCommandBuffer(CommandBufferType type) const
 {
+    const std::unique_lock lock = LockQueues();
+
     vk::CommandBuffer commandBuffer;
 
     const vk::CommandBufferAllocateInfo allocateInfo(commandPools.at(type), vk::CommandBufferLevel::ePrimary, 1);
@@ -391,8 +458,15 @@ vk::CommandBuffer Device::AllocateCommandBuffer(CommandBufferType type) const
     return commandBuffer;
 }
 
+std::unique_lock<std::recursive_mutex> Device::LockQueues() const
+{
+    return std::unique_lock(queuesMutex);
+}
+
 void Device::WaitIdle() const
 {
+    const std::unique_lock lock = LockQueues();
+
     const vk::Result result = device.waitIdle();
     Assert(result == vk::Result::eSuccess);
 }
@@ -15,6 +15,8 @@ namespace Details
 #endif
     static CVarBool validationEnabledCVar("vk.ValidationEnabled", validationEnabled);
 
+    static const Filepath kPipelineCachePath("~/Config/PipelineCache.bin");
+
 
     static void InitializeDefaultDispatcher()
     {
@@ -48,6 +50,7 @@ std::unique_ptr<Swapchain> VulkanContext::swapchain;
 
 std::unique_ptr<DescriptorManager> VulkanContext::descriptorManager;
 std::unique_ptr<ShaderManager> VulkanContext::shaderManager;
+std::unique_ptr<PipelineCache> VulkanContext::pipelineCache;
 std::unique_ptr<MemoryManager> VulkanContext::memoryManager;
 
 void VulkanContext::Create(const Window& window)
@@ -67,12 +70,14 @@ void VulkanContext::Create(const Window& window)
     descriptorManager = DescriptorManager::Create();
 
     shaderManager = std::make_unique<ShaderManager>();
+    pipelineCache = std::make_unique<PipelineCache>(Details::kPipelineCachePath);
     memoryManager = std::make_unique<MemoryManager>();
 }
 
 void VulkanContext::Destroy()
 {
     memoryManager.reset();
+    pipelineCache.reset();
     shaderManager.reset();
     descriptorManager.reset();
     swapchain.reset();
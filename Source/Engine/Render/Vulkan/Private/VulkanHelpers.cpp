@@ -42,6 +42,11 @@ const SyncScope SyncScope::kIndicesRead{
     vk::AccessFlagBits::eIndexRead
 };
 
+const SyncScope SyncScope::kIndirectCommandRead{
+    vk::PipelineStageFlagBits::eDrawIndirect,
+    vk::AccessFlagBits::eIndirectCommandRead
+};
+
 const SyncScope SyncScope::kAccelerationStructureWrite{
     vk::PipelineStageFlagBits::eAccelerationStructureBuildKHR,
     vk::AccessFlagBits::eAccelerationStructureWriteKHR
@@ -62,6 +67,11 @@ const SyncScope SyncScope::kRayTracingAccelerationStructureRead{
     vk::AccessFlagBits::eAccelerationStructureReadKHR
 };
 
+const SyncScope SyncScope::kShaderAccelerationStructureRead{
+    VulkanHelpers::kShaderPipelineStages,
+    vk::AccessFlagBits::eAccelerationStructureReadKHR
+};
+
 const SyncScope SyncScope::kRayTracingShaderWrite{
     vk::PipelineStageFlagBits::eRayTracingShaderKHR,
     vk::AccessFlagBits::eShaderWrite
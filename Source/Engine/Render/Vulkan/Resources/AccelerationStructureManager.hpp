@@ -1,30 +1,52 @@
 #pragma once
 
+#include "Engine/Render/Vulkan/VulkanHelpers.hpp"
+
 #include "Utils/DataHelpers.hpp"
 
+// Buffers are used as build inputs directly, they require device address and build input usage
 struct BlasGeometryData
 {
     vk::IndexType indexType;
     uint32_t indexCount;
-    ByteView indices;
+    vk::Buffer indexBuffer;
+    vk::DeviceSize indexOffset = 0;
 
     vk::Format vertexFormat;
     uint32_t vertexStride;
     uint32_t vertexCount;
-    ByteView vertices;
+    vk::Buffer vertexBuffer;
+    vk::DeviceSize vertexOffset = 0;
 };
 
 using TlasInstances = std::vector<vk::AccelerationStructureInstanceKHR>;
 
+struct TlasBuildInfo
+{
+    uint32_t instanceCount = 0;
+
+    // Written to instance buffer starting from instanceOffset, other instances keep previous content
+    DataView<vk::AccelerationStructureInstanceKHR> instances;
+    uint32_t instanceOffset = 0;
+
+    // Refits previous build in place, instance count has to match it
+    bool update = false;
+
+    // Async compute builds are synchronized with semaphores and don't need a barrier for consumers
+    SyncScope blockedScope = SyncScope::kShaderAccelerationStructureRead;
+};
+
 class AccelerationStructureManager
 {
 public:
-    vk::AccelerationStructureKHR GenerateBlas(const BlasGeometryData& geometryData);
+    // Builds are batched into few submits sharing scratch memory, results are compacted
+    std::vector<vk::AccelerationStructureKHR> GenerateBlases(const std::vector<BlasGeometryData>& geometries);
 
+    // Instance count is used as capacity, TLAS can be built with fewer instances
     vk::AccelerationStructureKHR CreateTlas(uint32_t instanceCount);
 
     void BuildTlas(vk::CommandBuffer commandBuffer,
-            vk::AccelerationStructureKHR tlas, const TlasInstances& instances);
+            vk::AccelerationStructureKHR tlas, const TlasBuildInfo& buildInfo);
 
     void DestroyAccelerationStructure(vk::AccelerationStructureKHR accelerationStructure);
 
@@ -37,4 +59,8 @@ private:
     };
 
     std::map<vk::AccelerationStructureKHR, AccelerationStructureBuffers> accelerationStructures;
+
+    // Builds geometries in range [first, first + count) into blases, returns their compacted size
+    vk::DeviceSize GenerateBlasBatch(const std::vector<BlasGeometryData>& geometries, size_t first, size_t count,
+            vk::Buffer scratchBuffer, std::vector<vk::AccelerationStructureKHR>& blases);
 };
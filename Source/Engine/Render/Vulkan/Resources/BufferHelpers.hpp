@@ -19,26 +19,41 @@ struct BufferDescription
     vk::DeviceSize size = 0;
     vk::BufferUsageFlags usage;
     uint32_t scratchAlignment : 1 = false;
+    // Keeps persistent staging memory for frequently updated or read back buffers,
+    // initial data and other updates use transient staging that is released after the copy
     uint32_t stagingBuffer : 1 = false;
+    // Shared between graphics and async compute queues without ownership transfers
+    uint32_t asyncComputeShared : 1 = false;
     ByteView initialData;
 };
 
 using BufferReader = std::function<void(const ByteView&)>;
 using BufferUpdater = std::function<void(const ByteAccess&)>;
 
+// Only the updated range is copied, updater fills size bytes or the rest of the buffer starting from offset
 struct BufferUpdate
 {
     ByteView data;
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = 0;
     SyncScope waitedScope = SyncScope::kWaitForNone;
     SyncScope blockedScope = SyncScope::kBlockNone;
     BufferUpdater updater = nullptr;
 };
 
+struct BufferUpdateStats
+{
+    uint64_t uploadedBytes = 0;
+    uint32_t copyRegionCount = 0;
+    uint32_t barrierCount = 0;
+};
+
 namespace BufferHelpers
 {
     void InsertPipelineBarrier(vk::CommandBuffer commandBuffer,
             vk::Buffer buffer, const PipelineBarrier& barrier);
 
+    // Staging memory stays mapped and is accessed with MemoryManager::GetMappedMemory
     vk::Buffer CreateStagingBuffer(vk::DeviceSize size);
 }
 
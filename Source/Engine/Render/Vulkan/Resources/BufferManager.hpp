@@ -2,17 +2,28 @@
 
 #include "Engine/Render/Vulkan/Resources/BufferHelpers.hpp"
 
-struct SyncScope;
+#include <atomic>
+#include <mutex>
 
 class BufferManager
 {
 public:
+    ~BufferManager();
+
     vk::Buffer CreateBuffer(const BufferDescription& description);
 
-    const BufferDescription& GetBufferDescription(vk::Buffer buffer) const;
+    BufferDescription GetBufferDescription(vk::Buffer buffer) const;
 
     void UpdateBuffer(vk::CommandBuffer commandBuffer,
-            vk::Buffer buffer, const BufferUpdate& update) const;
+            vk::Buffer buffer, const BufferUpdate& update);
+
+    // Data is written to persistent staging immediately, copies are recorded by FlushBufferUpdates
+    void EnqueueBufferUpdate(vk::Buffer buffer, const BufferUpdate& update);
+
+    // Adjacent and overlapping ranges are coalesced, all copies share one barrier before and one after
+    void FlushBufferUpdates(vk::CommandBuffer commandBuffer);
+
+    BufferUpdateStats GetUpdateStats() const;
 
     void ReadBuffer(vk::CommandBuffer commandBuffer,
             vk::Buffer buffer, const BufferReader& reader) const;
@@ -26,5 +37,34 @@ private:
         vk::Buffer stagingBuffer;
     };
 
+    struct PendingUpdate
+    {
+        std::vector<vk::BufferCopy> regions;
+        SyncScope waitedScope = SyncScope::kWaitForNone;
+        SyncScope blockedScope = SyncScope::kBlockNone;
+    };
+
+    // Buffers are created on the main thread while the render thread records, lock is held only for map access
     std::map<vk::Buffer, BufferEntry> buffers;
+    mutable std::mutex buffersMutex;
+
+    // Entries are kept after flush with empty regions, so steady state updates don't allocate.
+    // Guarded by buffersMutex with the flag, buffers are destroyed on the main thread while the render thread flushes
+    std::map<vk::Buffer, PendingUpdate> pendingUpdates;
+    bool hasPendingUpdates = false;
+
+    std::atomic<uint64_t> uploadedBytes = 0;
+    std::atomic<uint32_t> copyRegionCount = 0;
+    std::atomic<uint32_t> barrierCount = 0;
+
+    // Free transient staging buffers by size, returned once frames using them are completed
+    std::multimap<vk::DeviceSize, vk::Buffer> stagingPool;
+    std::mutex stagingPoolMutex;
+
+    // Returned by value, the entry can be erased by another thread once the lock is released
+    BufferEntry GetBufferEntry(vk::Buffer buffer) const;
+
+    vk::Buffer AcquireStagingBuffer(vk::DeviceSize size);
+
+    void ReleaseStagingBuffer(vk::Buffer stagingBuffer, vk::DeviceSize size);
 };
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Utils/DataHelpers.hpp"
+#include "Utils/RangeAllocator.hpp"
+
+#include <mutex>
+
+struct VertexInput;
+
+enum class VertexAttribute
+{
+    ePosition,
+    eNormal,
+    eTangent,
+    eTexCoord
+};
+
+// Values match VERTEX_LAYOUT_* defines of Common/Vertex.glsl
+enum class VertexLayout
+{
+    // Each attribute in its own float stream
+    eSeparate,
+    // All attributes in one float stream
+    eInterleaved,
+    // Float position stream and interleaved float attribute stream
+    ePositionSplit,
+    // Float position stream and interleaved stream of octahedral normals, tangents and half texture coordinates
+    eCompressed
+};
+
+struct GeometryData
+{
+    DataView<uint32_t> indices;
+    DataView<glm::vec3> positions;
+    DataView<glm::vec3> normals;
+    DataView<glm::vec3> tangents;
+    DataView<glm::vec2> texCoords;
+};
+
+// Indices are relative to the vertex offset, so ranges are drawn with firstIndex and vertexOffset
+struct GeometryRange
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+
+    bool IsEmpty() const { return indexCount == 0; }
+};
+
+struct GeometryStats
+{
+    VertexLayout vertexLayout = VertexLayout::eSeparate;
+    uint32_t vertexStreamCount = 0;
+    // Bytes fetched per vertex by passes that read all attributes
+    uint32_t vertexSize = 0;
+    // Bytes per vertex in the stream fetched by position only passes
+    uint32_t positionStride = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint64_t vertexMemorySize = 0;
+    uint64_t indexMemorySize = 0;
+};
+
+// Buffer handles captured by the main thread, recording binds them without locking the arena
+struct GeometryBuffers
+{
+    static constexpr uint32_t kMaxStreamCount = 4;
+
+    vk::Buffer indexBuffer;
+    std::array<vk::Buffer, kMaxStreamCount> vertexBuffers;
+    uint32_t vertexStreamCount = 0;
+};
+
+// Geometry of all primitives is suballocated from shared index and vertex stream buffers,
+// vertex streams use one allocator, so each primitive has the same vertex offset in all of them.
+// Attributes are packed into streams according to the vertex layout selected by r.VertexLayout
+class GeometryArena
+{
+public:
+    static void Create();
+    static void Destroy();
+
+    // Growing the arena flushes the render thread, so it's called only from the main thread
+    static GeometryRange Allocate(const GeometryData& data);
+
+    // Range is released after completion of frames that can still use it
+    static void Free(const GeometryRange& range);
+
+    // Buffers are recreated when the arena grows, so they shouldn't be cached longer than a frame
+    static vk::Buffer GetIndexBuffer();
+
+    // Returns the stream buffer containing the attribute
+    static vk::Buffer GetVertexBuffer(VertexAttribute attribute);
+
+    static uint32_t GetVertexStride(VertexAttribute attribute);
+
+    static VertexLayout GetVertexLayout();
+
+    static const std::string& GetVertexLayoutName(VertexLayout layout);
+
+    // Vertex inputs of all streams, attribute locations follow VertexAttribute order
+    static std::vector<VertexInput> GetVertexInputs();
+
+    // Position is the first attribute of the first stream in all layouts
+    static VertexInput GetPositionVertexInput();
+
+    static GeometryStats GetStats();
+
+    // Buffers are recreated when the arena grows, so they are captured into each render snapshot
+    static GeometryBuffers GetBuffers();
+
+    // Binds the index buffer and vertex streams starting from binding 0
+    static void Bind(vk::CommandBuffer commandBuffer, const GeometryBuffers& buffers, bool positionsOnly = false);
+
+private:
+    struct VertexStream
+    {
+        std::vector<VertexAttribute> attributes;
+        std::vector<vk::Format> formats;
+        uint32_t stride = 0;
+        vk::Buffer buffer;
+    };
+
+    static VertexLayout vertexLayout;
+
+    static RangeAllocator indexAllocator;
+    static RangeAllocator vertexAllocator;
+
+    static vk::Buffer indexBuffer;
+    static std::vector<VertexStream> vertexStreams;
+
+    // Guards allocators and buffer handles only, no other lock is taken while it's held
+    static std::mutex mutex;
+
+    // Serializes allocations including growth and uploads, the render thread never takes it
+    static std::mutex allocationMutex;
+
+    static void GrowIndexBuffer(uint32_t indexCount);
+
+    static void GrowVertexBuffers(uint32_t vertexCount);
+
+    static const VertexStream& GetVertexStream(VertexAttribute attribute);
+};
@@ -7,6 +7,8 @@ PRAGMA_ENABLE_WARNINGS
 #include "Utils/DataHelpers.hpp"
 #include "Utils/Assert.hpp"
 
+#include <atomic>
+
 struct MemoryBlock
 {
     vk::DeviceMemory memory;
@@ -26,6 +28,10 @@ public:
     vk::Buffer CreateBuffer(const vk::BufferCreateInfo& createInfo, 
             vk::MemoryPropertyFlags memoryProperties, vk::DeviceSize minMemoryAlignment = 0);
 
+    // Buffer gets dedicated memory that stays mapped until it's destroyed, MapMemory mustn't be used for it
+    vk::Buffer CreateMappedBuffer(const vk::BufferCreateInfo& createInfo,
+            vk::MemoryPropertyFlags memoryProperties);
+
     vk::Image CreateImage(const vk::ImageCreateInfo& createInfo, 
             vk::MemoryPropertyFlags memoryProperties);
 
@@ -39,6 +45,11 @@ public:
 
     MemoryBlock GetAccelerationStructureMemoryBlock(vk::AccelerationStructureKHR accelerationStructure) const;
 
+    ByteAccess GetMappedMemory(vk::Buffer buffer) const;
+
+    // Total size of buffer allocations in host visible memory
+    vk::DeviceSize GetHostVisibleBufferMemorySize() const { return hostVisibleBufferMemorySize; }
+
     ByteAccess MapMemory(const MemoryBlock& memoryBlock) const;
 
     void UnmapMemory(const MemoryBlock& memoryBlock) const;
@@ -51,11 +62,15 @@ private:
     std::map<vk::Buffer, VmaAllocation> bufferAllocations;
     std::map<vk::Image, VmaAllocation> imageAllocations;
     std::map<vk::AccelerationStructureKHR, VmaAllocation> accelerationStructureAllocations;
+
+    std::atomic<vk::DeviceSize> hostVisibleBufferMemorySize = 0;
     
     template <class T>
     MemoryBlock GetMemoryBlock(T object, std::map<T, VmaAllocation> allocations) const;
 
     void FreeMemory(const MemoryBlock& memoryBlock);
+
+    vk::DeviceSize GetHostVisibleSize(VmaAllocation allocation) const;
 };
 
 template <class T>
@@ -3,13 +3,24 @@
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 
+#include "Utils/Helpers.hpp"
+#include "Utils/Logger.hpp"
+
 namespace Details
 {
+    // Scratch and uncompacted storage of one batch, a single larger BLAS still forms its own batch
+    constexpr vk::DeviceSize kBlasBatchMemorySize = 256 * Metric::kMegabyte;
+
+    // Required alignment of acceleration structure offset within storage buffer
+    constexpr vk::DeviceSize kAccelerationStructureAlignment = 256;
+
     constexpr vk::BuildAccelerationStructureFlagsKHR kBlasBuildFlags
-            = vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace;
+            = vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace
+            | vk::BuildAccelerationStructureFlagBitsKHR::eAllowCompaction;
 
     constexpr vk::BuildAccelerationStructureFlagsKHR kTlasBuildFlags
-            = vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace;
+            = vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace
+            | vk::BuildAccelerationStructureFlagBitsKHR::eAllowUpdate;
 
     static vk::BuildAccelerationStructureFlagsKHR GetBuildFlags(vk::AccelerationStructureTypeKHR type)
     {
@@ -32,15 +43,93 @@ namespace Details
 
     static vk::Buffer CreateAccelerationStructureBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage)
     {
+        // Acceleration structures can be built on async compute queue and used by graphics one
         const vk::Buffer buffer = ResourceContext::CreateBuffer({
             .size = size,
             .usage = usage | vk::BufferUsageFlagBits::eShaderDeviceAddress,
-            .scratchAlignment = static_cast<bool>(usage & vk::BufferUsageFlagBits::eStorageBuffer)
+            .scratchAlignment = static_cast<bool>(usage & vk::BufferUsageFlagBits::eStorageBuffer),
+            .asyncComputeShared = static_cast<bool>(usage & vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR)
         });
 
         return buffer;
     }
 
+    struct BlasBuildInput
+    {
+        vk::AccelerationStructureGeometryKHR geometry;
+        uint32_t primitiveCount;
+        vk::AccelerationStructureBuildSizesInfoKHR buildSizesInfo;
+    };
+
+    static vk::DeviceSize Align(vk::DeviceSize offset, vk::DeviceSize alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    static BlasBuildInput GetBlasBuildInput(const BlasGeometryData& geometryData)
+    {
+        const vk::DeviceAddress vertexAddress
+                = VulkanContext::device->GetAddress(geometryData.vertexBuffer) + geometryData.vertexOffset;
+
+        const vk::DeviceAddress indexAddress
+                = VulkanContext::device->GetAddress(geometryData.indexBuffer) + geometryData.indexOffset;
+
+        const vk::AccelerationStructureGeometryTrianglesDataKHR trianglesData(
+                geometryData.vertexFormat, vertexAddress,
+                geometryData.vertexStride, geometryData.vertexCount - 1,
+                geometryData.indexType, indexAddress, nullptr);
+
+        const vk::AccelerationStructureGeometryKHR geometry(
+                vk::GeometryTypeKHR::eTriangles, trianglesData,
+                vk::GeometryFlagsKHR());
+
+        const uint32_t primitiveCount = geometryData.indexCount / 3;
+
+        const vk::AccelerationStructureBuildSizesInfoKHR buildSizesInfo = GetBuildSizesInfo(
+                vk::AccelerationStructureTypeKHR::eBottomLevel, geometry, primitiveCount);
+
+        return BlasBuildInput{ geometry, primitiveCount, buildSizesInfo };
+    }
+
+    static vk::AccelerationStructureKHR CreateAccelerationStructure(vk::AccelerationStructureTypeKHR type,
+            vk::Buffer storageBuffer, vk::DeviceSize offset, vk::DeviceSize size)
+    {
+        const vk::AccelerationStructureCreateInfoKHR createInfo({}, storageBuffer, offset,
+                size, type, vk::DeviceAddress());
+
+        const auto [result, accelerationStructure]
+                = VulkanContext::device->Get().createAccelerationStructureKHR(createInfo);
+
+        Assert(result == vk::Result::eSuccess);
+
+        return accelerationStructure;
+    }
+
+    static vk::QueryPool CreateCompactedSizeQueryPool(uint32_t queryCount)
+    {
+        const vk::QueryPoolCreateInfo createInfo{
+            {}, vk::QueryType::eAccelerationStructureCompactedSizeKHR, queryCount
+        };
+
+        const auto [result, queryPool] = VulkanContext::device->Get().createQueryPool(createInfo);
+        Assert(result == vk::Result::eSuccess);
+
+        return queryPool;
+    }
+
+    static std::vector<vk::DeviceSize> GetCompactedSizes(vk::QueryPool queryPool, uint32_t queryCount)
+    {
+        const vk::Device device = VulkanContext::device->Get();
+
+        const auto [result, compactedSizes] = device.getQueryPoolResults<vk::DeviceSize>(
+                queryPool, 0, queryCount, queryCount * sizeof(vk::DeviceSize), sizeof(vk::DeviceSize),
+                vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+
+        Assert(result == vk::Result::eSuccess);
+
+        return compactedSizes;
+    }
+
     static vk::Buffer CreateEmptyInstanceBuffer(uint32_t instanceCount)
     {
         const vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eShaderDeviceAddress
@@ -59,70 +148,76 @@ namespace Details
     }
 }
 
-vk::AccelerationStructureKHR AccelerationStructureManager::GenerateBlas(const BlasGeometryData& geometryData)
+std::vector<vk::AccelerationStructureKHR> AccelerationStructureManager::GenerateBlases(
+        const std::vector<BlasGeometryData>& geometries)
 {
-    constexpr vk::AccelerationStructureTypeKHR type = vk::AccelerationStructureTypeKHR::eBottomLevel;
+    EASY_FUNCTION()
 
-    constexpr vk::BufferUsageFlags bufferUsage = vk::BufferUsageFlagBits::eShaderDeviceAddress
-            | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR;
+    std::vector<vk::AccelerationStructureKHR> blases(geometries.size());
 
-    const vk::Buffer vertexBuffer = ResourceContext::CreateBuffer({
-        .usage = bufferUsage,
-        .initialData = ByteView(geometryData.vertices)
-    });
+    if (geometries.empty())
+    {
+        return blases;
+    }
 
-    const vk::Buffer indexBuffer = ResourceContext::CreateBuffer({
-        .usage = bufferUsage,
-        .initialData = ByteView(geometryData.indices)
-    });
+    const vk::DeviceSize scratchAlignment = VulkanContext::device->GetRayTracingProperties().minScratchOffsetAlignment;
 
-    const vk::AccelerationStructureGeometryTrianglesDataKHR trianglesData(
-            geometryData.vertexFormat, VulkanContext::device->GetAddress(vertexBuffer),
-            geometryData.vertexStride, geometryData.vertexCount - 1,
-            geometryData.indexType, VulkanContext::device->GetAddress(indexBuffer), nullptr);
+    std::vector<std::pair<size_t, size_t>> batches;
 
-    const vk::AccelerationStructureGeometryKHR geometry(
-            vk::GeometryTypeKHR::eTriangles, trianglesData,
-            vk::GeometryFlagsKHR());
+    vk::DeviceSize scratchSize = 0;
+    vk::DeviceSize buildSize = 0;
 
-    const uint32_t primitiveCount = geometryData.indexCount / 3;
+    size_t batchFirst = 0;
+    vk::DeviceSize batchScratchSize = 0;
+    vk::DeviceSize batchMemorySize = 0;
 
-    const vk::AccelerationStructureBuildSizesInfoKHR buildSizesInfo
-            = Details::GetBuildSizesInfo(type, geometry, primitiveCount);
+    for (size_t i = 0; i < geometries.size(); ++i)
+    {
+        const vk::AccelerationStructureBuildSizesInfoKHR& buildSizesInfo
+                = Details::GetBlasBuildInput(geometries[i]).buildSizesInfo;
 
-    AccelerationStructureBuffers buffers;
+        const vk::DeviceSize blasScratchSize = Details::Align(
+                buildSizesInfo.buildScratchSize, scratchAlignment);
 
-    buffers.scratchBuffer = Details::CreateAccelerationStructureBuffer(
-            buildSizesInfo.buildScratchSize, vk::BufferUsageFlagBits::eStorageBuffer);
+        const vk::DeviceSize blasStorageSize = Details::Align(
+                buildSizesInfo.accelerationStructureSize, Details::kAccelerationStructureAlignment);
 
-    buffers.storageBuffer = Details::CreateAccelerationStructureBuffer(
-            buildSizesInfo.accelerationStructureSize, vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR);
+        if (i > batchFirst && batchMemorySize + blasScratchSize + blasStorageSize > Details::kBlasBatchMemorySize)
+        {
+            batches.emplace_back(batchFirst, i - batchFirst);
 
-    const vk::AccelerationStructureCreateInfoKHR createInfo({}, buffers.storageBuffer, 0,
-            buildSizesInfo.accelerationStructureSize, type, vk::DeviceAddress());
+            batchFirst = i;
+            batchScratchSize = 0;
+            batchMemorySize = 0;
+        }
 
-    const auto [result, blas] = VulkanContext::device->Get().createAccelerationStructureKHR(createInfo);
+        batchScratchSize += blasScratchSize;
+        batchMemorySize += blasScratchSize + blasStorageSize;
 
-    const vk::AccelerationStructureBuildGeometryInfoKHR buildInfo(
-            type, vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace,
-            vk::BuildAccelerationStructureModeKHR::eBuild,
-            nullptr, blas, 1, &geometry, nullptr,
-            VulkanContext::device->GetAddress(buffers.scratchBuffer));
+        scratchSize = std::max(scratchSize, batchScratchSize);
+        buildSize += buildSizesInfo.accelerationStructureSize;
+    }
 
-    const vk::AccelerationStructureBuildRangeInfoKHR rangeInfo(primitiveCount, 0, 0, 0);
-    const vk::AccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
+    batches.emplace_back(batchFirst, geometries.size() - batchFirst);
 
-    VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
-        {
-            commandBuffer.buildAccelerationStructuresKHR({ buildInfo }, { pRangeInfo });
-        });
+    // Batches are executed one after another and reuse the same scratch arena
+    const vk::Buffer scratchBuffer = Details::CreateAccelerationStructureBuffer(
+            scratchSize, vk::BufferUsageFlagBits::eStorageBuffer);
+
+    vk::DeviceSize compactedSize = 0;
 
-    ResourceContext::DestroyResource(vertexBuffer);
-    ResourceContext::DestroyResource(indexBuffer);
+    for (const auto& [first, count] : batches)
+    {
+        compactedSize += GenerateBlasBatch(geometries, first, count, scratchBuffer, blases);
+    }
 
-    accelerationStructures.emplace(blas, buffers);
+    ResourceContext::DestroyResource(scratchBuffer);
 
-    return blas;
+    LogI << "Generated " << blases.size() << " BLASes in " << batches.size() << " batches, memory: "
+            << static_cast<float>(buildSize) / Metric::kMegabyte << " MB before compaction, "
+            << static_cast<float>(compactedSize) / Metric::kMegabyte << " MB after compaction\n";
+
+    return blases;
 }
 
 vk::AccelerationStructureKHR AccelerationStructureManager::CreateTlas(uint32_t instanceCount)
@@ -141,8 +236,10 @@ vk::AccelerationStructureKHR AccelerationStructureManager::CreateTlas(uint32_t i
     const vk::AccelerationStructureBuildSizesInfoKHR buildSizesInfo
             = Details::GetBuildSizesInfo(type, geometry, instanceCount);
 
+    const vk::DeviceSize scratchSize = std::max(buildSizesInfo.buildScratchSize, buildSizesInfo.updateScratchSize);
+
     buffers.scratchBuffer = Details::CreateAccelerationStructureBuffer(
-            buildSizesInfo.buildScratchSize, vk::BufferUsageFlagBits::eStorageBuffer);
+            scratchSize, vk::BufferUsageFlagBits::eStorageBuffer);
 
     buffers.storageBuffer = Details::CreateAccelerationStructureBuffer(
             buildSizesInfo.accelerationStructureSize, vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR);
@@ -160,19 +257,27 @@ vk::AccelerationStructureKHR AccelerationStructureManager::CreateTlas(uint32_t i
 }
 
 void AccelerationStructureManager::BuildTlas(vk::CommandBuffer commandBuffer,
-        vk::AccelerationStructureKHR tlas, const TlasInstances& instances)
+        vk::AccelerationStructureKHR tlas, const TlasBuildInfo& buildInfo)
 {
     constexpr vk::AccelerationStructureTypeKHR type = vk::AccelerationStructureTypeKHR::eTopLevel;
 
     AccelerationStructureBuffers& buffers = accelerationStructures.at(tlas);
 
     const BufferUpdate bufferUpdate{
-        .data = GetByteView(instances),
+        .data = buildInfo.instances.GetByteView(),
+        .offset = buildInfo.instanceOffset * sizeof(vk::AccelerationStructureInstanceKHR),
+        .waitedScope = SyncScope::kAccelerationStructureShaderRead,
         .blockedScope = SyncScope::kAccelerationStructureShaderRead
     };
 
     ResourceContext::UpdateBuffer(commandBuffer, buffers.sourceBuffer, bufferUpdate);
 
+    // Previous build and shaders reading TLAS have to finish before it's overwritten
+    VulkanHelpers::InsertMemoryBarrier(commandBuffer, PipelineBarrier{
+        SyncScope::kWaitForAll,
+        SyncScope::kAccelerationStructureWrite
+    });
+
     const vk::AccelerationStructureGeometryInstancesDataKHR instancesData(
             false, VulkanContext::device->GetAddress(buffers.sourceBuffer));
 
@@ -182,35 +287,159 @@ void AccelerationStructureManager::BuildTlas(vk::CommandBuffer commandBuffer,
             vk::GeometryTypeKHR::eInstances, geometryData,
             vk::GeometryFlagBitsKHR::eOpaque);
 
-    const vk::AccelerationStructureBuildGeometryInfoKHR buildInfo(
-            type, Details::GetBuildFlags(type),
-            vk::BuildAccelerationStructureModeKHR::eBuild,
-            nullptr, tlas, 1, &geometry, nullptr,
-            VulkanContext::device->GetAddress(buffers.scratchBuffer));
+    const vk::BuildAccelerationStructureModeKHR mode = buildInfo.update
+            ? vk::BuildAccelerationStructureModeKHR::eUpdate
+            : vk::BuildAccelerationStructureModeKHR::eBuild;
 
-    const uint32_t instanceCount = static_cast<uint32_t>(instances.size());
+    const vk::AccelerationStructureBuildGeometryInfoKHR geometryInfo(
+            type, Details::GetBuildFlags(type), mode,
+            buildInfo.update ? tlas : nullptr, tlas, 1, &geometry, nullptr,
+            VulkanContext::device->GetAddress(buffers.scratchBuffer));
 
-    const vk::AccelerationStructureBuildRangeInfoKHR rangeInfo(instanceCount, 0, 0, 0);
+    const vk::AccelerationStructureBuildRangeInfoKHR rangeInfo(buildInfo.instanceCount, 0, 0, 0);
     const vk::AccelerationStructureBuildRangeInfoKHR* pRangeInfo = &rangeInfo;
 
-    commandBuffer.buildAccelerationStructuresKHR({ buildInfo }, { pRangeInfo });
+    commandBuffer.buildAccelerationStructuresKHR({ geometryInfo }, { pRangeInfo });
 
     VulkanHelpers::InsertMemoryBarrier(commandBuffer, PipelineBarrier{
         SyncScope::kAccelerationStructureWrite,
-        SyncScope::kRayTracingAccelerationStructureRead,
+        buildInfo.blockedScope
     });
 
     const vk::AccelerationStructureBuildSizesInfoKHR buildSizesInfo
             = VulkanContext::device->Get().getAccelerationStructureBuildSizesKHR(
-                    vk::AccelerationStructureBuildTypeKHR::eDevice, buildInfo, { instanceCount });
+                    vk::AccelerationStructureBuildTypeKHR::eDevice, geometryInfo, { buildInfo.instanceCount });
 
     const vk::DeviceSize scratchBufferSize = ResourceContext::GetBufferDescription(buffers.scratchBuffer).size;
     const vk::DeviceSize storageBufferSize = ResourceContext::GetBufferDescription(buffers.storageBuffer).size;
 
-    Assert(buildSizesInfo.buildScratchSize <= scratchBufferSize);
+    const vk::DeviceSize scratchSize = buildInfo.update
+            ? buildSizesInfo.updateScratchSize : buildSizesInfo.buildScratchSize;
+
+    Assert(scratchSize <= scratchBufferSize);
     Assert(buildSizesInfo.accelerationStructureSize <= storageBufferSize);
 }
 
+vk::DeviceSize AccelerationStructureManager::GenerateBlasBatch(const std::vector<BlasGeometryData>& geometries,
+        size_t first, size_t count, vk::Buffer scratchBuffer, std::vector<vk::AccelerationStructureKHR>& blases)
+{
+    constexpr vk::AccelerationStructureTypeKHR type = vk::AccelerationStructureTypeKHR::eBottomLevel;
+
+    const vk::DeviceSize scratchAlignment = VulkanContext::device->GetRayTracingProperties().minScratchOffsetAlignment;
+
+    std::vector<Details::BlasBuildInput> buildInputs;
+    buildInputs.reserve(count);
+
+    vk::DeviceSize storageSize = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Details::BlasBuildInput& buildInput = buildInputs.emplace_back(
+                Details::GetBlasBuildInput(geometries[first + i]));
+
+        storageSize += Details::Align(buildInput.buildSizesInfo.accelerationStructureSize,
+                Details::kAccelerationStructureAlignment);
+    }
+
+    // Uncompacted BLASes are suballocated from one temporary buffer
+    const vk::Buffer storageBuffer = Details::CreateAccelerationStructureBuffer(
+            storageSize, vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR);
+
+    const vk::DeviceAddress scratchAddress = VulkanContext::device->GetAddress(scratchBuffer);
+
+    std::vector<vk::AccelerationStructureKHR> buildBlases(count);
+    std::vector<vk::AccelerationStructureBuildGeometryInfoKHR> buildInfos(count);
+    std::vector<vk::AccelerationStructureBuildRangeInfoKHR> rangeInfos(count);
+    std::vector<const vk::AccelerationStructureBuildRangeInfoKHR*> pRangeInfos(count);
+
+    vk::DeviceSize storageOffset = 0;
+    vk::DeviceSize scratchOffset = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Details::BlasBuildInput& buildInput = buildInputs[i];
+
+        const vk::AccelerationStructureBuildSizesInfoKHR& buildSizesInfo = buildInput.buildSizesInfo;
+
+        buildBlases[i] = Details::CreateAccelerationStructure(type,
+                storageBuffer, storageOffset, buildSizesInfo.accelerationStructureSize);
+
+        buildInfos[i] = vk::AccelerationStructureBuildGeometryInfoKHR(
+                type, Details::kBlasBuildFlags,
+                vk::BuildAccelerationStructureModeKHR::eBuild,
+                nullptr, buildBlases[i], 1, &buildInput.geometry, nullptr,
+                scratchAddress + scratchOffset);
+
+        rangeInfos[i] = vk::AccelerationStructureBuildRangeInfoKHR(buildInput.primitiveCount, 0, 0, 0);
+        pRangeInfos[i] = &rangeInfos[i];
+
+        storageOffset += Details::Align(buildSizesInfo.accelerationStructureSize,
+                Details::kAccelerationStructureAlignment);
+
+        scratchOffset += Details::Align(buildSizesInfo.buildScratchSize, scratchAlignment);
+    }
+
+    const uint32_t queryCount = static_cast<uint32_t>(count);
+
+    const vk::QueryPool queryPool = Details::CreateCompactedSizeQueryPool(queryCount);
+
+    VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
+        {
+            commandBuffer.buildAccelerationStructuresKHR(buildInfos, pRangeInfos);
+
+            VulkanHelpers::InsertMemoryBarrier(commandBuffer, PipelineBarrier{
+                SyncScope::kAccelerationStructureWrite,
+                SyncScope::kAccelerationStructureRead
+            });
+
+            commandBuffer.resetQueryPool(queryPool, 0, queryCount);
+
+            commandBuffer.writeAccelerationStructuresPropertiesKHR(buildBlases,
+                    vk::QueryType::eAccelerationStructureCompactedSizeKHR, queryPool, 0);
+        });
+
+    const std::vector<vk::DeviceSize> compactedSizes = Details::GetCompactedSizes(queryPool, queryCount);
+
+    VulkanContext::device->Get().destroyQueryPool(queryPool);
+
+    vk::DeviceSize compactedSize = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        AccelerationStructureBuffers buffers;
+
+        buffers.storageBuffer = Details::CreateAccelerationStructureBuffer(
+                compactedSizes[i], vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR);
+
+        blases[first + i] = Details::CreateAccelerationStructure(type,
+                buffers.storageBuffer, 0, compactedSizes[i]);
+
+        accelerationStructures.emplace(blases[first + i], buffers);
+
+        compactedSize += compactedSizes[i];
+    }
+
+    VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const vk::CopyAccelerationStructureInfoKHR copyInfo(buildBlases[i],
+                        blases[first + i], vk::CopyAccelerationStructureModeKHR::eCompact);
+
+                commandBuffer.copyAccelerationStructureKHR(copyInfo);
+            }
+        });
+
+    for (const vk::AccelerationStructureKHR buildBlas : buildBlases)
+    {
+        VulkanContext::device->Get().destroyAccelerationStructureKHR(buildBlas);
+    }
+
+    ResourceContext::DestroyResource(storageBuffer);
+
+    return compactedSize;
+}
+
 void AccelerationStructureManager::DestroyAccelerationStructure(vk::AccelerationStructureKHR accelerationStructure)
 {
     const auto it = accelerationStructures.find(accelerationStructure);
@@ -224,8 +453,11 @@ void AccelerationStructureManager::DestroyAccelerationStructure(vk::Acceleration
     {
         ResourceContext::DestroyResource(buffers.sourceBuffer);
     }
+    if (buffers.scratchBuffer)
+    {
+        ResourceContext::DestroyResource(buffers.scratchBuffer);
+    }
 
-    ResourceContext::DestroyResource(buffers.scratchBuffer);
     ResourceContext::DestroyResource(buffers.storageBuffer);
 
     accelerationStructures.erase(it);
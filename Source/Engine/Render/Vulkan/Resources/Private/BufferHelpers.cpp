@@ -24,7 +24,7 @@ vk::Buffer BufferHelpers::CreateStagingBuffer(vk::DeviceSize size)
             = vk::MemoryPropertyFlagBits::eHostVisible
             | vk::MemoryPropertyFlagBits::eHostCoherent;
 
-    return VulkanContext::memoryManager->CreateBuffer(createInfo, memoryProperties);
+    return VulkanContext::memoryManager->CreateMappedBuffer(createInfo, memoryProperties);
 }
 
 vk::BufferUsageFlags operator|(vk::BufferUsageFlags usage, BufferType type)
@@ -4,17 +4,99 @@
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 
 #include "Utils/Assert.hpp"
+#include "Utils/LinearArena.hpp"
+
+#include <bit>
 
 namespace Details
 {
-    static vk::BufferCreateInfo GetBufferCreateInfo(const BufferDescription& description)
+    constexpr vk::DeviceSize kMinStagingBufferSize = 4096;
+
+    // Transient staging buffers are pooled by power of two sizes
+    static vk::DeviceSize GetStagingPoolSize(vk::DeviceSize size)
+    {
+        return std::bit_ceil(std::max(size, kMinStagingBufferSize));
+    }
+
+    static vk::DeviceSize GetUpdateSize(const BufferDescription& description, const BufferUpdate& update)
+    {
+        if (update.updater)
+        {
+            return update.size > 0 ? update.size : description.size - update.offset;
+        }
+
+        return update.data.size;
+    }
+
+    static void WriteUpdate(const ByteAccess& stagingMemory,
+            vk::DeviceSize offset, vk::DeviceSize size, const BufferUpdate& update)
+    {
+        const ByteAccess rangeMemory(stagingMemory.data + offset, static_cast<size_t>(size));
+
+        if (update.updater)
+        {
+            update.updater(rangeMemory);
+        }
+        else
+        {
+            update.data.CopyTo(rangeMemory);
+        }
+    }
+
+    // Regions are copied from persistent staging that mirrors the buffer, so overlapping ones can be merged
+    static void CoalesceRegions(std::vector<vk::BufferCopy>& regions)
+    {
+        std::ranges::sort(regions, {}, &vk::BufferCopy::dstOffset);
+
+        size_t count = 0;
+
+        for (const vk::BufferCopy& region : regions)
+        {
+            if (count > 0)
+            {
+                vk::BufferCopy& lastRegion = regions[count - 1];
+
+                const vk::DeviceSize lastRegionEnd = lastRegion.dstOffset + lastRegion.size;
+
+                if (region.dstOffset <= lastRegionEnd)
+                {
+                    lastRegion.size = std::max(lastRegionEnd, region.dstOffset + region.size) - lastRegion.dstOffset;
+
+                    continue;
+                }
+            }
+
+            regions[count++] = region;
+        }
+
+        regions.resize(count);
+    }
+
+    static vk::BufferCreateInfo GetBufferCreateInfo(const BufferDescription& description,
+            std::vector<uint32_t>& queueFamilyIndices)
     {
         const Queues::Description& queuesDescription = VulkanContext::device->GetQueuesDescription();
 
-        const vk::BufferCreateInfo createInfo({}, description.size, description.usage,
-                vk::SharingMode::eExclusive, 0, &queuesDescription.graphicsFamilyIndex);
+        queueFamilyIndices = { queuesDescription.graphicsFamilyIndex };
+
+        if (description.asyncComputeShared && queuesDescription.computeFamilyIndex.has_value())
+        {
+            queueFamilyIndices.push_back(queuesDescription.computeFamilyIndex.value());
 
-        return createInfo;
+            return vk::BufferCreateInfo({}, description.size, description.usage,
+                    vk::SharingMode::eConcurrent, queueFamilyIndices);
+        }
+
+        return vk::BufferCreateInfo({}, description.size, description.usage,
+                vk::SharingMode::eExclusive, queueFamilyIndices);
+    }
+}
+
+BufferManager::~BufferManager()
+{
+    for (const auto& [size, stagingBuffer] : stagingPool)
+    {
+        VulkanContext::memoryManager->DestroyBuffer(stagingBuffer);
     }
 }
 
@@ -28,10 +110,11 @@ vk::Buffer BufferManager::CreateBuffer(const BufferDescription& description)
     if (bufferDescription.initialData.data)
     {
         bufferDescription.usage |= vk::BufferUsageFlagBits::eTransferDst;
-        bufferDescription.stagingBuffer = true;
     }
 
-    const vk::BufferCreateInfo createInfo = Details::GetBufferCreateInfo(bufferDescription);
+    std::vector<uint32_t> queueFamilyIndices;
+
+    const vk::BufferCreateInfo createInfo = Details::GetBufferCreateInfo(bufferDescription, queueFamilyIndices);
 
     vk::Buffer buffer;
 
@@ -52,58 +135,178 @@ vk::Buffer BufferManager::CreateBuffer(const BufferDescription& description)
         stagingBuffer = BufferHelpers::CreateStagingBuffer(bufferDescription.size);
     }
 
-    buffers.emplace(buffer, BufferEntry{ bufferDescription, stagingBuffer });
+    {
+        const std::unique_lock lock(buffersMutex);
+
+        buffers.emplace(buffer, BufferEntry{ bufferDescription, stagingBuffer });
+    }
 
     if (bufferDescription.initialData.data)
     {
-        VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
-            {
-                ResourceContext::UpdateBuffer(commandBuffer,
-                        buffer, BufferUpdate{ bufferDescription.initialData });
-            });
+        ResourceContext::UploadBuffer(buffer, bufferDescription.initialData);
     }
 
     return buffer;
 }
 
-const BufferDescription& BufferManager::GetBufferDescription(vk::Buffer buffer) const
+BufferDescription BufferManager::GetBufferDescription(vk::Buffer buffer) const
 {
-    return buffers.at(buffer).description;
+    return GetBufferEntry(buffer).description;
 }
 
 void BufferManager::UpdateBuffer(vk::CommandBuffer commandBuffer,
-        vk::Buffer buffer, const BufferUpdate& update) const
+        vk::Buffer buffer, const BufferUpdate& update)
 {
-    const auto& [description, stagingBuffer] = buffers.at(buffer);
+    const auto& [description, persistentStagingBuffer] = GetBufferEntry(buffer);
 
     Assert(description.usage & vk::BufferUsageFlagBits::eTransferDst);
 
-    const MemoryBlock memoryBlock = VulkanContext::memoryManager->GetBufferMemoryBlock(stagingBuffer);
+    const vk::DeviceSize size = Details::GetUpdateSize(description, update);
 
-    if (update.updater)
-    {
-        update.updater(VulkanContext::memoryManager->MapMemory(memoryBlock));
-    }
-    else
+    Assert(update.offset + size <= description.size);
+
+    if (size == 0)
     {
-        update.data.CopyTo(VulkanContext::memoryManager->MapMemory(memoryBlock));
+        return;
     }
 
-    VulkanContext::memoryManager->UnmapMemory(memoryBlock);
+    // Persistent staging mirrors the buffer, transient one holds only the updated range
+    const vk::Buffer stagingBuffer = persistentStagingBuffer ? persistentStagingBuffer : AcquireStagingBuffer(size);
+
+    const vk::DeviceSize stagingOffset = persistentStagingBuffer ? update.offset : 0;
+
+    Details::WriteUpdate(VulkanContext::memoryManager->GetMappedMemory(stagingBuffer), stagingOffset, size, update);
 
     BufferHelpers::InsertPipelineBarrier(commandBuffer, buffer,
             PipelineBarrier{ update.waitedScope, SyncScope::kTransferWrite });
 
-    commandBuffer.copyBuffer(stagingBuffer, buffer, { vk::BufferCopy(0, 0, description.size) });
+    commandBuffer.copyBuffer(stagingBuffer, buffer, { vk::BufferCopy(stagingOffset, update.offset, size) });
 
     BufferHelpers::InsertPipelineBarrier(commandBuffer, buffer,
             PipelineBarrier{ SyncScope::kTransferWrite, update.blockedScope });
+
+    if (!persistentStagingBuffer)
+    {
+        ReleaseStagingBuffer(stagingBuffer, size);
+    }
+
+    uploadedBytes += size;
+    copyRegionCount += 1;
+    barrierCount += 2;
+}
+
+void BufferManager::EnqueueBufferUpdate(vk::Buffer buffer, const BufferUpdate& update)
+{
+    const auto& [description, stagingBuffer] = GetBufferEntry(buffer);
+
+    Assert(stagingBuffer);
+
+    Assert(description.usage & vk::BufferUsageFlagBits::eTransferDst);
+
+    const vk::DeviceSize size = Details::GetUpdateSize(description, update);
+
+    Assert(update.offset + size <= description.size);
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    Details::WriteUpdate(VulkanContext::memoryManager->GetMappedMemory(stagingBuffer), update.offset, size, update);
+
+    const std::unique_lock lock(buffersMutex);
+
+    PendingUpdate& pendingUpdate = pendingUpdates[buffer];
+
+    pendingUpdate.regions.emplace_back(update.offset, update.offset, size);
+    pendingUpdate.waitedScope = pendingUpdate.waitedScope | update.waitedScope;
+    pendingUpdate.blockedScope = pendingUpdate.blockedScope | update.blockedScope;
+
+    hasPendingUpdates = true;
+}
+
+void BufferManager::FlushBufferUpdates(vk::CommandBuffer commandBuffer)
+{
+    const std::unique_lock lock(buffersMutex);
+
+    if (!hasPendingUpdates)
+    {
+        return;
+    }
+
+    SyncScope waitedScope = SyncScope::kWaitForNone;
+    SyncScope blockedScope = SyncScope::kBlockNone;
+
+    LinearArena& arena = RenderContext::frameLoop->GetArena();
+
+    ArenaVector<vk::BufferMemoryBarrier> transferBarriers(arena);
+    ArenaVector<vk::BufferMemoryBarrier> blockingBarriers(arena);
+
+    transferBarriers.reserve(pendingUpdates.size());
+    blockingBarriers.reserve(pendingUpdates.size());
+
+    for (const auto& [buffer, pendingUpdate] : pendingUpdates)
+    {
+        if (pendingUpdate.regions.empty())
+        {
+            continue;
+        }
+
+        waitedScope = waitedScope | pendingUpdate.waitedScope;
+        blockedScope = blockedScope | pendingUpdate.blockedScope;
+
+        transferBarriers.emplace_back(pendingUpdate.waitedScope.access, SyncScope::kTransferWrite.access,
+                VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, buffer, 0, VK_WHOLE_SIZE);
+
+        blockingBarriers.emplace_back(SyncScope::kTransferWrite.access, pendingUpdate.blockedScope.access,
+                VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, buffer, 0, VK_WHOLE_SIZE);
+    }
+
+    commandBuffer.pipelineBarrier(waitedScope.stages, SyncScope::kTransferWrite.stages,
+            vk::DependencyFlags(), {}, transferBarriers, {});
+
+    for (auto& [buffer, pendingUpdate] : pendingUpdates)
+    {
+        if (pendingUpdate.regions.empty())
+        {
+            continue;
+        }
+
+        Details::CoalesceRegions(pendingUpdate.regions);
+
+        commandBuffer.copyBuffer(buffers.at(buffer).stagingBuffer, buffer, pendingUpdate.regions);
+
+        for (const vk::BufferCopy& region : pendingUpdate.regions)
+        {
+            uploadedBytes += region.size;
+        }
+
+        copyRegionCount += static_cast<uint32_t>(pendingUpdate.regions.size());
+
+        pendingUpdate.regions.clear();
+        pendingUpdate.waitedScope = SyncScope::kWaitForNone;
+        pendingUpdate.blockedScope = SyncScope::kBlockNone;
+    }
+
+    commandBuffer.pipelineBarrier(SyncScope::kTransferWrite.stages, blockedScope.stages,
+            vk::DependencyFlags(), {}, blockingBarriers, {});
+
+    barrierCount += 2;
+
+    hasPendingUpdates = false;
+}
+
+BufferUpdateStats BufferManager::GetUpdateStats() const
+{
+    return BufferUpdateStats{ uploadedBytes, copyRegionCount, barrierCount };
 }
 
 void BufferManager::ReadBuffer(vk::CommandBuffer commandBuffer,
         vk::Buffer buffer, const BufferReader& reader) const
 {
-    const auto& [description, stagingBuffer] = buffers.at(buffer);
+    const auto& [description, stagingBuffer] = GetBufferEntry(buffer);
+
+    Assert(stagingBuffer);
 
     Assert(description.usage & vk::BufferUsageFlagBits::eTransferSrc);
 
@@ -111,16 +314,25 @@ void BufferManager::ReadBuffer(vk::CommandBuffer commandBuffer,
 
     commandBuffer.copyBuffer(buffer, stagingBuffer, { region });
 
-    const MemoryBlock memoryBlock = VulkanContext::memoryManager->GetBufferMemoryBlock(stagingBuffer);
-
-    reader(VulkanContext::memoryManager->MapMemory(memoryBlock));
-
-    VulkanContext::memoryManager->UnmapMemory(memoryBlock);
+    reader(VulkanContext::memoryManager->GetMappedMemory(stagingBuffer));
 }
 
 void BufferManager::DestroyBuffer(vk::Buffer buffer)
 {
-    const auto& [description, stagingBuffer] = buffers.at(buffer);
+    vk::Buffer stagingBuffer;
+
+    {
+        const std::unique_lock lock(buffersMutex);
+
+        const auto it = buffers.find(buffer);
+        Assert(it != buffers.end());
+
+        stagingBuffer = it->second.stagingBuffer;
+
+        buffers.erase(it);
+
+        pendingUpdates.erase(buffer);
+    }
 
     if (stagingBuffer)
     {
@@ -128,6 +340,45 @@ void BufferManager::DestroyBuffer(vk::Buffer buffer)
     }
 
     VulkanContext::memoryManager->DestroyBuffer(buffer);
+}
+
+BufferManager::BufferEntry BufferManager::GetBufferEntry(vk::Buffer buffer) const
+{
+    const std::unique_lock lock(buffersMutex);
+
+    return buffers.at(buffer);
+}
+
+vk::Buffer BufferManager::AcquireStagingBuffer(vk::DeviceSize size)
+{
+    const vk::DeviceSize poolSize = Details::GetStagingPoolSize(size);
+
+    {
+        const std::unique_lock lock(stagingPoolMutex);
+
+        const auto it = stagingPool.find(poolSize);
+
+        if (it != stagingPool.end())
+        {
+            const vk::Buffer stagingBuffer = it->second;
+
+            stagingPool.erase(it);
+
+            return stagingBuffer;
+        }
+    }
+
+    return BufferHelpers::CreateStagingBuffer(poolSize);
+}
+
+void BufferManager::ReleaseStagingBuffer(vk::Buffer stagingBuffer, vk::DeviceSize size)
+{
+    const vk::DeviceSize poolSize = Details::GetStagingPoolSize(size);
+
+    RenderContext::frameLoop->DestroyResource([this, stagingBuffer, poolSize]()
+        {
+            const std::unique_lock lock(stagingPoolMutex);
 
-    buffers.erase(buffers.find(buffer));
+            stagingPool.emplace(poolSize, stagingBuffer);
+        });
 }
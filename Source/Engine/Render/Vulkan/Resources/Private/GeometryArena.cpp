@@ -0,0 +1,575 @@
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
+
+#include "Engine/ConsoleVariable.hpp"
+#include "Engine/Render/RenderThread.hpp"
+#include "Engine/Render/Vulkan/Pipelines/GraphicsPipeline.hpp"
+#include "Engine/Render/Vulkan/Resources/ImageHelpers.hpp"
+#include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/Helpers.hpp"
+#include "Utils/Logger.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <bit>
+
+namespace Details
+{
+    static int vertexLayout = static_cast<int>(VertexLayout::eSeparate);
+    static CVarInt vertexLayoutCVar("r.VertexLayout", vertexLayout);
+
+    constexpr uint32_t kInitialIndexCapacity = 1 << 22;
+    constexpr uint32_t kInitialVertexCapacity = 1 << 20;
+
+    static const std::map<VertexLayout, std::string> kVertexLayoutNames{
+        { VertexLayout::eSeparate, "Separate" },
+        { VertexLayout::eInterleaved, "Interleaved" },
+        { VertexLayout::ePositionSplit, "PositionSplit" },
+        { VertexLayout::eCompressed, "Compressed" },
+    };
+
+    static std::vector<std::vector<VertexAttribute>> GetStreamAttributes(VertexLayout layout)
+    {
+        switch (layout)
+        {
+        case VertexLayout::eSeparate:
+            return {
+                { VertexAttribute::ePosition },
+                { VertexAttribute::eNormal },
+                { VertexAttribute::eTangent },
+                { VertexAttribute::eTexCoord }
+            };
+        case VertexLayout::eInterleaved:
+            return {
+                { VertexAttribute::ePosition, VertexAttribute::eNormal, VertexAttribute::eTangent, VertexAttribute::eTexCoord }
+            };
+        case VertexLayout::ePositionSplit:
+        case VertexLayout::eCompressed:
+            return {
+                { VertexAttribute::ePosition },
+                { VertexAttribute::eNormal, VertexAttribute::eTangent, VertexAttribute::eTexCoord }
+            };
+        default:
+            Assert(false);
+            return {};
+        }
+    }
+
+    static vk::Format GetAttributeFormat(VertexLayout layout, VertexAttribute attribute)
+    {
+        // Positions stay in float format for BLAS builds and position only passes
+        if (layout == VertexLayout::eCompressed)
+        {
+            switch (attribute)
+            {
+            case VertexAttribute::ePosition:
+                return vk::Format::eR32G32B32Sfloat;
+            case VertexAttribute::eNormal:
+            case VertexAttribute::eTangent:
+                return vk::Format::eR16G16Snorm;
+            case VertexAttribute::eTexCoord:
+                return vk::Format::eR16G16Sfloat;
+            default:
+                Assert(false);
+                return vk::Format::eUndefined;
+            }
+        }
+
+        if (attribute == VertexAttribute::eTexCoord)
+        {
+            return vk::Format::eR32G32Sfloat;
+        }
+
+        return vk::Format::eR32G32B32Sfloat;
+    }
+
+    static ByteView GetAttributeData(const GeometryData& data, VertexAttribute attribute)
+    {
+        switch (attribute)
+        {
+        case VertexAttribute::ePosition:
+            return data.positions.GetByteView();
+        case VertexAttribute::eNormal:
+            return data.normals.GetByteView();
+        case VertexAttribute::eTangent:
+            return data.tangents.GetByteView();
+        case VertexAttribute::eTexCoord:
+            return data.texCoords.GetByteView();
+        default:
+            Assert(false);
+            return {};
+        }
+    }
+
+    static glm::vec2 EncodeOctahedral(const glm::vec3& direction)
+    {
+        const glm::vec3 n = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+
+        if (n.z >= 0.0f)
+        {
+            return glm::vec2(n.x, n.y);
+        }
+
+        const glm::vec2 sign(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+
+        return (1.0f - glm::abs(glm::vec2(n.y, n.x))) * sign;
+    }
+
+    static void WriteAttribute(uint8_t* dst, const GeometryData& data,
+            VertexAttribute attribute, vk::Format format, size_t index)
+    {
+        const ByteView attributeData = GetAttributeData(data, attribute);
+
+        switch (format)
+        {
+        case vk::Format::eR32G32B32Sfloat:
+        case vk::Format::eR32G32Sfloat:
+        {
+            const uint32_t size = ImageHelpers::GetTexelSize(format);
+            std::memcpy(dst, attributeData.data + index * size, size);
+            break;
+        }
+        case vk::Format::eR16G16Snorm:
+        {
+            const glm::vec3 direction = attribute == VertexAttribute::eNormal
+                    ? data.normals[index] : data.tangents[index];
+
+            const uint32_t packed = glm::packSnorm2x16(EncodeOctahedral(direction));
+            std::memcpy(dst, &packed, sizeof(uint32_t));
+            break;
+        }
+        case vk::Format::eR16G16Sfloat:
+        {
+            const uint32_t packed = glm::packHalf2x16(data.texCoords[index]);
+            std::memcpy(dst, &packed, sizeof(uint32_t));
+            break;
+        }
+        default:
+            Assert(false);
+            break;
+        }
+    }
+
+    static bool IsRayTracingAllowed()
+    {
+        static const CVarBool& rayTracingAllowedCVar = CVarBool::Get("r.RayTracingAllowed");
+
+        return rayTracingAllowedCVar.GetValue();
+    }
+
+    static vk::Buffer CreateIndexBuffer(uint32_t capacity)
+    {
+        vk::BufferUsageFlags usage
+                = vk::BufferUsageFlagBits::eIndexBuffer
+                | vk::BufferUsageFlagBits::eStorageBuffer
+                | vk::BufferUsageFlagBits::eTransferSrc
+                | vk::BufferUsageFlagBits::eTransferDst;
+
+        // Index and position buffers are used as BLAS build inputs
+        if (IsRayTracingAllowed())
+        {
+            usage |= vk::BufferUsageFlagBits::eShaderDeviceAddress
+                    | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR;
+        }
+
+        return ResourceContext::CreateBuffer({
+            .size = capacity * sizeof(uint32_t),
+            .usage = usage
+        });
+    }
+
+    static vk::Buffer CreateVertexBuffer(vk::DeviceSize stride, bool containsPositions, uint32_t capacity)
+    {
+        vk::BufferUsageFlags usage
+                = vk::BufferUsageFlagBits::eVertexBuffer
+                | vk::BufferUsageFlagBits::eStorageBuffer
+                | vk::BufferUsageFlagBits::eTransferSrc
+                | vk::BufferUsageFlagBits::eTransferDst;
+
+        if (containsPositions && IsRayTracingAllowed())
+        {
+            usage |= vk::BufferUsageFlagBits::eShaderDeviceAddress
+                    | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR;
+        }
+
+        return ResourceContext::CreateBuffer({
+            .size = capacity * stride,
+            .usage = usage
+        });
+    }
+
+    static uint32_t GetGrownCapacity(const RangeAllocator& allocator, uint32_t size)
+    {
+        return std::max(allocator.GetCapacity() * 2, std::bit_ceil(allocator.GetUsedSize() + size));
+    }
+
+    // Pending uploads are submitted before one-time commands, so the old buffer content is complete
+    static vk::Buffer CopyBuffer(vk::Buffer oldBuffer, vk::Buffer newBuffer, vk::DeviceSize size)
+    {
+        VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
+            {
+                commandBuffer.copyBuffer(oldBuffer, newBuffer, { vk::BufferCopy(0, 0, size) });
+            });
+
+        return newBuffer;
+    }
+
+    // Snapshots extracted before the growth still bind the old buffer, so they are recorded first
+    static void DestroyReplacedBuffer(vk::Buffer oldBuffer)
+    {
+        RenderContext::renderThread->Flush();
+
+        ResourceContext::DestroyResourceSafe(oldBuffer);
+    }
+}
+
+VertexLayout GeometryArena::vertexLayout = VertexLayout::eSeparate;
+
+RangeAllocator GeometryArena::indexAllocator;
+RangeAllocator GeometryArena::vertexAllocator;
+
+vk::Buffer GeometryArena::indexBuffer;
+std::vector<GeometryArena::VertexStream> GeometryArena::vertexStreams;
+
+std::mutex GeometryArena::mutex;
+std::mutex GeometryArena::allocationMutex;
+
+void GeometryArena::Create()
+{
+    indexAllocator = RangeAllocator(Details::kInitialIndexCapacity);
+    vertexAllocator = RangeAllocator(Details::kInitialVertexCapacity);
+
+    Assert(Details::kVertexLayoutNames.contains(static_cast<VertexLayout>(Details::vertexLayout)));
+
+    vertexLayout = static_cast<VertexLayout>(Details::vertexLayout);
+
+    indexBuffer = Details::CreateIndexBuffer(Details::kInitialIndexCapacity);
+
+    uint32_t vertexSize = 0;
+
+    for (std::vector<VertexAttribute>& attributes : Details::GetStreamAttributes(vertexLayout))
+    {
+        VertexStream stream;
+        stream.attributes = std::move(attributes);
+
+        for (const VertexAttribute attribute : stream.attributes)
+        {
+            const vk::Format format = Details::GetAttributeFormat(vertexLayout, attribute);
+
+            stream.formats.push_back(format);
+            stream.stride += ImageHelpers::GetTexelSize(format);
+        }
+
+        const bool containsPositions = stream.attributes.front() == VertexAttribute::ePosition;
+
+        stream.buffer = Details::CreateVertexBuffer(stream.stride, containsPositions, Details::kInitialVertexCapacity);
+
+        vertexSize += stream.stride;
+
+        vertexStreams.push_back(std::move(stream));
+    }
+
+    Assert(vertexStreams.size() <= GeometryBuffers::kMaxStreamCount);
+
+    LogI << "Vertex layout: " << GetVertexLayoutName(vertexLayout) << ", "
+            << vertexSize << " bytes per vertex in " << vertexStreams.size() << " streams" << "\n";
+}
+
+void GeometryArena::Destroy()
+{
+    ResourceContext::DestroyResource(indexBuffer);
+
+    for (const VertexStream& stream : vertexStreams)
+    {
+        ResourceContext::DestroyResource(stream.buffer);
+    }
+
+    vertexStreams.clear();
+
+    indexAllocator = RangeAllocator();
+    vertexAllocator = RangeAllocator();
+}
+
+GeometryRange GeometryArena::Allocate(const GeometryData& data)
+{
+    Assert(data.indices.size > 0 && data.positions.size > 0);
+    Assert(data.normals.size == data.positions.size);
+    Assert(data.tangents.size == data.positions.size);
+    Assert(data.texCoords.size == data.positions.size);
+
+    const uint32_t indexCount = static_cast<uint32_t>(data.indices.size);
+    const uint32_t vertexCount = static_cast<uint32_t>(data.positions.size);
+
+    // Growth and uploads take queue and upload locks, so they are done outside the arena mutex
+    const std::unique_lock allocationLock(allocationMutex);
+
+    uint32_t firstIndex = RangeAllocator::kInvalidOffset;
+    uint32_t vertexOffset = RangeAllocator::kInvalidOffset;
+
+    {
+        const std::unique_lock lock(mutex);
+
+        firstIndex = indexAllocator.Allocate(indexCount);
+        vertexOffset = vertexAllocator.Allocate(vertexCount);
+    }
+
+    if (firstIndex == RangeAllocator::kInvalidOffset)
+    {
+        GrowIndexBuffer(indexCount);
+
+        const std::unique_lock lock(mutex);
+
+        firstIndex = indexAllocator.Allocate(indexCount);
+    }
+
+    if (vertexOffset == RangeAllocator::kInvalidOffset)
+    {
+        GrowVertexBuffers(vertexCount);
+
+        const std::unique_lock lock(mutex);
+
+        vertexOffset = vertexAllocator.Allocate(vertexCount);
+    }
+
+    Assert(firstIndex != RangeAllocator::kInvalidOffset);
+    Assert(vertexOffset != RangeAllocator::kInvalidOffset);
+
+    const GeometryBuffers buffers = GetBuffers();
+
+    ResourceContext::UploadBuffer(buffers.indexBuffer, data.indices.GetByteView(), firstIndex * sizeof(uint32_t));
+
+    for (size_t streamIndex = 0; streamIndex < vertexStreams.size(); ++streamIndex)
+    {
+        const VertexStream& stream = vertexStreams[streamIndex];
+        const vk::Buffer streamBuffer = buffers.vertexBuffers[streamIndex];
+
+        const vk::DeviceSize streamOffset = vertexOffset * stream.stride;
+
+        // Single attribute streams are float in all layouts and match the source data
+        if (stream.attributes.size() == 1)
+        {
+            ResourceContext::UploadBuffer(streamBuffer,
+                    Details::GetAttributeData(data, stream.attributes.front()), streamOffset);
+
+            continue;
+        }
+
+        Bytes streamData(vertexCount * stream.stride);
+
+        uint32_t attributeOffset = 0;
+
+        for (size_t i = 0; i < stream.attributes.size(); ++i)
+        {
+            for (uint32_t j = 0; j < vertexCount; ++j)
+            {
+                Details::WriteAttribute(streamData.data() + j * stream.stride + attributeOffset,
+                        data, stream.attributes[i], stream.formats[i], j);
+            }
+
+            attributeOffset += ImageHelpers::GetTexelSize(stream.formats[i]);
+        }
+
+        ResourceContext::UploadBuffer(streamBuffer, GetByteView(streamData), streamOffset);
+    }
+
+    return GeometryRange{ firstIndex, indexCount, vertexOffset, vertexCount };
+}
+
+void GeometryArena::Free(const GeometryRange& range)
+{
+    if (range.IsEmpty())
+    {
+        return;
+    }
+
+    RenderContext::frameLoop->DestroyResource([range]()
+        {
+            const std::unique_lock lock(mutex);
+
+            indexAllocator.Free(range.firstIndex, range.indexCount);
+            vertexAllocator.Free(range.vertexOffset, range.vertexCount);
+        });
+}
+
+vk::Buffer GeometryArena::GetIndexBuffer()
+{
+    const std::unique_lock lock(mutex);
+
+    return indexBuffer;
+}
+
+vk::Buffer GeometryArena::GetVertexBuffer(VertexAttribute attribute)
+{
+    const std::unique_lock lock(mutex);
+
+    return GetVertexStream(attribute).buffer;
+}
+
+uint32_t GeometryArena::GetVertexStride(VertexAttribute attribute)
+{
+    return GetVertexStream(attribute).stride;
+}
+
+VertexLayout GeometryArena::GetVertexLayout()
+{
+    return vertexLayout;
+}
+
+const std::string& GeometryArena::GetVertexLayoutName(VertexLayout layout)
+{
+    return Details::kVertexLayoutNames.at(layout);
+}
+
+std::vector<VertexInput> GeometryArena::GetVertexInputs()
+{
+    std::vector<VertexInput> vertexInputs;
+    vertexInputs.reserve(vertexStreams.size());
+
+    for (const VertexStream& stream : vertexStreams)
+    {
+        vertexInputs.push_back(VertexInput{ stream.formats, stream.stride, vk::VertexInputRate::eVertex });
+    }
+
+    return vertexInputs;
+}
+
+VertexInput GeometryArena::GetPositionVertexInput()
+{
+    const VertexStream& stream = vertexStreams.front();
+
+    return VertexInput{ { stream.formats.front() }, stream.stride, vk::VertexInputRate::eVertex };
+}
+
+GeometryStats GeometryArena::GetStats()
+{
+    const std::unique_lock lock(mutex);
+
+    GeometryStats stats;
+    stats.vertexLayout = vertexLayout;
+    stats.vertexStreamCount = static_cast<uint32_t>(vertexStreams.size());
+    stats.positionStride = vertexStreams.front().stride;
+    stats.vertexCount = vertexAllocator.GetUsedSize();
+    stats.indexCount = indexAllocator.GetUsedSize();
+
+    for (const VertexStream& stream : vertexStreams)
+    {
+        stats.vertexSize += stream.stride;
+    }
+
+    stats.vertexMemorySize = static_cast<uint64_t>(stats.vertexCount) * stats.vertexSize;
+    stats.indexMemorySize = static_cast<uint64_t>(stats.indexCount) * sizeof(uint32_t);
+
+    return stats;
+}
+
+GeometryBuffers GeometryArena::GetBuffers()
+{
+    const std::unique_lock lock(mutex);
+
+    GeometryBuffers buffers;
+    buffers.indexBuffer = indexBuffer;
+    buffers.vertexStreamCount = static_cast<uint32_t>(vertexStreams.size());
+
+    for (size_t i = 0; i < vertexStreams.size(); ++i)
+    {
+        buffers.vertexBuffers[i] = vertexStreams[i].buffer;
+    }
+
+    return buffers;
+}
+
+void GeometryArena::Bind(vk::CommandBuffer commandBuffer, const GeometryBuffers& buffers, bool positionsOnly)
+{
+    const uint32_t streamCount = positionsOnly ? 1 : buffers.vertexStreamCount;
+
+    const std::array<vk::DeviceSize, GeometryBuffers::kMaxStreamCount> offsets{};
+
+    commandBuffer.bindVertexBuffers(0, streamCount, buffers.vertexBuffers.data(), offsets.data());
+
+    commandBuffer.bindIndexBuffer(buffers.indexBuffer, 0, vk::IndexType::eUint32);
+}
+
+// Buffer handles are written only here under the allocation lock, so they are read without the arena mutex
+void GeometryArena::GrowIndexBuffer(uint32_t indexCount)
+{
+    uint32_t oldCapacity = 0;
+    uint32_t newCapacity = 0;
+
+    {
+        const std::unique_lock lock(mutex);
+
+        oldCapacity = indexAllocator.GetCapacity();
+        newCapacity = Details::GetGrownCapacity(indexAllocator, indexCount);
+    }
+
+    const vk::Buffer oldBuffer = indexBuffer;
+
+    const vk::Buffer newBuffer = Details::CopyBuffer(oldBuffer, Details::CreateIndexBuffer(newCapacity),
+            oldCapacity * sizeof(uint32_t));
+
+    {
+        const std::unique_lock lock(mutex);
+
+        indexBuffer = newBuffer;
+
+        indexAllocator.Grow(newCapacity);
+    }
+
+    Details::DestroyReplacedBuffer(oldBuffer);
+}
+
+void GeometryArena::GrowVertexBuffers(uint32_t vertexCount)
+{
+    uint32_t oldCapacity = 0;
+    uint32_t newCapacity = 0;
+
+    {
+        const std::unique_lock lock(mutex);
+
+        oldCapacity = vertexAllocator.GetCapacity();
+        newCapacity = Details::GetGrownCapacity(vertexAllocator, vertexCount);
+    }
+
+    std::vector<vk::Buffer> newBuffers;
+    newBuffers.reserve(vertexStreams.size());
+
+    for (const VertexStream& stream : vertexStreams)
+    {
+        const bool containsPositions = stream.attributes.front() == VertexAttribute::ePosition;
+
+        newBuffers.push_back(Details::CopyBuffer(stream.buffer,
+                Details::CreateVertexBuffer(stream.stride, containsPositions, newCapacity),
+                oldCapacity * stream.stride));
+    }
+
+    std::vector<vk::Buffer> oldBuffers(newBuffers.size());
+
+    {
+        const std::unique_lock lock(mutex);
+
+        for (size_t i = 0; i < vertexStreams.size(); ++i)
+        {
+            oldBuffers[i] = std::exchange(vertexStreams[i].buffer, newBuffers[i]);
+        }
+
+        vertexAllocator.Grow(newCapacity);
+    }
+
+    for (const vk::Buffer oldBuffer : oldBuffers)
+    {
+        Details::DestroyReplacedBuffer(oldBuffer);
+    }
+}
+
+const GeometryArena::VertexStream& GeometryArena::GetVertexStream(VertexAttribute attribute)
+{
+    const auto it = std::ranges::find_if(vertexStreams, [&](const VertexStream& stream)
+        {
+            return std::ranges::find(stream.attributes, attribute) != stream.attributes.end();
+        });
+
+    Assert(it != vertexStreams.end());
+
+    return *it;
+}
@@ -193,9 +193,7 @@ void ImageManager::UpdateImage(vk::CommandBuffer commandBuffer,
     std::vector<vk::BufferImageCopy> copyRegions;
     copyRegions.reserve(updateRegions.size());
 
-    MemoryBlock memoryBlock = VulkanContext::memoryManager->GetBufferMemoryBlock(stagingBuffer);
-
-    const vk::DeviceSize stagingBufferSize = memoryBlock.size;
+    const ByteAccess stagingMemory = VulkanContext::memoryManager->GetMappedMemory(stagingBuffer);
 
     vk::DeviceSize stagingBufferOffset = 0;
 
@@ -205,17 +203,13 @@ void ImageManager::UpdateImage(vk::CommandBuffer commandBuffer,
                 updateRegion.layers.layerCount, description.format);
 
         Assert(updateRegion.data.size == dataSize);
-        Assert(stagingBufferOffset + updateRegion.data.size <= stagingBufferSize);
-
-        memoryBlock.size = updateRegion.data.size;
+        Assert(stagingBufferOffset + updateRegion.data.size <= stagingMemory.size);
 
-        updateRegion.data.CopyTo(VulkanContext::memoryManager->MapMemory(memoryBlock));
-        VulkanContext::memoryManager->UnmapMemory(memoryBlock);
+        updateRegion.data.CopyTo(ByteAccess(stagingMemory.data + stagingBufferOffset, updateRegion.data.size));
 
         copyRegions.emplace_back(stagingBufferOffset, 0, 0,
                 updateRegion.layers, updateRegion.offset, updateRegion.extent);
 
-        memoryBlock.offset += updateRegion.data.size;
         stagingBufferOffset += updateRegion.data.size;
     }
 
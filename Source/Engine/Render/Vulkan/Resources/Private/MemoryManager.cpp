@@ -6,9 +6,11 @@
 
 namespace Details
 {
-    static VmaAllocationCreateInfo GetAllocationCreateInfo(vk::MemoryPropertyFlags memoryProperties)
+    static VmaAllocationCreateInfo GetAllocationCreateInfo(vk::MemoryPropertyFlags memoryProperties,
+            VmaAllocationCreateFlags flags = 0)
     {
         VmaAllocationCreateInfo allocationCreateInfo = {};
+        allocationCreateInfo.flags = flags;
         allocationCreateInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(memoryProperties);
 
         return allocationCreateInfo;
@@ -74,6 +76,29 @@ vk::Buffer MemoryManager::CreateBuffer(const vk::BufferCreateInfo& createInfo,
 
     bufferAllocations.emplace(buffer, allocation);
 
+    hostVisibleBufferMemorySize += GetHostVisibleSize(allocation);
+
+    return buffer;
+}
+
+vk::Buffer MemoryManager::CreateMappedBuffer(const vk::BufferCreateInfo& createInfo,
+        vk::MemoryPropertyFlags memoryProperties)
+{
+    const VmaAllocationCreateInfo allocationCreateInfo = Details::GetAllocationCreateInfo(memoryProperties,
+            VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+    VkBuffer buffer;
+    VmaAllocation allocation;
+
+    const VkResult result = vmaCreateBuffer(allocator, &createInfo.operator VkBufferCreateInfo const&(),
+            &allocationCreateInfo, &buffer, &allocation, nullptr);
+
+    Assert(result == VK_SUCCESS);
+
+    bufferAllocations.emplace(buffer, allocation);
+
+    hostVisibleBufferMemorySize += GetHostVisibleSize(allocation);
+
     return buffer;
 }
 
@@ -100,6 +125,8 @@ void MemoryManager::DestroyBuffer(vk::Buffer buffer)
     const auto it = bufferAllocations.find(buffer);
     Assert(it != bufferAllocations.end());
 
+    hostVisibleBufferMemorySize -= GetHostVisibleSize(it->second);
+
     vmaDestroyBuffer(allocator, buffer, it->second);
 
     bufferAllocations.erase(it);
@@ -130,6 +157,19 @@ MemoryBlock MemoryManager::GetAccelerationStructureMemoryBlock(vk::AccelerationS
     return GetMemoryBlock(accelerationStructure, accelerationStructureAllocations);
 }
 
+ByteAccess MemoryManager::GetMappedMemory(vk::Buffer buffer) const
+{
+    const auto it = bufferAllocations.find(buffer);
+    Assert(it != bufferAllocations.end());
+
+    VmaAllocationInfo allocationInfo;
+    vmaGetAllocationInfo(allocator, it->second, &allocationInfo);
+
+    Assert(allocationInfo.pMappedData);
+
+    return ByteAccess(static_cast<uint8_t*>(allocationInfo.pMappedData), static_cast<size_t>(allocationInfo.size));
+}
+
 ByteAccess MemoryManager::MapMemory(const MemoryBlock& memoryBlock) const
 {
     void* mappedMemory = nullptr;
@@ -156,3 +196,14 @@ void MemoryManager::FreeMemory(const MemoryBlock& memoryBlock)
 
     memoryAllocations.erase(it);
 }
+
+vk::DeviceSize MemoryManager::GetHostVisibleSize(VmaAllocation allocation) const
+{
+    VmaAllocationInfo allocationInfo;
+    vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+
+    VkMemoryPropertyFlags memoryProperties;
+    vmaGetMemoryTypeProperties(allocator, allocationInfo.memoryType, &memoryProperties);
+
+    return memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ? allocationInfo.size : 0;
+}
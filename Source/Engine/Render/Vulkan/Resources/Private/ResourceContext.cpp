@@ -1,20 +1,28 @@
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
+
 std::unique_ptr<ImageManager> ResourceContext::imageManager;
 std::unique_ptr<BufferManager> ResourceContext::bufferManager;
 std::unique_ptr<AccelerationStructureManager> ResourceContext::accelerationStructureManager;
+std::unique_ptr<UploadManager> ResourceContext::uploadManager;
 
 void ResourceContext::Create()
 {
     imageManager = std::make_unique<ImageManager>();
     bufferManager = std::make_unique<BufferManager>();
     accelerationStructureManager = std::make_unique<AccelerationStructureManager>();
+    uploadManager = std::make_unique<UploadManager>();
 
     TextureCache::Create();
+    GeometryArena::Create();
 }
 
 void ResourceContext::Destroy()
 {
+    uploadManager.reset();
+
+    GeometryArena::Destroy();
     TextureCache::Destroy();
 
     imageManager.reset();
@@ -27,7 +35,7 @@ const ImageDescription& ResourceContext::GetImageDescription(vk::Image image)
     return imageManager->GetImageDescription(image);
 }
 
-const BufferDescription& ResourceContext::GetBufferDescription(vk::Buffer buffer)
+BufferDescription ResourceContext::GetBufferDescription(vk::Buffer buffer)
 {
     return bufferManager->GetBufferDescription(buffer);
 }
@@ -62,9 +70,10 @@ vk::Buffer ResourceContext::CreateBuffer(const BufferDescription& description)
     return bufferManager->CreateBuffer(description);
 }
 
-vk::AccelerationStructureKHR ResourceContext::GenerateBlas(const BlasGeometryData& data)
+std::vector<vk::AccelerationStructureKHR> ResourceContext::GenerateBlases(
+        const std::vector<BlasGeometryData>& geometries)
 {
-    return accelerationStructureManager->GenerateBlas(data);
+    return accelerationStructureManager->GenerateBlases(geometries);
 }
 
 vk::AccelerationStructureKHR ResourceContext::CreateTlas(uint32_t instanceCount)
@@ -84,6 +93,21 @@ void ResourceContext::UpdateBuffer(vk::CommandBuffer commandBuffer,
     bufferManager->UpdateBuffer(commandBuffer, buffer, update);
 }
 
+void ResourceContext::EnqueueBufferUpdate(vk::Buffer buffer, const BufferUpdate& update)
+{
+    bufferManager->EnqueueBufferUpdate(buffer, update);
+}
+
+void ResourceContext::FlushBufferUpdates(vk::CommandBuffer commandBuffer)
+{
+    bufferManager->FlushBufferUpdates(commandBuffer);
+}
+
+BufferUpdateStats ResourceContext::GetBufferUpdateStats()
+{
+    return bufferManager->GetUpdateStats();
+}
+
 void ResourceContext::ReadBuffer(vk::CommandBuffer commandBuffer,
         vk::Buffer buffer, const BufferReader& reader)
 {
@@ -91,7 +115,32 @@ void ResourceContext::ReadBuffer(vk::CommandBuffer commandBuffer,
 }
 
 void ResourceContext::BuildTlas(vk::CommandBuffer commandBuffer,
-        vk::AccelerationStructureKHR tlas, const TlasInstances& instances)
+        vk::AccelerationStructureKHR tlas, const TlasBuildInfo& buildInfo)
+{
+    accelerationStructureManager->BuildTlas(commandBuffer, tlas, buildInfo);
+}
+
+UploadToken ResourceContext::Upload(const ByteView& data, const UploadCommands& commands)
+{
+    return uploadManager->Upload(data, commands);
+}
+
+UploadToken ResourceContext::UploadBuffer(vk::Buffer buffer, const ByteView& data, vk::DeviceSize offset)
+{
+    return uploadManager->UploadBuffer(buffer, data, offset);
+}
+
+UploadToken ResourceContext::SubmitUploads()
+{
+    return uploadManager->Submit();
+}
+
+void ResourceContext::WaitForUploads(UploadToken token)
+{
+    uploadManager->Wait(token);
+}
+
+UploadStats ResourceContext::GetUploadStats()
 {
-    accelerationStructureManager->BuildTlas(commandBuffer, tlas, instances);
+    return uploadManager->GetStats();
 }
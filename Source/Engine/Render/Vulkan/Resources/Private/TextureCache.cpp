@@ -46,15 +46,9 @@ namespace Details
     static constexpr std::array<Color, 2> kCheckeredTextureColors{ Color(255, 255, 255), Color(0, 0, 0) };
 
     static void UpdateImage(vk::CommandBuffer commandBuffer, vk::Image image,
-            const ImageDescription& description, const ByteView& data)
+            const ImageDescription& description, const StagingRange& stagingRange)
     {
-        Assert(data.size == ImageHelpers::CalculateMipLevelSize(description, 0));
-
-        const ImageUpdateRegion2D imageUpdateRegion{
-            .layers = ImageHelpers::GetSubresourceLayers(description, 0),
-            .extent = description.extent,
-            .data = data,
-        };
+        Assert(stagingRange.size == ImageHelpers::CalculateMipLevelSize(description, 0));
 
         const ImageLayoutTransition layoutTransition{
             vk::ImageLayout::eUndefined,
@@ -68,7 +62,12 @@ namespace Details
         ImageHelpers::TransitImageLayout(commandBuffer, image,
                 ImageHelpers::GetSubresourceRange(description), layoutTransition);
 
-        ResourceContext::UpdateImage(commandBuffer, image, { imageUpdateRegion });
+        const vk::BufferImageCopy region(stagingRange.offset, 0, 0,
+                ImageHelpers::GetSubresourceLayers(description, 0),
+                vk::Offset3D(), VulkanHelpers::GetExtent3D(description.extent));
+
+        commandBuffer.copyBufferToImage(stagingRange.buffer, image,
+                vk::ImageLayout::eTransferDstOptimal, { region });
     }
 
     static BaseImage CreateTextureImage(const ImageSourceView& source)
@@ -80,14 +79,14 @@ namespace Details
             .extent = source.extent,
             .mipLevelCount = mipLevelCount,
             .usage = Details::kTextureUsage,
-            .stagingBuffer = true,
         };
 
         const BaseImage baseImage = ResourceContext::CreateBaseImage(description);
 
-        VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
+        // Texture is ready once the batch is submitted, commands using it are submitted after it
+        ResourceContext::Upload(source.data, [&](vk::CommandBuffer commandBuffer, const StagingRange& stagingRange)
             {
-                Details::UpdateImage(commandBuffer, baseImage.image, description, source.data);
+                Details::UpdateImage(commandBuffer, baseImage.image, description, stagingRange);
 
                 if (description.mipLevelCount > 1)
                 {
@@ -425,3 +424,41 @@ void TextureCache::DestroyUnusedTextures()
         }
     }
 }
+
+std::optional<Filepath> TextureCache::FindTexturePath(const BaseImage& image)
+{
+    const auto pred = [&](const std::pair<Filepath, TextureEntry>& pair)
+        {
+            return pair.second.image.image == image.image;
+        };
+
+    const auto it = std::ranges::find_if(textureCache, pred);
+
+    if (it != textureCache.end())
+    {
+        return it->first;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<SamplerDescription> TextureCache::FindSamplerDescription(vk::Sampler sampler)
+{
+    for (const auto& [description, cachedSampler] : samplerCache)
+    {
+        if (cachedSampler == sampler)
+        {
+            return description;
+        }
+    }
+
+    for (const auto& [key, defaultSampler] : defaultSamplers)
+    {
+        if (defaultSampler == sampler)
+        {
+            return Details::kSamplerDescriptions.at(key);
+        }
+    }
+
+    return std::nullopt;
+}
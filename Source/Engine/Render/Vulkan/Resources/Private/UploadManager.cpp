@@ -0,0 +1,282 @@
+#include "Engine/Render/Vulkan/Resources/UploadManager.hpp"
+
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Resources/BufferHelpers.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/Helpers.hpp"
+#include "Utils/TimeHelpers.hpp"
+
+namespace Details
+{
+    constexpr vk::DeviceSize kRingSize = 64 * Metric::kMegabyte;
+
+    // Satisfies buffer to image copy offset requirements of supported texel sizes
+    constexpr vk::DeviceSize kStagingAlignment = 16;
+
+    static vk::DeviceSize Align(vk::DeviceSize offset, vk::DeviceSize alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+}
+
+UploadManager::UploadManager()
+{
+    ringBuffer = BufferHelpers::CreateStagingBuffer(Details::kRingSize);
+    ringMemory = VulkanContext::memoryManager->GetMappedMemory(ringBuffer);
+
+    VulkanContext::device->SetPendingWorkSubmitter([this]()
+        {
+            Submit();
+        });
+}
+
+UploadManager::~UploadManager()
+{
+    VulkanContext::device->SetPendingWorkSubmitter(nullptr);
+
+    Wait(Submit());
+
+    // Command buffers are freed together with command pool
+    for (const Batch& batch : freeBatches)
+    {
+        VulkanContext::device->Get().destroyFence(batch.fence);
+    }
+
+    VulkanContext::memoryManager->DestroyBuffer(ringBuffer);
+}
+
+UploadToken UploadManager::Upload(const ByteView& data, const UploadCommands& commands)
+{
+    Assert(data.size > 0);
+
+    const std::unique_lock lock(mutex);
+
+    Timer timer;
+    timer.Tick();
+
+    StagingRange stagingRange;
+
+    if (data.size > Details::kRingSize)
+    {
+        // Data exceeding the ring gets temporary staging buffer released together with the batch
+        const vk::Buffer stagingBuffer = BufferHelpers::CreateStagingBuffer(data.size);
+
+        data.CopyTo(VulkanContext::memoryManager->GetMappedMemory(stagingBuffer));
+
+        GetPendingBatch().dedicatedBuffers.push_back(stagingBuffer);
+
+        stagingRange = StagingRange{ stagingBuffer, 0, data.size };
+    }
+    else
+    {
+        stagingRange = AllocateRingRange(data.size);
+
+        data.CopyTo(ByteAccess(ringMemory.data + stagingRange.offset, data.size));
+    }
+
+    Batch& batch = GetPendingBatch();
+
+    commands(batch.commandBuffer, stagingRange);
+
+    batch.ringEnd = ringHead;
+
+    stats.uploadedBytes += data.size;
+    stats.seconds += timer.Tick();
+
+    return batch.token;
+}
+
+UploadToken UploadManager::UploadBuffer(vk::Buffer buffer, const ByteView& data, vk::DeviceSize offset)
+{
+    return Upload(data, [&](vk::CommandBuffer commandBuffer, const StagingRange& stagingRange)
+        {
+            const vk::BufferCopy region(stagingRange.offset, offset, stagingRange.size);
+
+            commandBuffer.copyBuffer(stagingRange.buffer, buffer, { region });
+        });
+}
+
+UploadToken UploadManager::Submit()
+{
+    const std::unique_lock lock(mutex);
+
+    if (pendingBatch.has_value())
+    {
+        SubmitPendingBatch();
+    }
+
+    return lastToken;
+}
+
+bool UploadManager::IsCompleted(UploadToken token)
+{
+    const std::unique_lock lock(mutex);
+
+    RetireBatches(token, false);
+
+    return token <= completedToken;
+}
+
+void UploadManager::Wait(UploadToken token)
+{
+    const std::unique_lock lock(mutex);
+
+    Timer timer;
+    timer.Tick();
+
+    if (pendingBatch.has_value() && pendingBatch->token <= token)
+    {
+        SubmitPendingBatch();
+    }
+
+    RetireBatches(token, true);
+
+    stats.seconds += timer.Tick();
+}
+
+UploadStats UploadManager::GetStats() const
+{
+    const std::unique_lock lock(mutex);
+
+    return stats;
+}
+
+UploadManager::Batch& UploadManager::GetPendingBatch()
+{
+    if (!pendingBatch.has_value())
+    {
+        if (freeBatches.empty())
+        {
+            Batch batch;
+            batch.commandBuffer = VulkanContext::device->AllocateCommandBuffer(CommandBufferType::eUpload);
+            batch.fence = VulkanHelpers::CreateFence(VulkanContext::device->Get(), vk::FenceCreateFlags());
+
+            freeBatches.push_back(std::move(batch));
+        }
+
+        pendingBatch = std::move(freeBatches.back());
+        freeBatches.pop_back();
+
+        pendingBatch->token = ++lastToken;
+        pendingBatch->ringEnd = ringHead;
+
+        const vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+        const vk::Result result = pendingBatch->commandBuffer.begin(beginInfo);
+        Assert(result == vk::Result::eSuccess);
+    }
+
+    return pendingBatch.value();
+}
+
+StagingRange UploadManager::AllocateRingRange(vk::DeviceSize size)
+{
+    const vk::DeviceSize alignedSize = Details::Align(size, Details::kStagingAlignment);
+
+    while (true)
+    {
+        if (ringTail == ringHead && !pendingBatch.has_value() && submittedBatches.empty())
+        {
+            // Nothing references the ring, restarting from the beginning avoids wrapping
+            ringHead = 0;
+            ringTail = 0;
+        }
+
+        const uint64_t offset = ringHead % Details::kRingSize;
+
+        const uint64_t start = offset + alignedSize > Details::kRingSize
+                ? ringHead + Details::kRingSize - offset : ringHead;
+
+        if (start + alignedSize <= ringTail + Details::kRingSize)
+        {
+            ringHead = start + alignedSize;
+
+            return StagingRange{ ringBuffer, start % Details::kRingSize, size };
+        }
+
+        // Ring is full, the oldest batch has to complete before its range is reused
+        if (submittedBatches.empty())
+        {
+            SubmitPendingBatch();
+        }
+
+        Assert(!submittedBatches.empty());
+
+        RetireBatches(submittedBatches.front().token, true);
+    }
+}
+
+void UploadManager::SubmitPendingBatch()
+{
+    Assert(pendingBatch.has_value());
+
+    Batch& batch = pendingBatch.value();
+
+    // Uploaded data is made visible to all commands submitted after the batch
+    VulkanHelpers::InsertMemoryBarrier(batch.commandBuffer, PipelineBarrier{
+        SyncScope::kTransferWrite,
+        SyncScope::kBlockAll
+    });
+
+    vk::Result result = batch.commandBuffer.end();
+    Assert(result == vk::Result::eSuccess);
+
+    const std::vector<vk::CommandBuffer> commandBuffers{ batch.commandBuffer };
+
+    vk::SubmitInfo submitInfo;
+    submitInfo.setCommandBuffers(commandBuffers);
+
+    {
+        const std::unique_lock lock = VulkanContext::device->LockQueues();
+
+        result = VulkanContext::device->GetQueues().graphics.submit({ submitInfo }, batch.fence);
+        Assert(result == vk::Result::eSuccess);
+    }
+
+    ++stats.submitCount;
+
+    submittedBatches.push_back(std::move(batch));
+
+    pendingBatch.reset();
+}
+
+void UploadManager::RetireBatches(UploadToken token, bool wait)
+{
+    const vk::Device device = VulkanContext::device->Get();
+
+    while (!submittedBatches.empty() && submittedBatches.front().token <= token)
+    {
+        Batch& batch = submittedBatches.front();
+
+        if (wait)
+        {
+            VulkanHelpers::WaitForFences(device, { batch.fence });
+        }
+        else if (device.getFenceStatus(batch.fence) != vk::Result::eSuccess)
+        {
+            break;
+        }
+
+        for (const vk::Buffer buffer : batch.dedicatedBuffers)
+        {
+            VulkanContext::memoryManager->DestroyBuffer(buffer);
+        }
+
+        batch.dedicatedBuffers.clear();
+
+        vk::Result result = batch.commandBuffer.reset(vk::CommandBufferResetFlags());
+        Assert(result == vk::Result::eSuccess);
+
+        result = device.resetFences({ batch.fence });
+        Assert(result == vk::Result::eSuccess);
+
+        ringTail = batch.ringEnd;
+        completedToken = batch.token;
+
+        freeBatches.push_back(std::move(batch));
+
+        submittedBatches.pop_front();
+    }
+}
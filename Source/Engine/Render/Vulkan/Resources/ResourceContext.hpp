@@ -6,6 +6,7 @@
 #include "Engine/Render/Vulkan/Resources/ImageManager.hpp"
 #include "Engine/Render/Vulkan/Resources/BufferManager.hpp"
 #include "Engine/Render/Vulkan/Resources/AccelerationStructureManager.hpp"
+#include "Engine/Render/Vulkan/Resources/UploadManager.hpp"
 
 class ResourceContext
 {
@@ -15,7 +16,7 @@ public:
 
     static const ImageDescription& GetImageDescription(vk::Image image);
 
-    static const BufferDescription& GetBufferDescription(vk::Buffer buffer);
+    static BufferDescription GetBufferDescription(vk::Buffer buffer);
 
     static vk::Image CreateImage(const ImageDescription& description);
 
@@ -29,7 +30,7 @@ public:
 
     static vk::Buffer CreateBuffer(const BufferDescription& description);
 
-    static vk::AccelerationStructureKHR GenerateBlas(const BlasGeometryData& data);
+    static std::vector<vk::AccelerationStructureKHR> GenerateBlases(const std::vector<BlasGeometryData>& geometries);
 
     static vk::AccelerationStructureKHR CreateTlas(uint32_t instanceCount);
 
@@ -39,11 +40,27 @@ public:
     static void UpdateBuffer(vk::CommandBuffer commandBuffer,
             vk::Buffer buffer, const BufferUpdate& update);
 
+    static void EnqueueBufferUpdate(vk::Buffer buffer, const BufferUpdate& update);
+
+    static void FlushBufferUpdates(vk::CommandBuffer commandBuffer);
+
+    static BufferUpdateStats GetBufferUpdateStats();
+
     static void ReadBuffer(vk::CommandBuffer commandBuffer,
             vk::Buffer buffer, const BufferReader& reader);
 
     static void BuildTlas(vk::CommandBuffer commandBuffer,
-            vk::AccelerationStructureKHR tlas, const TlasInstances& instances);
+            vk::AccelerationStructureKHR tlas, const TlasBuildInfo& buildInfo);
+
+    static UploadToken Upload(const ByteView& data, const UploadCommands& commands);
+
+    static UploadToken UploadBuffer(vk::Buffer buffer, const ByteView& data, vk::DeviceSize offset = 0);
+
+    static UploadToken SubmitUploads();
+
+    static void WaitForUploads(UploadToken token);
+
+    static UploadStats GetUploadStats();
 
     template <class T>
     static void DestroyResource(T resource)
@@ -95,4 +112,5 @@ private:
     static std::unique_ptr<ImageManager> imageManager;
     static std::unique_ptr<BufferManager> bufferManager;
     static std::unique_ptr<AccelerationStructureManager> accelerationStructureManager;
+    static std::unique_ptr<UploadManager> uploadManager;
 };
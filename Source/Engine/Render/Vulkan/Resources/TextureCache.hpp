@@ -32,6 +32,10 @@ public:
 
     static void DestroyUnusedTextures();
 
+    static std::optional<Filepath> FindTexturePath(const BaseImage& image);
+
+    static std::optional<SamplerDescription> FindSamplerDescription(vk::Sampler sampler);
+
 private:
     struct TextureEntry
     {
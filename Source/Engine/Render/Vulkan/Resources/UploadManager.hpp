@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Engine/Render/Vulkan/VulkanHelpers.hpp"
+
+#include "Utils/DataHelpers.hpp"
+
+#include <deque>
+#include <mutex>
+
+// Identifies the batch an upload was recorded into, tokens of later batches are greater
+using UploadToken = uint64_t;
+
+struct StagingRange
+{
+    vk::Buffer buffer;
+    vk::DeviceSize offset;
+    vk::DeviceSize size;
+};
+
+using UploadCommands = std::function<void(vk::CommandBuffer, const StagingRange&)>;
+
+struct UploadStats
+{
+    uint64_t uploadedBytes = 0;
+    uint32_t submitCount = 0;
+    // CPU time spent on staging data and waiting for batches
+    float seconds = 0.0f;
+};
+
+// Uploads are staged in a persistently mapped ring and recorded into a shared command buffer,
+// the batch is submitted when the ring runs out of space, before one-time commands or on demand
+class UploadManager
+{
+public:
+    UploadManager();
+    ~UploadManager();
+
+    // Data is copied to staging memory immediately, commands are recorded into the pending batch
+    UploadToken Upload(const ByteView& data, const UploadCommands& commands);
+
+    UploadToken UploadBuffer(vk::Buffer buffer, const ByteView& data, vk::DeviceSize offset = 0);
+
+    // Returns token of the last submitted batch
+    UploadToken Submit();
+
+    bool IsCompleted(UploadToken token);
+
+    void Wait(UploadToken token);
+
+    UploadStats GetStats() const;
+
+private:
+    struct Batch
+    {
+        UploadToken token = 0;
+        vk::CommandBuffer commandBuffer;
+        vk::Fence fence;
+        uint64_t ringEnd = 0;
+        std::vector<vk::Buffer> dedicatedBuffers;
+    };
+
+    vk::Buffer ringBuffer;
+    ByteAccess ringMemory;
+
+    // Monotonic positions, wrapped by ring size on access
+    uint64_t ringHead = 0;
+    uint64_t ringTail = 0;
+
+    std::optional<Batch> pendingBatch;
+    std::deque<Batch> submittedBatches;
+    std::vector<Batch> freeBatches;
+
+    UploadToken lastToken = 0;
+    UploadToken completedToken = 0;
+
+    UploadStats stats;
+
+    mutable std::mutex mutex;
+
+    Batch& GetPendingBatch();
+
+    StagingRange AllocateRingRange(vk::DeviceSize size);
+
+    void SubmitPendingBatch();
+
+    void RetireBatches(UploadToken token, bool wait);
+};
@@ -3,6 +3,8 @@
 struct DeviceFeatures
 {
     uint32_t samplerAnisotropy : 1;
+    uint32_t multiDrawIndirect : 1;
+    uint32_t drawIndirectFirstInstance : 1;
     uint32_t accelerationStructure : 1;
     uint32_t rayTracingPipeline : 1;
     uint32_t descriptorIndexing : 1;
@@ -29,6 +31,8 @@ namespace VulkanConfig
 
     constexpr DeviceFeatures kRequiredDeviceFeatures{
         .samplerAnisotropy = true,
+        .multiDrawIndirect = true,
+        .drawIndirectFirstInstance = true,
         .accelerationStructure = true,
         .rayTracingPipeline = true,
         .descriptorIndexing = true,
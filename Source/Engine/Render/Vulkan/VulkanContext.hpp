@@ -5,6 +5,7 @@
 #include "Engine/Render/Vulkan/Surface.hpp"
 #include "Engine/Render/Vulkan/Swapchain.hpp"
 #include "Engine/Render/Vulkan/Shaders/ShaderManager.hpp"
+#include "Engine/Render/Vulkan/Pipelines/PipelineCache.hpp"
 #include "Engine/Render/Vulkan/Resources/DescriptorManager.hpp"
 #include "Engine/Render/Vulkan/Resources/MemoryManager.hpp"
 #include "Engine/Render/Vulkan/Resources/TextureCache.hpp"
@@ -26,5 +27,6 @@ public:
 
     static std::unique_ptr<DescriptorManager> descriptorManager;
     static std::unique_ptr<ShaderManager> shaderManager;
+    static std::unique_ptr<PipelineCache> pipelineCache;
     static std::unique_ptr<MemoryManager> memoryManager;
 };
@@ -15,10 +15,12 @@ struct SyncScope
     static const SyncScope kTransferRead;
     static const SyncScope kVerticesRead;
     static const SyncScope kIndicesRead;
+    static const SyncScope kIndirectCommandRead;
     static const SyncScope kAccelerationStructureWrite;
     static const SyncScope kAccelerationStructureRead;
     static const SyncScope kAccelerationStructureShaderRead;
     static const SyncScope kRayTracingAccelerationStructureRead;
+    static const SyncScope kShaderAccelerationStructureRead;
     static const SyncScope kRayTracingShaderWrite;
     static const SyncScope kRayTracingShaderRead;
     static const SyncScope kRayTracingUniformRead;
@@ -59,7 +61,9 @@ using RenderCommands = std::function<void(vk::CommandBuffer, uint32_t)>;
 enum class CommandBufferType
 {
     eOneTime,
-    eLongLived
+    eLongLived,
+    eAsyncCompute,
+    eUpload
 };
 
 struct CommandBufferSync
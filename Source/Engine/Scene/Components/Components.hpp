@@ -10,25 +10,28 @@
 struct Texture;
 
 // TODO move to separate file
+// Intrusive first-child/next-sibling links, Scene keeps the storage sorted depth-first
 class HierarchyComponent
 {
 public:
-    HierarchyComponent(Scene& scene_, entt::entity self_, entt::entity parent_);
-
     entt::entity GetParent() const { return parent; }
 
-    const std::vector<entt::entity>& GetChildren() const { return children; }
-
-    void SetParent(entt::entity parent_);
+    entt::entity GetFirstChild() const { return firstChild; }
 
-private:
-    Scene& scene;
+    entt::entity GetNextSibling() const { return nextSibling; }
 
-    const entt::entity self;
+    bool HasChildren() const { return firstChild != entt::null; }
 
+private:
     entt::entity parent = entt::null;
+    entt::entity firstChild = entt::null;
+    entt::entity lastChild = entt::null;
+    entt::entity prevSibling = entt::null;
+    entt::entity nextSibling = entt::null;
 
-    std::vector<entt::entity> children;
+    uint32_t order = 0;
+
+    friend class Scene;
 };
 
 // TODO move to separate file
@@ -61,11 +64,33 @@ private:
     mutable bool modified = true;
 };
 
+struct RenderObject
+{
+    PrimitiveHandle primitive;
+    MaterialHandle material;
+};
+
+struct RenderComponent
+{
+    std::vector<RenderObject> renderObjects;
+};
+
+struct PrefabRenderNode
+{
+    glm::mat4 transform;
+    RenderObject renderObject;
+};
+
 struct ScenePrefabComponent
 {
-    StorageRange storageRange;
+    StorageHandles storageHandles;
     std::unique_ptr<Scene> hierarchy;
     std::vector<entt::entity> instances;
+
+    // Render objects of the immutable hierarchy in prefab space, shared instances are expanded from them
+    std::vector<PrefabRenderNode> renderNodes;
+    AABBox bbox;
+    std::vector<entt::entity> sharedInstances;
 };
 
 struct SceneInstanceComponent
@@ -73,20 +98,16 @@ struct SceneInstanceComponent
     entt::entity prefab = entt::null;
 };
 
-struct NameComponent
+// References prefab hierarchy instead of copying it, entity transform is used as instance root
+struct SharedInstanceComponent
 {
-    std::string name;
-};
-
-struct RenderObject
-{
-    uint32_t primitive = 0;
-    uint32_t material = 0;
+    entt::entity prefab = entt::null;
+    MaterialHandle materialOverride;
 };
 
-struct RenderComponent
+struct NameComponent
 {
-    std::vector<RenderObject> renderObjects;
+    std::string name;
 };
 
 enum class LightType
@@ -105,19 +126,19 @@ struct LightComponent
 // TODO move storage components to separate files
 struct TextureStorageComponent
 {
-    std::vector<Texture> textures;
+    SlotMap<Texture> textures;
     bool updated = false;
 };
 
 struct MaterialStorageComponent
 {
-    std::vector<Material> materials;
+    SlotMap<Material> materials;
     bool updated = false;
 };
 
 struct GeometryStorageComponent
 {
-    std::vector<Primitive> primitives;
+    SlotMap<Primitive> primitives;
     bool updated = false;
 };
 
@@ -127,11 +148,20 @@ struct RenderContextComponent
     vk::Buffer lightBuffer;
     vk::Buffer materialBuffer;
     std::vector<vk::Buffer> frameBuffers;
+    // Instance data and indirect commands of visible objects in snapshot order, per swapchain image,
+    // so commands of a draw bucket start at its offset
+    std::vector<vk::Buffer> instanceBuffers;
+    std::vector<vk::Buffer> drawCommandBuffers;
+    uint32_t drawCapacity = 0;
+    std::vector<vk::DrawIndexedIndirectCommand> drawCommands;
+    bool drawBuffersUpdated = false;
 };
 
 struct RayTracingContextComponent
 {
-    vk::AccelerationStructureKHR tlas;
-    uint32_t tlasInstanceCount = 0;
+    // TLAS per swapchain image, so building it for a frame doesn't wait for frames reading other copies
+    std::vector<vk::AccelerationStructureKHR> tlases;
+    // Geometry ranges of primitive slots, ray tracing shaders fetch vertices from GeometryArena through them
+    vk::Buffer primitiveBuffer;
     bool updated = false;
 };
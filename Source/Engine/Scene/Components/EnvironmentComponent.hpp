@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Engine/Render/Vulkan/Resources/TextureHelpers.hpp"
-
-class Filepath;
+#include "Engine/Filesystem/Filepath.hpp"
 
 struct EnvironmentComponent
 {
@@ -11,6 +10,7 @@ struct EnvironmentComponent
     Texture cubemapTexture;
     Texture irradianceTexture;
     Texture reflectionTexture;
+    Filepath panoramaPath;
 };
 
 namespace EnvironmentHelpers
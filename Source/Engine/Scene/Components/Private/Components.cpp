@@ -2,39 +2,6 @@
 
 #include "Engine/Scene/Scene.hpp"
 
-HierarchyComponent::HierarchyComponent(Scene& scene_, entt::entity self_, entt::entity parent_)
-    : scene(scene_)
-    , self(self_)
-{
-    Assert(self != entt::null);
-
-    SetParent(parent_);
-}
-
-void HierarchyComponent::SetParent(entt::entity parent_)
-{
-    if (parent == parent_)
-    {
-        return;
-    }
-
-    if (parent != entt::null)
-    {
-        auto& parentHc = scene.get<HierarchyComponent>(parent);
-
-        std::erase(parentHc.children, self);
-    }
-
-    parent = parent_;
-
-    if (parent != entt::null)
-    {
-        auto& parentHc = scene.get<HierarchyComponent>(parent);
-
-        parentHc.children.push_back(self);
-    }
-}
-
 TransformComponent::TransformComponent(Scene& scene_, entt::entity self_, const Transform& localTransform_)
     : scene(scene_)
     , self(self_)
@@ -68,9 +35,13 @@ void TransformComponent::SetLocalTransform(const Transform& transform)
 
     modified = true;
 
+    scene.InvalidateTransform(self);
+
     scene.EnumerateDescendants(self, [&](entt::entity child)
         {
             scene.get<TransformComponent>(child).modified = true;
+
+            scene.InvalidateTransform(child);
         });
 }
 
@@ -80,9 +51,13 @@ void TransformComponent::SetLocalTranslation(const glm::vec3& translation)
 
     modified = true;
 
+    scene.InvalidateTransform(self);
+
     scene.EnumerateDescendants(self, [&](entt::entity child)
         {
             scene.get<TransformComponent>(child).modified = true;
+
+            scene.InvalidateTransform(child);
         });
 }
 
@@ -92,9 +67,13 @@ void TransformComponent::SetLocalRotation(const glm::quat& rotation)
 
     modified = true;
 
+    scene.InvalidateTransform(self);
+
     scene.EnumerateDescendants(self, [&](entt::entity child)
         {
             scene.get<TransformComponent>(child).modified = true;
+
+            scene.InvalidateTransform(child);
         });
 }
 
@@ -104,8 +83,12 @@ void TransformComponent::SetLocalScale(const glm::vec3& scale)
 
     modified = true;
 
+    scene.InvalidateTransform(self);
+
     scene.EnumerateDescendants(self, [&](entt::entity child)
         {
             scene.get<TransformComponent>(child).modified = true;
+
+            scene.InvalidateTransform(child);
         });
 }
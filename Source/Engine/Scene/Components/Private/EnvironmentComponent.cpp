@@ -17,5 +17,5 @@ EnvironmentComponent EnvironmentHelpers::LoadEnvironment(const Filepath& panoram
 
     TextureCache::ReleaseTexture(panoramaPath, true);
 
-    return EnvironmentComponent{ cubemapTexture, irradianceTexture, reflectionTexture };
+    return EnvironmentComponent{ cubemapTexture, irradianceTexture, reflectionTexture, panoramaPath };
 }
@@ -6,7 +6,7 @@
 
 #include "Utils/Flags.hpp"
 
-struct Range;
+#include <unordered_map>
 
 enum class MaterialFlagBits
 {
@@ -32,9 +32,6 @@ namespace MaterialHelpers
 
     vk::GeometryInstanceFlagsKHR GetTlasInstanceFlags(MaterialFlags flags);
 
-    void AddTextureOffset(Material& material, int32_t offset);
-
-    void SubtractTextureOffset(Material& material, int32_t offset);
-
-    void SubtractTextureRange(Material& material, const Range& range);
+    // Texture indices missing in the map are left unchanged
+    void RemapTextures(Material& material, const std::unordered_map<int32_t, int32_t>& textureMap);
 }
@@ -1,16 +1,16 @@
 #pragma once
 
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
+
 #include "Utils/AABBox.hpp"
 
-struct VertexInput;
+class TriangleBvh;
 
 class Primitive
 {
 public:
     static constexpr vk::IndexType kIndexType = vk::IndexType::eUint32;
 
-    static const std::vector<VertexInput> kVertexInputs;
-
     Primitive(std::vector<uint32_t> indices_,
             std::vector<glm::vec3> positions_,
             std::vector<glm::vec3> normals_ = {},
@@ -36,14 +36,19 @@ public:
 
     const AABBox& GetBBox() const { return bbox; }
 
-    vk::Buffer GetIndexBuffer() const { return indexBuffer; }
-    vk::Buffer GetPositionBuffer() const { return positionBuffer; }
-    vk::Buffer GetNormalBuffer() const { return normalBuffer; }
-    vk::Buffer GetTangentBuffer() const { return tangentBuffer; }
-    vk::Buffer GetTexCoordBuffer() const { return texCoordBuffer; }
+    const GeometryRange& GetGeometryRange() const { return geometryRange; }
 
     vk::AccelerationStructureKHR GetBlas() const { return blas; }
 
+    // Primitives don't generate BLAS on creation, missing ones are built together in batches
+    static void GenerateBlases(const std::vector<Primitive*>& primitives);
+
+    const TriangleBvh* GetTriangleBvh() const { return triangleBvh.get(); }
+
+    // Not thread safe for the same primitive, different primitives can be built concurrently
+    void BuildTriangleBvh() const;
+
+    // GeometryArena has to be bound before the draw
     void Draw(vk::CommandBuffer commandBuffer) const;
 
 private:
@@ -55,19 +60,15 @@ private:
 
     AABBox bbox;
 
-    vk::Buffer indexBuffer;
-    vk::Buffer positionBuffer;
-    vk::Buffer normalBuffer;
-    vk::Buffer tangentBuffer;
-    vk::Buffer texCoordBuffer;
+    GeometryRange geometryRange;
 
     vk::AccelerationStructureKHR blas;
 
-    void CreateBuffers();
+    mutable std::shared_ptr<const TriangleBvh> triangleBvh;
 
-    void GenerateBlas();
+    void AllocateGeometry();
 
-    void DestroyBuffers() const;
+    void FreeGeometry() const;
 
     void DestroyBlas() const;
 };
@@ -166,7 +166,8 @@ namespace Details
 
         return ResourceContext::CreateBuffer({
             .type = BufferType::eStorage,
-            .size = size
+            .size = size,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc
         });
     }
 }
@@ -186,7 +187,7 @@ LightVolumeComponent GlobalIllumination::GenerateLightVolume(const Scene& scene)
 
     const std::unique_ptr<ProbeRenderer> probeRenderer = std::make_unique<ProbeRenderer>(&scene);
 
-    const AABBox bbox = Details::GetVolumeBBox(SceneHelpers::ComputeBBox(scene));
+    const AABBox bbox = Details::GetVolumeBBox(scene.GetBvh().GetBBox());
     const std::vector<glm::vec3> positions = Details::GenerateLightVolumePositions(&scene, bbox);
     const auto [tetrahedral, edgeIndices] = MeshHelpers::GenerateTetrahedral(positions);
 
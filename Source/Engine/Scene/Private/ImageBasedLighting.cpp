@@ -344,6 +344,9 @@ Texture ImageBasedLighting::GenerateReflection(const Texture& cubemap) const
 
     descriptorProvider->FlushData();
 
+    const PushConstantHandle roughnessHandle = reflectionPipeline->GetPushConstantHandle("roughness");
+    const PushConstantHandle faceIndexHandle = reflectionPipeline->GetPushConstantHandle("faceIndex");
+
     const vk::ImageSubresourceRange reflectionSubresourceRange
             = ImageHelpers::GetSubresourceRange(reflectionDescription);
 
@@ -380,8 +383,11 @@ Texture ImageBasedLighting::GenerateReflection(const Texture& cubemap) const
                     const float maxMipLevel = static_cast<float>(reflectionDescription.mipLevelCount - 1);
                     const float roughness = static_cast<float>(mipLevel) / maxMipLevel;
 
-                    reflectionPipeline->PushConstant(commandBuffer, "roughness", roughness);
-                    reflectionPipeline->PushConstant(commandBuffer, "faceIndex", faceIndex);
+                    const PushConstantBlock pushConstants = PushConstantBlock()
+                            .Set(roughnessHandle, roughness)
+                            .Set(faceIndexHandle, faceIndex);
+
+                    reflectionPipeline->PushConstants(commandBuffer, pushConstants);
 
                     const vk::Extent2D mipLevelExtent
                             = ImageHelpers::CalculateMipLevelExtent(reflectionExtent, mipLevel);
@@ -38,74 +38,14 @@ vk::GeometryInstanceFlagsKHR MaterialHelpers::GetTlasInstanceFlags(MaterialFlags
     return instanceFlags;
 }
 
-void MaterialHelpers::AddTextureOffset(Material& material, int32_t offset)
+void MaterialHelpers::RemapTextures(Material& material, const std::unordered_map<int32_t, int32_t>& textureMap)
 {
-    if (material.data.baseColorTexture >= 0)
+    for (int32_t* texture : { &material.data.baseColorTexture, &material.data.roughnessMetallicTexture,
+            &material.data.normalTexture, &material.data.occlusionTexture, &material.data.emissionTexture })
     {
-        material.data.baseColorTexture += offset;
-    }
-    if (material.data.roughnessMetallicTexture >= 0)
-    {
-        material.data.roughnessMetallicTexture += offset;
-    }
-    if (material.data.normalTexture >= 0)
-    {
-        material.data.normalTexture += offset;
-    }
-    if (material.data.occlusionTexture >= 0)
-    {
-        material.data.occlusionTexture += offset;
-    }
-    if (material.data.emissionTexture >= 0)
-    {
-        material.data.emissionTexture += offset;
-    }
-}
-
-void MaterialHelpers::SubtractTextureOffset(Material& material, int32_t offset)
-{
-    if (material.data.baseColorTexture >= offset)
-    {
-        material.data.baseColorTexture -= offset;
-    }
-    if (material.data.roughnessMetallicTexture >= offset)
-    {
-        material.data.roughnessMetallicTexture -= offset;
-    }
-    if (material.data.normalTexture >= offset)
-    {
-        material.data.normalTexture -= offset;
-    }
-    if (material.data.occlusionTexture >= offset)
-    {
-        material.data.occlusionTexture -= offset;
-    }
-    if (material.data.emissionTexture >= offset)
-    {
-        material.data.emissionTexture -= offset;
-    }
-}
-
-void MaterialHelpers::SubtractTextureRange(Material& material, const Range& range)
-{
-    if (material.data.baseColorTexture >= static_cast<int32_t>(range.offset + range.size))
-    {
-        material.data.baseColorTexture -= static_cast<int32_t>(range.size);
-    }
-    if (material.data.roughnessMetallicTexture >= static_cast<int32_t>(range.offset + range.size))
-    {
-        material.data.roughnessMetallicTexture -= static_cast<int32_t>(range.size);
-    }
-    if (material.data.normalTexture >= static_cast<int32_t>(range.offset + range.size))
-    {
-        material.data.normalTexture -= static_cast<int32_t>(range.size);
-    }
-    if (material.data.occlusionTexture >= static_cast<int32_t>(range.offset + range.size))
-    {
-        material.data.occlusionTexture -= static_cast<int32_t>(range.size);
-    }
-    if (material.data.emissionTexture >= static_cast<int32_t>(range.offset + range.size))
-    {
-        material.data.emissionTexture -= static_cast<int32_t>(range.size);
+        if (const auto it = textureMap.find(*texture); it != textureMap.end())
+        {
+            *texture = it->second;
+        }
     }
 }
@@ -1,11 +1,11 @@
 #include "Engine/Scene/Primitive.hpp"
 
 #include "Engine/ConsoleVariable.hpp"
-#include "Engine/Render/Vulkan/Pipelines/GraphicsPipeline.hpp"
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 
 #include "Utils/Assert.hpp"
 #include "Utils/Helpers.hpp"
+#include "Utils/TriangleBvh.hpp"
 
 namespace Details
 {
@@ -104,13 +104,6 @@ namespace Details
     }
 }
 
-const std::vector<VertexInput> Primitive::kVertexInputs{
-    VertexInput{ { vk::Format::eR32G32B32Sfloat }, 0, vk::VertexInputRate::eVertex },
-    VertexInput{ { vk::Format::eR32G32B32Sfloat }, 0, vk::VertexInputRate::eVertex },
-    VertexInput{ { vk::Format::eR32G32B32Sfloat }, 0, vk::VertexInputRate::eVertex },
-    VertexInput{ { vk::Format::eR32G32Sfloat }, 0, vk::VertexInputRate::eVertex }
-};
-
 Primitive::Primitive(std::vector<uint32_t> indices_,
         std::vector<glm::vec3> positions_, std::vector<glm::vec3> normals_,
         std::vector<glm::vec3> tangents_, std::vector<glm::vec2> texCoords_)
@@ -138,19 +131,14 @@ Primitive::Primitive(std::vector<uint32_t> indices_,
         bbox.Add(position);
     }
 
-    CreateBuffers();
-
-    if (Details::ShouldGenerateBlas())
-    {
-        GenerateBlas();
-    }
+    AllocateGeometry();
 }
 
 Primitive::Primitive(const Primitive& other) noexcept
 {
     Assert(false);
 
-    DestroyBuffers();
+    FreeGeometry();
     DestroyBlas();
 
     indices = other.indices;
@@ -161,13 +149,11 @@ Primitive::Primitive(const Primitive& other) noexcept
 
     bbox = other.bbox;
 
-    indexBuffer = other.indexBuffer;
-    positionBuffer = other.positionBuffer;
-    normalBuffer = other.normalBuffer;
-    tangentBuffer = other.tangentBuffer;
-    texCoordBuffer = other.texCoordBuffer;
+    geometryRange = other.geometryRange;
 
     blas = other.blas;
+
+    triangleBvh = other.triangleBvh;
 }
 
 Primitive::Primitive(Primitive&& other) noexcept
@@ -180,18 +166,16 @@ Primitive::Primitive(Primitive&& other) noexcept
 
     std::swap(bbox, other.bbox);
 
-    std::swap(indexBuffer, other.indexBuffer);
-    std::swap(positionBuffer, other.positionBuffer);
-    std::swap(normalBuffer, other.normalBuffer);
-    std::swap(tangentBuffer, other.tangentBuffer);
-    std::swap(texCoordBuffer, other.texCoordBuffer);
+    std::swap(geometryRange, other.geometryRange);
 
     std::swap(blas, other.blas);
+
+    std::swap(triangleBvh, other.triangleBvh);
 }
 
 Primitive::~Primitive()
 {
-    DestroyBuffers();
+    FreeGeometry();
     DestroyBlas();
 }
 
@@ -207,13 +191,11 @@ Primitive& Primitive::operator=(Primitive other) noexcept
 
         std::swap(bbox, other.bbox);
 
-        std::swap(indexBuffer, other.indexBuffer);
-        std::swap(positionBuffer, other.positionBuffer);
-        std::swap(normalBuffer, other.normalBuffer);
-        std::swap(tangentBuffer, other.tangentBuffer);
-        std::swap(texCoordBuffer, other.texCoordBuffer);
+        std::swap(geometryRange, other.geometryRange);
 
         std::swap(blas, other.blas);
+
+        std::swap(triangleBvh, other.triangleBvh);
     }
 
     return *this;
@@ -229,88 +211,64 @@ uint32_t Primitive::GetVertexCount() const
     return static_cast<uint32_t>(positions.size());
 }
 
-void Primitive::CreateBuffers()
+void Primitive::GenerateBlases(const std::vector<Primitive*>& primitives)
 {
-    constexpr vk::BufferUsageFlags indexUsage
-            = vk::BufferUsageFlagBits::eIndexBuffer
-            | vk::BufferUsageFlagBits::eStorageBuffer;
-
-    constexpr vk::BufferUsageFlags vertexUsage
-            = vk::BufferUsageFlagBits::eVertexBuffer
-            | vk::BufferUsageFlagBits::eStorageBuffer;
-
-    Assert(!indices.empty());
-    indexBuffer = ResourceContext::CreateBuffer({
-        .usage = indexUsage,
-        .initialData = GetByteView(indices)
-    });
+    if (!Details::ShouldGenerateBlas() || primitives.empty())
+    {
+        return;
+    }
 
-    Assert(!positions.empty());
-    positionBuffer = ResourceContext::CreateBuffer({
-        .usage = vertexUsage,
-        .initialData = GetByteView(positions)
-    });
+    std::vector<BlasGeometryData> geometries;
+    geometries.reserve(primitives.size());
 
-    Assert(!normals.empty());
-    normalBuffer = ResourceContext::CreateBuffer({
-        .usage = vertexUsage,
-        .initialData = GetByteView(normals)
-    });
+    for (const Primitive* primitive : primitives)
+    {
+        Assert(!primitive->blas);
+
+        geometries.push_back(BlasGeometryData{
+            .indexType = kIndexType,
+            .indexCount = primitive->GetIndexCount(),
+            .indexBuffer = GeometryArena::GetIndexBuffer(),
+            .indexOffset = primitive->geometryRange.firstIndex * sizeof(uint32_t),
+            .vertexFormat = vk::Format::eR32G32B32Sfloat,
+            .vertexStride = GeometryArena::GetVertexStride(VertexAttribute::ePosition),
+            .vertexCount = primitive->GetVertexCount(),
+            .vertexBuffer = GeometryArena::GetVertexBuffer(VertexAttribute::ePosition),
+            .vertexOffset = primitive->geometryRange.vertexOffset
+                    * GeometryArena::GetVertexStride(VertexAttribute::ePosition)
+        });
+    }
 
-    Assert(!tangents.empty());
-    tangentBuffer = ResourceContext::CreateBuffer({
-        .usage = vertexUsage,
-        .initialData = GetByteView(tangents)
-    });
+    const std::vector<vk::AccelerationStructureKHR> blases = ResourceContext::GenerateBlases(geometries);
 
-    Assert(!texCoords.empty());
-    texCoordBuffer = ResourceContext::CreateBuffer({
-        .usage = vertexUsage,
-        .initialData = GetByteView(texCoords)
-    });
+    for (size_t i = 0; i < primitives.size(); ++i)
+    {
+        primitives[i]->blas = blases[i];
+    }
 }
 
-void Primitive::GenerateBlas()
+void Primitive::BuildTriangleBvh() const
 {
-    Assert(!indices.empty());
-    Assert(!positions.empty());
-
-    BlasGeometryData geometryData;
-
-    geometryData.indexType = Primitive::kIndexType;
-    geometryData.indexCount = static_cast<uint32_t>(indices.size());
-    geometryData.indices = GetByteView(indices);
-
-    geometryData.vertexFormat = vk::Format::eR32G32B32Sfloat;
-    geometryData.vertexStride = sizeof(glm::vec3);
-    geometryData.vertexCount = static_cast<uint32_t>(positions.size());
-    geometryData.vertices = GetByteView(positions);
+    if (!triangleBvh)
+    {
+        triangleBvh = std::make_shared<TriangleBvh>(indices, positions);
+    }
+}
 
-    blas = ResourceContext::GenerateBlas(geometryData);
+void Primitive::AllocateGeometry()
+{
+    geometryRange = GeometryArena::Allocate(GeometryData{
+        .indices = DataView<uint32_t>(indices),
+        .positions = DataView<glm::vec3>(positions),
+        .normals = DataView<glm::vec3>(normals),
+        .tangents = DataView<glm::vec3>(tangents),
+        .texCoords = DataView<glm::vec2>(texCoords)
+    });
 }
 
-void Primitive::DestroyBuffers() const
+void Primitive::FreeGeometry() const
 {
-    if (indexBuffer)
-    {
-        ResourceContext::DestroyResourceSafe(indexBuffer);
-    }
-    if (positionBuffer)
-    {
-        ResourceContext::DestroyResourceSafe(positionBuffer);
-    }
-    if (normalBuffer)
-    {
-        ResourceContext::DestroyResourceSafe(normalBuffer);
-    }
-    if (tangentBuffer)
-    {
-        ResourceContext::DestroyResourceSafe(tangentBuffer);
-    }
-    if (texCoordBuffer)
-    {
-        ResourceContext::DestroyResourceSafe(texCoordBuffer);
-    }
+    GeometryArena::Free(geometryRange);
 }
 
 void Primitive::DestroyBlas() const
@@ -323,40 +281,6 @@ void Primitive::DestroyBlas() const
 
 void Primitive::Draw(vk::CommandBuffer commandBuffer) const
 {
-    std::vector<vk::Buffer> vertexBuffers;
-
-    if (positionBuffer)
-    {
-        vertexBuffers.push_back(positionBuffer);
-    }
-    if (normalBuffer)
-    {
-        vertexBuffers.push_back(normalBuffer);
-    }
-    if (tangentBuffer)
-    {
-        vertexBuffers.push_back(tangentBuffer);
-    }
-    if (texCoordBuffer)
-    {
-        vertexBuffers.push_back(texCoordBuffer);
-    }
-
-    if (!vertexBuffers.empty())
-    {
-        const std::vector<vk::DeviceSize> offsets(vertexBuffers.size(), 0);
-
-        commandBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
-    }
-
-    if (indexBuffer)
-    {
-        commandBuffer.bindIndexBuffer(indexBuffer, 0, Primitive::kIndexType);
-
-        commandBuffer.drawIndexed(GetIndexCount(), 1, 0, 0, 0);
-    }
-    else
-    {
-        commandBuffer.draw(GetVertexCount(), 1, 0, 0);
-    }
+    commandBuffer.drawIndexed(geometryRange.indexCount, 1, geometryRange.firstIndex,
+            static_cast<int32_t>(geometryRange.vertexOffset), 0);
 }
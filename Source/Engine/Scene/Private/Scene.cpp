@@ -1,6 +1,9 @@
 #include "Engine/Scene/Scene.hpp"
 
 #include "Engine/Engine.hpp"
+#include "Engine/ConsoleVariable.hpp"
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderThread.hpp"
 #include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
 #include "Engine/Scene/Components/Components.hpp"
 #include "Engine/Scene/Components/EnvironmentComponent.hpp"
@@ -8,128 +11,112 @@
 #include "Engine/Scene/Material.hpp"
 #include "Engine/Scene/SceneHelpers.hpp"
 #include "Engine/Scene/SceneLoader.hpp"
+#include "Engine/Scene/SceneSnapshot.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/Ray.hpp"
+#include "Utils/TimeHelpers.hpp"
+#include "Utils/TriangleBvh.hpp"
 
 namespace Details
 {
-    StorageRange GetStorageRange(Scene& srcScene, Scene& dstScene)
+    static bool useSnapshots = true;
+    static CVarBool useSnapshotsCVar("scene.UseSnapshots", useSnapshots);
+
+    static void LogUploadStats(const UploadStats& initialStats, const UploadStats& finalStats)
     {
-        StorageRange storageRange;
+        const float megabytes = static_cast<float>(finalStats.uploadedBytes - initialStats.uploadedBytes)
+                / Metric::kMegabyte;
 
-        const auto& dstTsc = dstScene.ctx().get<TextureStorageComponent>();
-        const auto& dstMsc = dstScene.ctx().get<MaterialStorageComponent>();
-        const auto& dstGsc = dstScene.ctx().get<GeometryStorageComponent>();
+        const float seconds = finalStats.seconds - initialStats.seconds;
 
-        storageRange.textures.offset = static_cast<uint32_t>(dstTsc.textures.size());
-        storageRange.materials.offset = static_cast<uint32_t>(dstMsc.materials.size());
-        storageRange.primitives.offset = static_cast<uint32_t>(dstGsc.primitives.size());
+        const float throughput = seconds > 0.0f ? megabytes / seconds : 0.0f;
 
-        const auto& srcTsc = srcScene.ctx().get<TextureStorageComponent>();
-        const auto& srcMsc = srcScene.ctx().get<MaterialStorageComponent>();
-        const auto& srcGsc = srcScene.ctx().get<GeometryStorageComponent>();
+        LogI << "Scene uploads: " << megabytes << " MB in " << finalStats.submitCount - initialStats.submitCount
+                << " submits, " << throughput << " MB/s\n";
+    }
+}
 
-        storageRange.textures.size = static_cast<uint32_t>(srcTsc.textures.size());
-        storageRange.materials.size = static_cast<uint32_t>(srcMsc.materials.size());
-        storageRange.primitives.size = static_cast<uint32_t>(srcGsc.primitives.size());
+Scene::Scene()
+{
+    on_construct<NameComponent>().connect<&Scene::AddNameToIndex>(*this);
+    on_update<NameComponent>().connect<&Scene::UpdateNameInIndex>(*this);
+    on_destroy<NameComponent>().connect<&Scene::RemoveNameFromIndex>(*this);
 
-        return storageRange;
-    }
+    on_construct<RenderComponent>().connect<&Scene::InvalidateRenderBounds>(*this);
+    on_update<RenderComponent>().connect<&Scene::InvalidateRenderBounds>(*this);
+    on_destroy<RenderComponent>().connect<&Scene::RemoveFromBvh>(*this);
 
-    void AddStorageOffset(Scene& scene, const StorageRange& storageRange)
-    {
-        for (auto& material : scene.ctx().get<MaterialStorageComponent>().materials)
-        {
-            const int32_t offset = static_cast<int32_t>(storageRange.textures.offset);
+    on_construct<SharedInstanceComponent>().connect<&Scene::InvalidateRenderBounds>(*this);
+    on_update<SharedInstanceComponent>().connect<&Scene::InvalidateRenderBounds>(*this);
+    on_destroy<SharedInstanceComponent>().connect<&Scene::RemoveFromBvh>(*this);
 
-            MaterialHelpers::AddTextureOffset(material, offset);
-        }
+    on_construct<LightComponent>().connect<&Scene::InvalidateLights>(*this);
+    on_update<LightComponent>().connect<&Scene::InvalidateLight>(*this);
+    on_destroy<LightComponent>().connect<&Scene::InvalidateLights>(*this);
+}
 
-        for (auto&& [entity, rc] : scene.view<RenderComponent>().each())
-        {
-            for (auto& ro : rc.renderObjects)
-            {
-                ro.primitive += storageRange.primitives.offset;
-                ro.material += storageRange.materials.offset;
-            }
-        }
-    }
+Scene::Scene(const Filepath& path)
+    : Scene()
+{
+    const UploadStats initialUploadStats = ResourceContext::GetUploadStats();
+
+    const Filepath snapshotPath = SceneSnapshot::GetSnapshotPath(path);
+
+    const bool snapshotLoaded = Details::useSnapshots
+            && SceneSnapshot::IsUpToDate(path, snapshotPath)
+            && SceneSnapshot::Load(*this, snapshotPath);
 
-    void SubtractStorageOffset(Scene& scene, const StorageRange& storageRange)
+    if (!snapshotLoaded)
     {
-        for (auto& material : scene.ctx().get<MaterialStorageComponent>().materials)
-        {
-            const int32_t offset = static_cast<int32_t>(storageRange.textures.offset);
+        Timer timer;
+        timer.Tick();
 
-            MaterialHelpers::SubtractTextureOffset(material, offset);
-        }
+        SceneLoader sceneLoader(*this, path);
 
-        for (auto&& [entity, rc] : scene.view<RenderComponent>().each())
-        {
-            for (auto& ro : rc.renderObjects)
-            {
-                if (ro.primitive >= storageRange.primitives.offset)
-                {
-                    ro.primitive -= storageRange.primitives.offset;
-                }
-                if (ro.material >= storageRange.materials.offset)
-                {
-                    ro.material -= storageRange.materials.offset;
-                }
-            }
-        }
-    }
+        const float loadSeconds = timer.Tick();
 
-    void SubtractStorageRange(Scene& scene, const StorageRange& storageRange)
-    {
-        if (auto* msc = scene.ctx().find<MaterialStorageComponent>())
-        {
-            for (auto& material : msc->materials)
-            {
-                MaterialHelpers::SubtractTextureRange(material, storageRange.textures);
-            }
-        }
+        LogI << "Scene loaded from glTF in " << loadSeconds / Metric::kMili << " ms\n";
 
-        for (auto&& [entity, rc] : scene.view<RenderComponent>().each())
+        if (Details::useSnapshots)
         {
-            for (auto& ro : rc.renderObjects)
-            {
-                if (ro.primitive >= storageRange.primitives.GetEnd())
-                {
-                    ro.primitive -= storageRange.primitives.size;
-                }
-                if (ro.material >= storageRange.materials.GetEnd())
-                {
-                    ro.material -= storageRange.materials.size;
-                }
-            }
+            SceneSnapshot::Save(*this, snapshotPath, loadSeconds);
         }
     }
 
-    void UpdateStorageRange(StorageRange& storageRange, const StorageRange& removedRange)
-    {
-        if (storageRange.textures.offset >= removedRange.textures.GetEnd())
-        {
-            storageRange.textures.offset -= removedRange.textures.size;
-        }
-        if (storageRange.materials.offset >= removedRange.materials.GetEnd())
-        {
-            storageRange.materials.offset -= removedRange.materials.size;
-        }
-        if (storageRange.textures.offset >= removedRange.textures.GetEnd())
-        {
-            storageRange.textures.offset -= removedRange.textures.size;
-        }
-    }
-}
+    SortHierarchy();
 
-Scene::Scene() = default;
+    ResourceContext::WaitForUploads(ResourceContext::SubmitUploads());
 
-Scene::Scene(const Filepath& path)
-{
-    SceneLoader sceneLoader(*this, path);
+    Details::LogUploadStats(initialUploadStats, ResourceContext::GetUploadStats());
+
+    LogI << "Host visible buffer memory: " << static_cast<float>(
+            VulkanContext::memoryManager->GetHostVisibleBufferMemorySize()) / Metric::kMegabyte << " MB\n";
+
+    BuildTriangleBvhs();
+
+    GenerateBlases();
 }
 
 Scene::~Scene()
 {
+    on_construct<NameComponent>().disconnect<&Scene::AddNameToIndex>(*this);
+    on_update<NameComponent>().disconnect<&Scene::UpdateNameInIndex>(*this);
+    on_destroy<NameComponent>().disconnect<&Scene::RemoveNameFromIndex>(*this);
+
+    on_construct<RenderComponent>().disconnect<&Scene::InvalidateRenderBounds>(*this);
+    on_update<RenderComponent>().disconnect<&Scene::InvalidateRenderBounds>(*this);
+    on_destroy<RenderComponent>().disconnect<&Scene::RemoveFromBvh>(*this);
+
+    on_construct<SharedInstanceComponent>().disconnect<&Scene::InvalidateRenderBounds>(*this);
+    on_update<SharedInstanceComponent>().disconnect<&Scene::InvalidateRenderBounds>(*this);
+    on_destroy<SharedInstanceComponent>().disconnect<&Scene::RemoveFromBvh>(*this);
+
+    on_construct<LightComponent>().disconnect<&Scene::InvalidateLights>(*this);
+    on_update<LightComponent>().disconnect<&Scene::InvalidateLight>(*this);
+    on_destroy<LightComponent>().disconnect<&Scene::InvalidateLights>(*this);
+
     for (const auto&& [entity, ec] : view<EnvironmentComponent>().each())
     {
         ResourceContext::DestroyResourceSafe(ec.cubemapTexture.image);
@@ -146,10 +133,10 @@ Scene::~Scene()
 
     if (const auto* tsc = ctx().find<TextureStorageComponent>())
     {
-        for (const auto& [image, sampler] : tsc->textures)
-        {
-            TextureCache::ReleaseTexture(image);
-        }
+        tsc->textures.Enumerate([](TextureHandle, const Texture& texture)
+            {
+                TextureCache::ReleaseTexture(texture.image);
+            });
 
         TextureCache::DestroyUnusedTextures();
     }
@@ -157,27 +144,23 @@ Scene::~Scene()
 
 void Scene::EnumerateHierarchy(const SceneEntityFunc& func) const
 {
-    each([&](entt::entity entity)
-        {
-            if (get<HierarchyComponent>(entity).GetParent() == entt::null)
-            {
-                func(entity);
+    if (!hierarchySorted)
+    {
+        WalkDepthFirst(firstRoot, entt::null, func);
+        return;
+    }
 
-                EnumerateDescendants(entity, func);
-            }
-        });
+    for (const auto entity : view<HierarchyComponent>())
+    {
+        func(entity);
+    }
 }
 
 void Scene::EnumerateDescendants(entt::entity entity, const SceneEntityFunc& func) const
 {
     if (entity != entt::null)
     {
-        for (const auto child : get<HierarchyComponent>(entity).GetChildren())
-        {
-            func(child);
-
-            EnumerateDescendants(child, func);
-        }
+        WalkDepthFirst(get<HierarchyComponent>(entity).firstChild, entity, func);
     }
     else
     {
@@ -185,6 +168,20 @@ void Scene::EnumerateDescendants(entt::entity entity, const SceneEntityFunc& fun
     }
 }
 
+void Scene::EnumerateChildren(entt::entity entity, const SceneEntityFunc& func) const
+{
+    entt::entity child = entity != entt::null ? get<HierarchyComponent>(entity).firstChild : firstRoot;
+
+    while (child != entt::null)
+    {
+        const entt::entity nextSibling = get<HierarchyComponent>(child).nextSibling;
+
+        func(child);
+
+        child = nextSibling;
+    }
+}
+
 void Scene::EnumerateAncestors(entt::entity entity, const SceneEntityFunc& func) const
 {
     if (entity != entt::null)
@@ -217,24 +214,179 @@ entt::entity Scene::FindRootParent(entt::entity entity) const
     return entt::null;
 }
 
-entt::entity Scene::FindEntity(const std::string& name) const
+entt::entity Scene::FindEntity(std::string_view name) const
+{
+    const auto [begin, end] = nameIndex.equal_range(name);
+
+    if (begin == end)
+    {
+        return entt::null;
+    }
+
+    if (std::next(begin) != end)
+    {
+        LogW << "Entity name is not unique, use FindEntities instead: " << std::string(name) << "\n";
+    }
+
+    return begin->second;
+}
+
+Scene::NameRange Scene::FindEntities(std::string_view name) const
 {
-    for (auto&& [entity, nc] : view<NameComponent>().each())
+    return nameIndex.equal_range(name);
+}
+
+const DynamicBvh& Scene::GetBvh() const
+{
+    if (!invalidatedBounds.empty())
     {
-        if (nc.name == name)
+        UpdateBvh();
+    }
+
+    return bvh;
+}
+
+void Scene::InvalidateTransform(entt::entity entity)
+{
+    if (any_of<RenderComponent, SharedInstanceComponent>(entity))
+    {
+        invalidatedBounds.insert(entity);
+
+        changes.drawObjects = true;
+    }
+
+    if (all_of<LightComponent>(entity))
+    {
+        changes.lights.insert(entity);
+    }
+}
+
+void Scene::InvalidateMaterial(MaterialHandle material)
+{
+    changes.materials.push_back(material);
+}
+
+SceneChanges Scene::ConsumeChanges()
+{
+    return std::exchange(changes, SceneChanges{});
+}
+
+void Scene::BuildTriangleBvhs() const
+{
+    EASY_FUNCTION()
+
+    const auto* gsc = ctx().find<GeometryStorageComponent>();
+
+    if (!gsc)
+    {
+        return;
+    }
+
+    std::vector<const Primitive*> primitives;
+
+    gsc->primitives.Enumerate([&](PrimitiveHandle, const Primitive& primitive)
         {
-            return entity;
-        }
+            if (!primitive.GetTriangleBvh())
+            {
+                primitives.push_back(&primitive);
+            }
+        });
+
+    ParallelFor(primitives.size(), [&](size_t index)
+        {
+            primitives[index]->BuildTriangleBvh();
+        });
+}
+
+void Scene::GenerateBlases()
+{
+    EASY_FUNCTION()
+
+    auto* gsc = ctx().find<GeometryStorageComponent>();
+
+    if (!gsc)
+    {
+        return;
     }
 
-    return entt::null;
+    std::vector<Primitive*> primitives;
+
+    gsc->primitives.Enumerate([&](PrimitiveHandle, Primitive& primitive)
+        {
+            if (!primitive.GetBlas())
+            {
+                primitives.push_back(&primitive);
+            }
+        });
+
+    Primitive::GenerateBlases(primitives);
+}
+
+std::optional<RayHit> Scene::CastRay(const Ray& ray, RayCastMode mode) const
+{
+    const auto* gsc = ctx().find<GeometryStorageComponent>();
+
+    if (!gsc)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<RayHit> result;
+
+    GetBvh().QueryRay(ray, [&](uint32_t id, float maxDistance)
+        {
+            const entt::entity entity = static_cast<entt::entity>(id);
+
+            bool anyHit = false;
+
+            SceneHelpers::EnumerateRenderObjects(*this, entity, [&](const glm::mat4& transform, const RenderObject& ro)
+                {
+                    if (anyHit)
+                    {
+                        return;
+                    }
+
+                    const glm::mat4 inverseTransform = glm::inverse(transform);
+
+                    // Direction isn't normalized so hit distances stay in world space
+                    const Ray localRay{
+                        glm::vec3(inverseTransform * glm::vec4(ray.origin, 1.0f)),
+                        glm::mat3(inverseTransform) * ray.direction,
+                        maxDistance
+                    };
+
+                    const Primitive& primitive = gsc->primitives[ro.primitive];
+
+                    primitive.BuildTriangleBvh();
+
+                    const TriangleBvh& triangleBvh = *primitive.GetTriangleBvh();
+
+                    const std::optional<TriangleHit> hit = mode == RayCastMode::eAnyHit
+                            ? triangleBvh.IntersectAny(localRay) : triangleBvh.IntersectClosest(localRay);
+
+                    if (hit)
+                    {
+                        result = RayHit{ entity, ro.primitive, hit->triangle, hit->barycentrics, hit->distance };
+
+                        anyHit = mode == RayCastMode::eAnyHit;
+
+                        maxDistance = hit->distance;
+                    }
+                });
+
+            return anyHit ? -1.0f : maxDistance;
+        });
+
+    return result;
 }
 
 entt::entity Scene::CreateEntity(entt::entity parent, const Transform& transform)
 {
     const entt::entity entity = create();
 
-    emplace<HierarchyComponent>(entity, *this, entity, parent);
+    emplace<HierarchyComponent>(entity);
+
+    LinkEntity(entity, parent);
 
     emplace<TransformComponent>(entity, *this, entity, transform);
 
@@ -266,39 +418,72 @@ void Scene::RemoveEntity(entt::entity entity)
 
     if (const auto* sic = try_get<SceneInstanceComponent>(entity))
     {
-        std::erase(get<ScenePrefabComponent>(sic->prefab).instances, sic->prefab);
+        std::erase(get<ScenePrefabComponent>(sic->prefab).instances, entity);
     }
 
-    get<HierarchyComponent>(entity).SetParent(entt::null);
+    if (const auto* sic = try_get<SharedInstanceComponent>(entity))
+    {
+        std::erase(get<ScenePrefabComponent>(sic->prefab).sharedInstances, entity);
+    }
 
     RemoveChildren(entity);
 
+    UnlinkEntity(entity);
+
     destroy(entity);
 }
 
 void Scene::RemoveChildren(entt::entity entity)
 {
-    const std::vector<entt::entity> children = get<HierarchyComponent>(entity).GetChildren();
+    entt::entity child;
 
-    for (const auto child : children)
+    while ((child = get<HierarchyComponent>(entity).firstChild) != entt::null)
     {
         RemoveEntity(child);
     }
 }
 
+void Scene::SetParent(entt::entity entity, entt::entity parent)
+{
+    if (get<HierarchyComponent>(entity).parent == parent)
+    {
+        return;
+    }
+
+    UnlinkEntity(entity);
+
+    LinkEntity(entity, parent);
+
+    auto& tc = get<TransformComponent>(entity);
+
+    tc.SetLocalTransform(tc.GetLocalTransform());
+}
+
 void Scene::EmplaceScenePrefab(Scene&& scene, entt::entity entity)
 {
+    RenderContext::renderThread->Flush();
+
     auto& prefab = emplace<ScenePrefabComponent>(entity);
 
-    prefab.storageRange = Details::GetStorageRange(scene, *this);
+    prefab.storageHandles = SceneHelpers::MergeStorageComponents(scene, *this);
 
     prefab.hierarchy = std::make_unique<Scene>();
 
-    Details::AddStorageOffset(scene, prefab.storageRange);
-
     SceneHelpers::CopyHierarchy(scene, *prefab.hierarchy, entt::null, entt::null);
 
-    SceneHelpers::MergeStorageComponents(scene, *this);
+    const auto& gsc = ctx().get<GeometryStorageComponent>();
+
+    for (auto&& [hierarchyEntity, tc, rc] : prefab.hierarchy->view<TransformComponent, RenderComponent>().each())
+    {
+        const glm::mat4 transform = tc.GetWorldTransform().GetMatrix();
+
+        for (const auto& ro : rc.renderObjects)
+        {
+            prefab.renderNodes.push_back(PrefabRenderNode{ transform, ro });
+
+            prefab.bbox.Add(gsc.primitives[ro.primitive].GetBBox().GetTransformed(transform));
+        }
+    }
 }
 
 void Scene::EmplaceSceneInstance(entt::entity scene, entt::entity entity)
@@ -318,39 +503,277 @@ entt::entity Scene::CreateSceneInstance(entt::entity scene, const Transform& tra
 
     EmplaceSceneInstance(scene, entity);
 
-    for (const auto child : get<HierarchyComponent>(entity).GetChildren())
-    {
-        auto& tc = get<TransformComponent>(child);
+    EnumerateChildren(entity, [&](entt::entity child)
+        {
+            auto& tc = get<TransformComponent>(child);
 
-        tc.SetLocalTransform(tc.GetLocalTransform() * transform);
-    }
+            tc.SetLocalTransform(tc.GetLocalTransform() * transform);
+        });
 
     return entity;
 }
 
-std::unique_ptr<Scene> Scene::EraseScenePrefab(entt::entity scene)
+void Scene::EmplaceSharedInstance(entt::entity scene, entt::entity entity, MaterialHandle materialOverride)
 {
-    auto prefab = std::move(get<ScenePrefabComponent>(scene));
+    emplace<SharedInstanceComponent>(entity, scene, materialOverride);
+
+    get<ScenePrefabComponent>(scene).sharedInstances.push_back(entity);
+}
+
+entt::entity Scene::CreateSharedInstance(entt::entity scene, const Transform& transform)
+{
+    const entt::entity entity = CreateEntity(entt::null, transform);
 
-    SceneHelpers::SplitStorageComponents(*this, *prefab.hierarchy, prefab.storageRange);
+    EmplaceSharedInstance(scene, entity);
+
+    return entity;
+}
 
-    Details::SubtractStorageOffset(*prefab.hierarchy, prefab.storageRange);
+std::unique_ptr<Scene> Scene::EraseScenePrefab(entt::entity scene)
+{
+    RenderContext::renderThread->Flush();
 
-    Details::SubtractStorageRange(*this, prefab.storageRange);
+    auto prefab = std::move(get<ScenePrefabComponent>(scene));
 
     for (const auto instance : prefab.instances)
     {
         RemoveEntity(instance);
     }
 
+    for (const auto instance : prefab.sharedInstances)
+    {
+        RemoveEntity(instance);
+    }
+
     remove<ScenePrefabComponent>(scene);
 
-    for (auto&& [entity, spc] : view<ScenePrefabComponent>().each())
+    SceneHelpers::SplitStorageComponents(*this, *prefab.hierarchy, prefab.storageHandles);
+
+    return std::move(prefab.hierarchy);
+}
+
+void Scene::LinkEntity(entt::entity entity, entt::entity parent)
+{
+    auto& hc = get<HierarchyComponent>(entity);
+
+    entt::entity& lastChild = parent != entt::null ? get<HierarchyComponent>(parent).lastChild : lastRoot;
+    entt::entity& firstChild = parent != entt::null ? get<HierarchyComponent>(parent).firstChild : firstRoot;
+
+    hc.parent = parent;
+    hc.prevSibling = lastChild;
+    hc.nextSibling = entt::null;
+
+    if (lastChild != entt::null)
     {
-        Details::SubtractStorageRange(*spc.hierarchy, prefab.storageRange);
+        get<HierarchyComponent>(lastChild).nextSibling = entity;
+    }
+    else
+    {
+        firstChild = entity;
+    }
+
+    lastChild = entity;
 
-        Details::UpdateStorageRange(spc.storageRange, prefab.storageRange);
+    hierarchySorted = false;
+}
+
+void Scene::UnlinkEntity(entt::entity entity)
+{
+    auto& hc = get<HierarchyComponent>(entity);
+
+    entt::entity& lastChild = hc.parent != entt::null ? get<HierarchyComponent>(hc.parent).lastChild : lastRoot;
+    entt::entity& firstChild = hc.parent != entt::null ? get<HierarchyComponent>(hc.parent).firstChild : firstRoot;
+
+    if (hc.prevSibling != entt::null)
+    {
+        get<HierarchyComponent>(hc.prevSibling).nextSibling = hc.nextSibling;
+    }
+    else
+    {
+        firstChild = hc.nextSibling;
     }
 
-    return std::move(prefab.hierarchy);
+    if (hc.nextSibling != entt::null)
+    {
+        get<HierarchyComponent>(hc.nextSibling).prevSibling = hc.prevSibling;
+    }
+    else
+    {
+        lastChild = hc.prevSibling;
+    }
+
+    hc.parent = entt::null;
+    hc.prevSibling = entt::null;
+    hc.nextSibling = entt::null;
+
+    hierarchySorted = false;
+}
+
+void Scene::WalkDepthFirst(entt::entity first, entt::entity stop, const SceneEntityFunc& func) const
+{
+    entt::entity current = first;
+
+    while (current != entt::null)
+    {
+        func(current);
+
+        const entt::entity firstChild = get<HierarchyComponent>(current).firstChild;
+
+        if (firstChild != entt::null)
+        {
+            current = firstChild;
+            continue;
+        }
+
+        while (current != stop && get<HierarchyComponent>(current).nextSibling == entt::null)
+        {
+            current = get<HierarchyComponent>(current).parent;
+        }
+
+        current = current != stop ? get<HierarchyComponent>(current).nextSibling : entt::null;
+    }
+}
+
+void Scene::SortHierarchy()
+{
+    if (hierarchySorted)
+    {
+        return;
+    }
+
+    EASY_FUNCTION()
+
+    uint32_t order = 0;
+
+    WalkDepthFirst(firstRoot, entt::null, [&](entt::entity entity)
+        {
+            get<HierarchyComponent>(entity).order = order++;
+        });
+
+    sort<HierarchyComponent>([](const HierarchyComponent& a, const HierarchyComponent& b)
+        {
+            return a.order < b.order;
+        });
+
+    hierarchySorted = true;
+}
+
+void Scene::AddNameToIndex(entt::registry&, entt::entity entity)
+{
+    const auto it = nameIndex.emplace(get<NameComponent>(entity).name, entity);
+
+    indexedNames[entity] = &it->first;
+}
+
+void Scene::RemoveNameFromIndex(entt::registry&, entt::entity entity)
+{
+    const auto node = indexedNames.extract(entity);
+    Assert(!node.empty());
+
+    const auto [begin, end] = nameIndex.equal_range(*node.mapped());
+
+    const auto it = std::find_if(begin, end, [&](const auto& entry)
+        {
+            return entry.second == entity;
+        });
+
+    Assert(it != end);
+
+    nameIndex.erase(it);
+}
+
+void Scene::UpdateNameInIndex(entt::registry& registry, entt::entity entity)
+{
+    RemoveNameFromIndex(registry, entity);
+
+    AddNameToIndex(registry, entity);
+}
+
+void Scene::InvalidateRenderBounds(entt::registry&, entt::entity entity)
+{
+    invalidatedBounds.insert(entity);
+
+    changes.drawObjects = true;
+    changes.renderObjects = true;
+}
+
+void Scene::RemoveFromBvh(entt::registry&, entt::entity entity)
+{
+    invalidatedBounds.erase(entity);
+
+    changes.drawObjects = true;
+    changes.renderObjects = true;
+
+    if (const auto node = bvhLeaves.extract(entity))
+    {
+        bvh.Remove(node.mapped());
+    }
+}
+
+void Scene::InvalidateLight(entt::registry&, entt::entity entity)
+{
+    changes.lights.insert(entity);
+}
+
+void Scene::InvalidateLights(entt::registry&, entt::entity)
+{
+    changes.lightsAddedOrRemoved = true;
+}
+
+void Scene::UpdateBvh() const
+{
+    EASY_FUNCTION()
+
+    const auto* gsc = ctx().find<GeometryStorageComponent>();
+
+    if (!gsc)
+    {
+        return;
+    }
+
+    for (const auto entity : invalidatedBounds)
+    {
+        const glm::mat4 transform = get<TransformComponent>(entity).GetWorldTransform().GetMatrix();
+
+        AABBox bbox;
+
+        if (const auto* rc = try_get<RenderComponent>(entity))
+        {
+            for (const auto& ro : rc->renderObjects)
+            {
+                bbox.Add(gsc->primitives[ro.primitive].GetBBox().GetTransformed(transform));
+            }
+        }
+
+        if (const auto* sic = try_get<SharedInstanceComponent>(entity))
+        {
+            const AABBox& prefabBBox = get<ScenePrefabComponent>(sic->prefab).bbox;
+
+            if (prefabBBox.IsValid())
+            {
+                bbox.Add(prefabBBox.GetTransformed(transform));
+            }
+        }
+
+        const auto it = bvhLeaves.find(entity);
+
+        if (!bbox.IsValid())
+        {
+            if (it != bvhLeaves.end())
+            {
+                bvh.Remove(it->second);
+                bvhLeaves.erase(it);
+            }
+        }
+        else if (it != bvhLeaves.end())
+        {
+            bvh.Refit(it->second, bbox);
+        }
+        else
+        {
+            bvhLeaves.emplace(entity, bvh.Insert(bbox, entt::to_integral(entity)));
+        }
+    }
+
+    invalidatedBounds.clear();
 }
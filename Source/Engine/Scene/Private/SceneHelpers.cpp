@@ -1,6 +1,7 @@
 #include "Engine/Scene/SceneHelpers.hpp"
 
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Resources/TextureCache.hpp"
 #include "Engine/Scene/Components/Components.hpp"
 #include "Engine/Scene/Components/EnvironmentComponent.hpp"
 #include "Engine/Scene/Components/AnimationComponent.hpp"
@@ -12,15 +13,19 @@ namespace Details
 {
     using EntityMap = std::map<entt::entity, entt::entity>;
 
-    template <class T>
-    static void MoveRange(std::vector<T>& src, std::vector<T>& dst, const Range& range)
-    {
-        const auto srcBegin = src.begin() + range.offset;
-        const auto srcEnd = src.begin() + range.offset + range.size;
-
-        std::move(srcBegin, srcEnd, std::back_inserter(dst));
+    using PrimitiveMap = std::unordered_map<uint32_t, PrimitiveHandle>;
+    using MaterialMap = std::unordered_map<uint32_t, MaterialHandle>;
 
-        src.erase(srcBegin, srcEnd);
+    static void RemapRenderObjects(Scene& scene, const PrimitiveMap& primitiveMap, const MaterialMap& materialMap)
+    {
+        for (auto&& [entity, rc] : scene.view<RenderComponent>().each())
+        {
+            for (auto& ro : rc.renderObjects)
+            {
+                ro.primitive = primitiveMap.at(ro.primitive.index);
+                ro.material = materialMap.at(ro.material.index);
+            }
+        }
     }
 
     std::vector<entt::entity> GetParentHierarchy(entt::entity entity, const Scene& scene)
@@ -90,7 +95,7 @@ namespace Details
     {
         if (const auto* nc = srcScene.try_get<NameComponent>(srcEntity))
         {
-            dstScene.emplace<NameComponent>(dstEntity) = *nc;
+            dstScene.emplace<NameComponent>(dstEntity, *nc);
         }
         if (const auto* rc = srcScene.try_get<RenderComponent>(srcEntity))
         {
@@ -115,25 +120,6 @@ namespace Details
     }
 }
 
-AABBox SceneHelpers::ComputeBBox(const Scene& scene)
-{
-    AABBox bbox;
-
-    const auto& geometryStorageComponent = scene.ctx().get<GeometryStorageComponent>();
-
-    for (auto&& [entity, tc, rc] : scene.view<TransformComponent, RenderComponent>().each())
-    {
-        for (const auto& ro : rc.renderObjects)
-        {
-            const Primitive& primitive = geometryStorageComponent.primitives[ro.primitive];
-
-            bbox.Add(primitive.GetBBox().GetTransformed(tc.GetWorldTransform().GetMatrix()));
-        }
-    }
-
-    return bbox;
-}
-
 std::string SceneHelpers::GetDefaultName(entt::entity entity)
 {
     return std::format("entity_{}", static_cast<entt::id_type>(entity));
@@ -202,105 +188,200 @@ void SceneHelpers::CopyHierarchy(
 {
     Details::EntityMap entityMap;
 
+    std::vector<entt::entity> srcEntities;
+
+    // Parents are enumerated before children, so links can be created right away
     srcScene.EnumerateDescendants(srcParent, [&](const entt::entity srcEntity)
         {
-            const auto& srcTc = srcScene.get<TransformComponent>(srcEntity);
+            const entt::entity srcEntityParent = srcScene.get<HierarchyComponent>(srcEntity).GetParent();
 
-            entityMap.emplace(srcEntity, dstScene.CreateEntity(entt::null, srcTc.GetLocalTransform()));
-        });
+            const entt::entity parent = srcEntityParent == srcParent ? dstParent : entityMap.at(srcEntityParent);
 
-    for (const auto& [srcEntity, dstEntity] : entityMap)
-    {
-        const auto& srcHc = srcScene.get<HierarchyComponent>(srcEntity);
+            // Source and destination can be the same scene, so the transform is copied before emplacing
+            const Transform transform = srcScene.get<TransformComponent>(srcEntity).GetLocalTransform();
 
-        if (srcHc.GetParent() == srcParent)
-        {
-            dstScene.get<HierarchyComponent>(dstEntity).SetParent(dstParent);
-        }
-        else
-        {
-            dstScene.get<HierarchyComponent>(dstEntity).SetParent(entityMap.at(srcHc.GetParent()));
-        }
+            entityMap.emplace(srcEntity, dstScene.CreateEntity(parent, transform));
 
-        Details::CopyComponents(srcScene, dstScene, srcEntity, dstEntity, entityMap);
+            srcEntities.push_back(srcEntity);
+        });
+
+    for (const auto srcEntity : srcEntities)
+    {
+        Details::CopyComponents(srcScene, dstScene, srcEntity, entityMap.at(srcEntity), entityMap);
     }
 
     Details::CopyRootAnimationComponent(srcScene, dstScene, srcParent, dstParent, entityMap);
 }
 
-void SceneHelpers::MergeStorageComponents(Scene& srcScene, Scene& dstScene)
+StorageHandles SceneHelpers::MergeStorageComponents(Scene& srcScene, Scene& dstScene)
 {
+    StorageHandles handles;
+
     auto& srcTsc = srcScene.ctx().get<TextureStorageComponent>();
     auto& dstTsc = dstScene.ctx().get<TextureStorageComponent>();
 
-    dstTsc.updated = !srcTsc.textures.empty();
+    std::unordered_map<int32_t, int32_t> textureMap;
+
+    srcTsc.textures.Enumerate([&](TextureHandle srcHandle, Texture& texture)
+        {
+            const TextureHandle dstHandle = dstTsc.textures.Add(std::move(texture));
 
-    std::ranges::move(srcTsc.textures, std::back_inserter(dstTsc.textures));
+            textureMap.emplace(static_cast<int32_t>(srcHandle.index), static_cast<int32_t>(dstHandle.index));
+
+            handles.textures.push_back(dstHandle);
+        });
+
+    dstTsc.updated |= !handles.textures.empty();
 
     srcScene.ctx().erase<TextureStorageComponent>();
 
     auto& srcMsc = srcScene.ctx().get<MaterialStorageComponent>();
     auto& dstMsc = dstScene.ctx().get<MaterialStorageComponent>();
 
-    dstMsc.updated = !srcMsc.materials.empty();
+    Details::MaterialMap materialMap;
+
+    srcMsc.materials.Enumerate([&](MaterialHandle srcHandle, Material& material)
+        {
+            MaterialHelpers::RemapTextures(material, textureMap);
+
+            const MaterialHandle dstHandle = dstMsc.materials.Add(std::move(material));
+
+            materialMap.emplace(srcHandle.index, dstHandle);
+
+            handles.materials.push_back(dstHandle);
+
+            dstScene.InvalidateMaterial(dstHandle);
+        });
 
-    std::ranges::move(srcMsc.materials, std::back_inserter(dstMsc.materials));
+    dstMsc.updated |= !handles.materials.empty();
 
     srcScene.ctx().erase<MaterialStorageComponent>();
 
     auto& srcGsc = srcScene.ctx().get<GeometryStorageComponent>();
     auto& dstGsc = dstScene.ctx().get<GeometryStorageComponent>();
 
-    dstGsc.updated = !srcGsc.primitives.empty();
+    Details::PrimitiveMap primitiveMap;
 
-    std::ranges::move(srcGsc.primitives, std::back_inserter(dstGsc.primitives));
+    srcGsc.primitives.Enumerate([&](PrimitiveHandle srcHandle, Primitive& primitive)
+        {
+            const PrimitiveHandle dstHandle = dstGsc.primitives.Add(std::move(primitive));
+
+            primitiveMap.emplace(srcHandle.index, dstHandle);
+
+            handles.primitives.push_back(dstHandle);
+        });
+
+    dstGsc.updated |= !handles.primitives.empty();
 
     srcScene.ctx().erase<GeometryStorageComponent>();
+
+    Details::RemapRenderObjects(srcScene, primitiveMap, materialMap);
+
+    return handles;
 }
 
-void SceneHelpers::SplitStorageComponents(Scene& srcScene, Scene& dstScene, const StorageRange& range)
+void SceneHelpers::SplitStorageComponents(Scene& srcScene, Scene& dstScene, const StorageHandles& handles)
 {
     auto& srcTsc = srcScene.ctx().get<TextureStorageComponent>();
     auto& dstTsc = dstScene.ctx().emplace<TextureStorageComponent>();
 
-    srcTsc.updated = range.textures.size > 0;
-    dstTsc.updated = range.textures.size > 0;
+    std::unordered_map<int32_t, int32_t> textureMap;
+
+    for (const auto srcHandle : handles.textures)
+    {
+        // Free slot keeps valid texture because material texture descriptors are written for all slots
+        Texture texture = srcTsc.textures.Extract(srcHandle, TextureCache::GetTexture(DefaultTexture::eBlack));
 
-    Details::MoveRange(srcTsc.textures, dstTsc.textures, range.textures);
+        const TextureHandle dstHandle = dstTsc.textures.Add(std::move(texture));
+
+        textureMap.emplace(static_cast<int32_t>(srcHandle.index), static_cast<int32_t>(dstHandle.index));
+    }
+
+    srcTsc.updated |= !handles.textures.empty();
+    dstTsc.updated = !handles.textures.empty();
 
     auto& srcMsc = srcScene.ctx().get<MaterialStorageComponent>();
     auto& dstMsc = dstScene.ctx().emplace<MaterialStorageComponent>();
 
-    srcMsc.updated = range.materials.size > 0;
-    dstMsc.updated = range.materials.size > 0;
+    Details::MaterialMap materialMap;
+
+    for (const auto srcHandle : handles.materials)
+    {
+        Material material = srcMsc.materials.Extract(srcHandle, Material{});
+
+        MaterialHelpers::RemapTextures(material, textureMap);
+
+        materialMap.emplace(srcHandle.index, dstMsc.materials.Add(std::move(material)));
+    }
 
-    Details::MoveRange(srcMsc.materials, dstMsc.materials, range.materials);
+    srcMsc.updated |= !handles.materials.empty();
+    dstMsc.updated = !handles.materials.empty();
 
     auto& srcGsc = srcScene.ctx().get<GeometryStorageComponent>();
     auto& dstGsc = dstScene.ctx().emplace<GeometryStorageComponent>();
 
-    srcGsc.updated = range.primitives.size > 0;
-    dstGsc.updated = range.primitives.size > 0;
+    Details::PrimitiveMap primitiveMap;
+
+    for (const auto srcHandle : handles.primitives)
+    {
+        primitiveMap.emplace(srcHandle.index, dstGsc.primitives.Add(srcGsc.primitives.Extract(srcHandle)));
+    }
+
+    srcGsc.updated |= !handles.primitives.empty();
+    dstGsc.updated = !handles.primitives.empty();
 
-    Details::MoveRange(srcGsc.primitives, dstGsc.primitives, range.primitives);
+    Details::RemapRenderObjects(dstScene, primitiveMap, materialMap);
+}
+
+RenderObject SceneHelpers::GetInstanceRenderObject(const SharedInstanceComponent& sic, const RenderObject& ro)
+{
+    if (sic.materialOverride.IsValid())
+    {
+        return RenderObject{ ro.primitive, sic.materialOverride };
+    }
+
+    return ro;
+}
+
+void SceneHelpers::EnumerateRenderObjects(const Scene& scene, entt::entity entity, const SceneRenderFunc& func)
+{
+    const glm::mat4 transform = scene.get<TransformComponent>(entity).GetWorldTransform().GetMatrix();
+
+    if (const auto* rc = scene.try_get<RenderComponent>(entity))
+    {
+        for (const auto& ro : rc->renderObjects)
+        {
+            func(transform, ro);
+        }
+    }
+
+    if (const auto* sic = scene.try_get<SharedInstanceComponent>(entity))
+    {
+        const auto& prefab = scene.get<ScenePrefabComponent>(sic->prefab);
+
+        for (const auto& [nodeTransform, ro] : prefab.renderNodes)
+        {
+            func(transform * nodeTransform, GetInstanceRenderObject(*sic, ro));
+        }
+    }
 }
 
 vk::AccelerationStructureInstanceKHR SceneHelpers::GetTlasInstance(
-        const Scene& scene, const TransformComponent& tc, const RenderObject& ro)
+        const Scene& scene, const glm::mat4& transform, const RenderObject& ro)
 {
     const auto& geometryComponent = scene.ctx().get<GeometryStorageComponent>();
     const auto& materialComponent = scene.ctx().get<MaterialStorageComponent>();
 
     vk::TransformMatrixKHR transformMatrix;
 
-    const glm::mat4 transposedTransform = glm::transpose(tc.GetWorldTransform().GetMatrix());
+    const glm::mat4 transposedTransform = glm::transpose(transform);
 
     std::memcpy(&transformMatrix.matrix, &transposedTransform, sizeof(vk::TransformMatrixKHR));
 
-    Assert(ro.primitive <= static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()));
-    Assert(ro.material <= static_cast<uint32_t>(std::numeric_limits<uint8_t>::max()));
+    Assert(ro.primitive.index <= static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()));
+    Assert(ro.material.index <= static_cast<uint32_t>(std::numeric_limits<uint8_t>::max()));
 
-    const uint32_t customIndex = ro.primitive | (ro.material << 16);
+    const uint32_t customIndex = ro.primitive.index | (ro.material.index << 16);
 
     const Material& material = materialComponent.materials[ro.material];
 
@@ -583,7 +583,10 @@ void SceneLoader::AddTextureStorageComponent() const
 
     auto& tsc = scene.ctx().emplace<TextureStorageComponent>();
 
-    tsc.textures = Details::LoadTextures(*model, sceneDirectory);
+    for (Texture& texture : Details::LoadTextures(*model, sceneDirectory))
+    {
+        tsc.textures.Add(std::move(texture));
+    }
 }
 
 void SceneLoader::AddMaterialStorageComponent() const
@@ -592,11 +595,9 @@ void SceneLoader::AddMaterialStorageComponent() const
 
     auto& msc = scene.ctx().emplace<MaterialStorageComponent>();
 
-    msc.materials.reserve(model->materials.size());
-
     for (const auto& material : model->materials)
     {
-        msc.materials.push_back(Details::RetrieveMaterial(material));
+        msc.materials.Add(Details::RetrieveMaterial(material));
     }
 }
 
@@ -606,13 +607,11 @@ void SceneLoader::AddGeometryStorageComponent() const
 
     auto& gsc = scene.ctx().emplace<GeometryStorageComponent>();
 
-    gsc.primitives.reserve(model->meshes.size());
-
     for (const auto& mesh : model->meshes)
     {
         for (const auto& primitive : mesh.primitives)
         {
-            gsc.primitives.emplace_back(Details::RetrievePrimitive(*model, primitive));
+            gsc.primitives.Add(Details::RetrievePrimitive(*model, primitive));
         }
     }
 }
@@ -670,6 +669,13 @@ SceneLoader::EntityMap SceneLoader::AddEntities() const
                 scene.EmplaceSceneInstance(scene.FindEntity(name), entity);
             }
 
+            if (node.extras.Has("sharedInstance"))
+            {
+                const std::string name = node.extras.Get("sharedInstance").Get<std::string>();
+
+                scene.EmplaceSharedInstance(scene.FindEntity(name), entity);
+            }
+
             if (node.extras.Has("sceneSpawn"))
             {
                 const std::string name = node.extras.Get("sceneSpawn").Get<std::string>();
@@ -687,6 +693,9 @@ void SceneLoader::AddRenderComponent(entt::entity entity, const tinygltf::Node&
 {
     EASY_FUNCTION()
 
+    const auto& gsc = scene.ctx().get<GeometryStorageComponent>();
+    const auto& msc = scene.ctx().get<MaterialStorageComponent>();
+
     auto& rc = scene.emplace<RenderComponent>(entity);
 
     const tinygltf::Mesh& mesh = model->meshes[node.mesh];
@@ -705,8 +714,8 @@ void SceneLoader::AddRenderComponent(entt::entity entity, const tinygltf::Node&
 
         Assert(primitive.material >= 0);
 
-        rc.renderObjects[i].primitive = static_cast<uint32_t>(meshOffset + i);
-        rc.renderObjects[i].material = static_cast<uint32_t>(primitive.material);
+        rc.renderObjects[i].primitive = gsc.primitives.GetHandle(static_cast<uint32_t>(meshOffset + i));
+        rc.renderObjects[i].material = msc.materials.GetHandle(static_cast<uint32_t>(primitive.material));
     }
 }
 
@@ -0,0 +1,914 @@
+#include "Engine/Scene/SceneSnapshot.hpp"
+
+#include "Engine/Filesystem/Filesystem.hpp"
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Resources/BufferHelpers.hpp"
+#include "Engine/Render/Vulkan/Resources/ResourceContext.hpp"
+#include "Engine/Render/Vulkan/Resources/TextureCache.hpp"
+#include "Engine/Scene/Components/Components.hpp"
+#include "Engine/Scene/Components/AnimationComponent.hpp"
+#include "Engine/Scene/Components/CameraComponent.hpp"
+#include "Engine/Scene/Components/EnvironmentComponent.hpp"
+#include "Engine/Scene/GlobalIllumination.hpp"
+#include "Engine/Scene/Scene.hpp"
+
+#include "Utils/Logger.hpp"
+#include "Utils/TimeHelpers.hpp"
+
+#include <json.hpp>
+
+namespace Details
+{
+    static constexpr uint32_t kMagic = 0x504E5353;
+    static constexpr uint32_t kVersion = 1;
+
+    static constexpr size_t kAlignment = 16;
+    static constexpr size_t kArrayHeaderSize = 16;
+
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    static const std::string kSnapshotExtension(".snapshot");
+
+    static bool IsExternalUri(const std::string& uri)
+    {
+        return !uri.empty() && uri.find("data:") != 0;
+    }
+
+    // Every file SceneLoader reads for the scene: glTF itself, buffers, images and environment panoramas
+    static std::vector<Filepath> GetSourceFiles(const Filepath& scenePath)
+    {
+        std::vector<Filepath> sourceFiles{ scenePath };
+
+        const nlohmann::json json = nlohmann::json::parse(Filesystem::ReadFile(scenePath), nullptr, false);
+
+        if (json.is_discarded())
+        {
+            return sourceFiles;
+        }
+
+        const Filepath sceneDirectory(scenePath.GetDirectory());
+
+        for (const char* key : { "buffers", "images" })
+        {
+            for (const auto& item : json.value(key, nlohmann::json::array()))
+            {
+                const std::string uri = item.value("uri", std::string());
+
+                if (IsExternalUri(uri))
+                {
+                    sourceFiles.push_back(sceneDirectory / Filepath(uri));
+                }
+            }
+        }
+
+        for (const auto& node : json.value("nodes", nlohmann::json::array()))
+        {
+            const nlohmann::json extras = node.value("extras", nlohmann::json::object());
+
+            if (extras.contains("environment") && extras["environment"].is_string())
+            {
+                sourceFiles.emplace_back(extras["environment"].get<std::string>());
+            }
+        }
+
+        return sourceFiles;
+    }
+
+    struct Header
+    {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        float sourceLoadSeconds = 0.0f;
+        uint32_t cameraEntity = kInvalidIndex;
+        uint32_t environmentEntity = kInvalidIndex;
+    };
+
+    struct StringRecord
+    {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    struct TextureRecord
+    {
+        StringRecord path;
+        SamplerDescription sampler;
+        uint32_t hasSampler = 0;
+    };
+
+    struct MaterialRecord
+    {
+        gpu::Material data;
+        DefaultMask flags = 0;
+    };
+
+    struct PrimitiveRecord
+    {
+        uint32_t indexCount = 0;
+        uint32_t positionCount = 0;
+        uint32_t normalCount = 0;
+        uint32_t tangentCount = 0;
+        uint32_t texCoordCount = 0;
+    };
+
+    struct NameRecord
+    {
+        uint32_t entity = kInvalidIndex;
+        StringRecord name;
+    };
+
+    struct RenderRecord
+    {
+        uint32_t entity = kInvalidIndex;
+        uint32_t objectOffset = 0;
+        uint32_t objectCount = 0;
+    };
+
+    struct RenderObjectRecord
+    {
+        uint32_t primitive = 0;
+        uint32_t material = 0;
+    };
+
+    struct CameraRecord
+    {
+        uint32_t entity = kInvalidIndex;
+        CameraLocation location;
+        CameraProjection projection;
+    };
+
+    struct LightRecord
+    {
+        uint32_t entity = kInvalidIndex;
+        LightType type = LightType::ePoint;
+        LinearColor color;
+    };
+
+    struct EnvironmentRecord
+    {
+        uint32_t entity = kInvalidIndex;
+        StringRecord panoramaPath;
+    };
+
+    struct AnimationRecord
+    {
+        uint32_t owner = kInvalidIndex;
+        StringRecord name;
+        uint32_t trackOffset = 0;
+        uint32_t trackCount = 0;
+        float time = 0.0f;
+        float duration = 0.0f;
+        float speed = 1.0f;
+        uint32_t active = 0;
+        uint32_t looped = 0;
+        uint32_t reverse = 0;
+    };
+
+    struct TrackRecord
+    {
+        uint32_t target = kInvalidIndex;
+        AnimatedProperty property = AnimatedProperty::eTranslation;
+        AnimationInterpolation interpolation = AnimationInterpolation::eLinear;
+        uint32_t keyFrameOffset = 0;
+        uint32_t keyFrameCount = 0;
+    };
+
+    // Arrays are written in the same order by WriteSnapshot and read back by ReadSnapshot
+    template <template <class> class TArray>
+    struct SnapshotArrays
+    {
+        TArray<Header> header;
+        TArray<TextureRecord> textures;
+        TArray<MaterialRecord> materials;
+        TArray<PrimitiveRecord> primitives;
+        TArray<uint32_t> indices;
+        TArray<glm::vec3> positions;
+        TArray<glm::vec3> normals;
+        TArray<glm::vec3> tangents;
+        TArray<glm::vec2> texCoords;
+        TArray<uint32_t> parents;
+        TArray<glm::mat4> transforms;
+        TArray<NameRecord> names;
+        TArray<RenderRecord> renders;
+        TArray<RenderObjectRecord> renderObjects;
+        TArray<CameraRecord> cameras;
+        TArray<LightRecord> lights;
+        TArray<EnvironmentRecord> environments;
+        TArray<AnimationRecord> animations;
+        TArray<TrackRecord> tracks;
+        TArray<AnimationKeyFrame> keyFrames;
+        TArray<glm::vec3> probePositions;
+        TArray<uint32_t> probeEdgeIndices;
+        TArray<uint8_t> probeCoefficients;
+        TArray<char> strings;
+    };
+
+    template <class T>
+    using Vector = std::vector<T>;
+
+    using SnapshotData = SnapshotArrays<Vector>;
+    using SnapshotView = SnapshotArrays<DataView>;
+
+    static size_t Align(size_t offset)
+    {
+        return (offset + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    class SnapshotWriter
+    {
+    public:
+        template <class T>
+        void Write(const std::vector<T>& data)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            const uint64_t size = data.size() * sizeof(T);
+            const size_t offset = bytes.size();
+
+            bytes.resize(Align(offset + kArrayHeaderSize + size));
+
+            std::memcpy(bytes.data() + offset, &size, sizeof(uint64_t));
+
+            if (size > 0)
+            {
+                std::memcpy(bytes.data() + offset + kArrayHeaderSize, data.data(), size);
+            }
+        }
+
+        ByteView GetByteView() const
+        {
+            return ByteView(bytes);
+        }
+
+    private:
+        Bytes bytes;
+    };
+
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(const Bytes& bytes_)
+            : bytes(bytes_)
+        {}
+
+        bool IsValid() const { return valid; }
+
+        // Returned view points to the snapshot bytes, nothing is copied
+        template <class T>
+        void Read(DataView<T>& view)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            view = DataView<T>();
+
+            if (!valid || offset + kArrayHeaderSize > bytes.size())
+            {
+                valid = false;
+                return;
+            }
+
+            uint64_t size;
+            std::memcpy(&size, bytes.data() + offset, sizeof(uint64_t));
+
+            offset += kArrayHeaderSize;
+
+            if (size > bytes.size() - offset || size % sizeof(T) != 0)
+            {
+                valid = false;
+                return;
+            }
+
+            view = DataView<T>(reinterpret_cast<const T*>(bytes.data() + offset), size / sizeof(T));
+
+            offset = Align(offset + size);
+        }
+
+    private:
+        const Bytes& bytes;
+
+        size_t offset = 0;
+
+        bool valid = true;
+    };
+
+    static void WriteSnapshot(SnapshotWriter& writer, const SnapshotData& data)
+    {
+        writer.Write(data.header);
+        writer.Write(data.textures);
+        writer.Write(data.materials);
+        writer.Write(data.primitives);
+        writer.Write(data.indices);
+        writer.Write(data.positions);
+        writer.Write(data.normals);
+        writer.Write(data.tangents);
+        writer.Write(data.texCoords);
+        writer.Write(data.parents);
+        writer.Write(data.transforms);
+        writer.Write(data.names);
+        writer.Write(data.renders);
+        writer.Write(data.renderObjects);
+        writer.Write(data.cameras);
+        writer.Write(data.lights);
+        writer.Write(data.environments);
+        writer.Write(data.animations);
+        writer.Write(data.tracks);
+        writer.Write(data.keyFrames);
+        writer.Write(data.probePositions);
+        writer.Write(data.probeEdgeIndices);
+        writer.Write(data.probeCoefficients);
+        writer.Write(data.strings);
+    }
+
+    static void ReadSnapshot(SnapshotReader& reader, SnapshotView& view)
+    {
+        reader.Read(view.header);
+        reader.Read(view.textures);
+        reader.Read(view.materials);
+        reader.Read(view.primitives);
+        reader.Read(view.indices);
+        reader.Read(view.positions);
+        reader.Read(view.normals);
+        reader.Read(view.tangents);
+        reader.Read(view.texCoords);
+        reader.Read(view.parents);
+        reader.Read(view.transforms);
+        reader.Read(view.names);
+        reader.Read(view.renders);
+        reader.Read(view.renderObjects);
+        reader.Read(view.cameras);
+        reader.Read(view.lights);
+        reader.Read(view.environments);
+        reader.Read(view.animations);
+        reader.Read(view.tracks);
+        reader.Read(view.keyFrames);
+        reader.Read(view.probePositions);
+        reader.Read(view.probeEdgeIndices);
+        reader.Read(view.probeCoefficients);
+        reader.Read(view.strings);
+    }
+
+    static StringRecord AddString(std::vector<char>& strings, const std::string& string)
+    {
+        const StringRecord record{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(string.size()) };
+
+        strings.insert(strings.end(), string.begin(), string.end());
+
+        return record;
+    }
+
+    static std::string GetString(const DataView<char>& strings, const StringRecord& record)
+    {
+        Assert(record.offset + record.size <= strings.size);
+
+        return std::string(strings.data + record.offset, record.size);
+    }
+
+    template <class T>
+    static std::vector<T> GetRange(const DataView<T>& data, size_t& offset, uint32_t count)
+    {
+        Assert(offset + count <= data.size);
+
+        std::vector<T> range(data.data + offset, data.data + offset + count);
+
+        offset += count;
+
+        return range;
+    }
+
+    // Buffer is copied to temporary staging buffer, so it doesn't need persistent one only for saving
+    static Bytes ReadBufferData(vk::Buffer buffer)
+    {
+        const vk::DeviceSize size = ResourceContext::GetBufferDescription(buffer).size;
+
+        const vk::Buffer stagingBuffer = BufferHelpers::CreateStagingBuffer(size);
+
+        VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
+            {
+                const vk::BufferCopy region(0, 0, size);
+
+                commandBuffer.copyBuffer(buffer, stagingBuffer, { region });
+            });
+
+        const ByteAccess data = VulkanContext::memoryManager->GetMappedMemory(stagingBuffer);
+
+        Bytes bytes(data.data, data.data + size);
+
+        VulkanContext::memoryManager->DestroyBuffer(stagingBuffer);
+
+        return bytes;
+    }
+
+    static bool ExtractStorages(const Scene& scene, SnapshotData& data,
+            std::unordered_map<uint32_t, uint32_t>& primitiveIndices,
+            std::unordered_map<uint32_t, uint32_t>& materialIndices)
+    {
+        const auto& tsc = scene.ctx().get<TextureStorageComponent>();
+        const auto& msc = scene.ctx().get<MaterialStorageComponent>();
+        const auto& gsc = scene.ctx().get<GeometryStorageComponent>();
+
+        std::unordered_map<int32_t, int32_t> textureIndices;
+
+        bool texturesResolved = true;
+
+        tsc.textures.Enumerate([&](TextureHandle handle, const Texture& texture)
+            {
+                const std::optional<Filepath> texturePath = TextureCache::FindTexturePath(texture.image);
+
+                if (!texturePath)
+                {
+                    texturesResolved = false;
+                    return;
+                }
+
+                const std::optional<SamplerDescription> sampler = TextureCache::FindSamplerDescription(texture.sampler);
+
+                textureIndices.emplace(static_cast<int32_t>(handle.index), static_cast<int32_t>(data.textures.size()));
+
+                data.textures.push_back(TextureRecord{
+                    AddString(data.strings, texturePath->GetAbsolute()),
+                    sampler.value_or(SamplerDescription{}),
+                    sampler.has_value()
+                });
+            });
+
+        if (!texturesResolved)
+        {
+            return false;
+        }
+
+        msc.materials.Enumerate([&](MaterialHandle handle, const Material& material)
+            {
+                Material remappedMaterial = material;
+
+                MaterialHelpers::RemapTextures(remappedMaterial, textureIndices);
+
+                materialIndices.emplace(handle.index, static_cast<uint32_t>(data.materials.size()));
+
+                data.materials.push_back(MaterialRecord{
+                    remappedMaterial.data, static_cast<DefaultMask>(remappedMaterial.flags)
+                });
+            });
+
+        gsc.primitives.Enumerate([&](PrimitiveHandle handle, const Primitive& primitive)
+            {
+                primitiveIndices.emplace(handle.index, static_cast<uint32_t>(data.primitives.size()));
+
+                data.primitives.push_back(PrimitiveRecord{
+                    static_cast<uint32_t>(primitive.GetIndices().size()),
+                    static_cast<uint32_t>(primitive.GetPositions().size()),
+                    static_cast<uint32_t>(primitive.GetNormals().size()),
+                    static_cast<uint32_t>(primitive.GetTangents().size()),
+                    static_cast<uint32_t>(primitive.GetTexCoords().size())
+                });
+
+                std::ranges::copy(primitive.GetIndices(), std::back_inserter(data.indices));
+                std::ranges::copy(primitive.GetPositions(), std::back_inserter(data.positions));
+                std::ranges::copy(primitive.GetNormals(), std::back_inserter(data.normals));
+                std::ranges::copy(primitive.GetTangents(), std::back_inserter(data.tangents));
+                std::ranges::copy(primitive.GetTexCoords(), std::back_inserter(data.texCoords));
+            });
+
+        return true;
+    }
+
+    static void ExtractAnimations(const AnimationComponent& ac, uint32_t owner,
+            const std::unordered_map<entt::entity, uint32_t>& entityIndices, SnapshotData& data)
+    {
+        for (const auto& animation : ac.animations)
+        {
+            data.animations.push_back(AnimationRecord{
+                owner,
+                AddString(data.strings, animation.name),
+                static_cast<uint32_t>(data.tracks.size()),
+                static_cast<uint32_t>(animation.tracks.size()),
+                animation.time,
+                animation.duration,
+                animation.speed,
+                animation.active,
+                animation.looped,
+                animation.reverse
+            });
+
+            for (const auto& track : animation.tracks)
+            {
+                data.tracks.push_back(TrackRecord{
+                    entityIndices.at(track.target),
+                    track.property,
+                    track.interpolation,
+                    static_cast<uint32_t>(data.keyFrames.size()),
+                    static_cast<uint32_t>(track.keyFrames.size())
+                });
+
+                std::ranges::copy(track.keyFrames, std::back_inserter(data.keyFrames));
+            }
+        }
+    }
+
+    static void ExtractEntities(const Scene& scene, SnapshotData& data,
+            const std::unordered_map<uint32_t, uint32_t>& primitiveIndices,
+            const std::unordered_map<uint32_t, uint32_t>& materialIndices)
+    {
+        Header& header = data.header.front();
+
+        std::vector<entt::entity> entities;
+        std::unordered_map<entt::entity, uint32_t> entityIndices;
+
+        // Parents are enumerated before children, so they can be created in the same order
+        scene.EnumerateHierarchy([&](entt::entity entity)
+            {
+                entityIndices.emplace(entity, static_cast<uint32_t>(entities.size()));
+
+                entities.push_back(entity);
+            });
+
+        const CameraComponent* sceneCamera = scene.ctx().find<CameraComponent>();
+        const EnvironmentComponent* sceneEnvironment = scene.ctx().find<EnvironmentComponent>();
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); ++i)
+        {
+            const entt::entity entity = entities[i];
+
+            const entt::entity parent = scene.get<HierarchyComponent>(entity).GetParent();
+
+            data.parents.push_back(parent != entt::null ? entityIndices.at(parent) : kInvalidIndex);
+            data.transforms.push_back(scene.get<TransformComponent>(entity).GetLocalTransform().GetMatrix());
+
+            if (const auto* nc = scene.try_get<NameComponent>(entity))
+            {
+                data.names.push_back(NameRecord{ i, AddString(data.strings, nc->name) });
+            }
+
+            if (const auto* rc = scene.try_get<RenderComponent>(entity))
+            {
+                data.renders.push_back(RenderRecord{
+                    i,
+                    static_cast<uint32_t>(data.renderObjects.size()),
+                    static_cast<uint32_t>(rc->renderObjects.size())
+                });
+
+                for (const auto& ro : rc->renderObjects)
+                {
+                    data.renderObjects.push_back(RenderObjectRecord{
+                        primitiveIndices.at(ro.primitive.index),
+                        materialIndices.at(ro.material.index)
+                    });
+                }
+            }
+
+            if (const auto* cc = scene.try_get<CameraComponent>(entity))
+            {
+                data.cameras.push_back(CameraRecord{ i, cc->location, cc->projection });
+
+                if (cc == sceneCamera)
+                {
+                    header.cameraEntity = i;
+                }
+            }
+
+            if (const auto* lc = scene.try_get<LightComponent>(entity))
+            {
+                data.lights.push_back(LightRecord{ i, lc->type, lc->color });
+            }
+
+            if (const auto* ec = scene.try_get<EnvironmentComponent>(entity))
+            {
+                data.environments.push_back(EnvironmentRecord{
+                    i, AddString(data.strings, ec->panoramaPath.GetAbsolute())
+                });
+
+                if (ec == sceneEnvironment)
+                {
+                    header.environmentEntity = i;
+                }
+            }
+
+            if (const auto* ac = scene.try_get<AnimationComponent>(entity))
+            {
+                ExtractAnimations(*ac, i, entityIndices, data);
+            }
+        }
+
+        if (const auto* ac = scene.ctx().find<AnimationComponent>())
+        {
+            ExtractAnimations(*ac, kInvalidIndex, entityIndices, data);
+        }
+    }
+
+    static void ExtractLightVolume(const Scene& scene, SnapshotData& data)
+    {
+        if (const auto* lvc = scene.ctx().find<LightVolumeComponent>())
+        {
+            data.probePositions = lvc->positions;
+            data.probeEdgeIndices = lvc->edgeIndices;
+            data.probeCoefficients = ReadBufferData(lvc->coefficientsBuffer);
+        }
+    }
+
+    static void AddStorageComponents(Scene& scene, const SnapshotView& view)
+    {
+        auto& tsc = scene.ctx().emplace<TextureStorageComponent>();
+
+        for (size_t i = 0; i < view.textures.size; ++i)
+        {
+            const TextureRecord& record = view.textures[i];
+
+            Texture texture = TextureCache::GetTexture(Filepath(GetString(view.strings, record.path)));
+
+            if (record.hasSampler)
+            {
+                texture.sampler = TextureCache::GetSampler(record.sampler);
+            }
+
+            tsc.textures.Add(std::move(texture));
+        }
+
+        auto& msc = scene.ctx().emplace<MaterialStorageComponent>();
+
+        for (size_t i = 0; i < view.materials.size; ++i)
+        {
+            const MaterialRecord& record = view.materials[i];
+
+            msc.materials.Add(Material{ record.data, MaterialFlags(record.flags) });
+        }
+
+        auto& gsc = scene.ctx().emplace<GeometryStorageComponent>();
+
+        size_t indexOffset = 0;
+        size_t positionOffset = 0;
+        size_t normalOffset = 0;
+        size_t tangentOffset = 0;
+        size_t texCoordOffset = 0;
+
+        for (size_t i = 0; i < view.primitives.size; ++i)
+        {
+            const PrimitiveRecord& record = view.primitives[i];
+
+            gsc.primitives.Add(Primitive(
+                    GetRange(view.indices, indexOffset, record.indexCount),
+                    GetRange(view.positions, positionOffset, record.positionCount),
+                    GetRange(view.normals, normalOffset, record.normalCount),
+                    GetRange(view.tangents, tangentOffset, record.tangentCount),
+                    GetRange(view.texCoords, texCoordOffset, record.texCoordCount)));
+        }
+    }
+
+    static std::vector<entt::entity> AddEntities(Scene& scene, const SnapshotView& view)
+    {
+        std::vector<entt::entity> entities(view.parents.size);
+
+        for (size_t i = 0; i < view.parents.size; ++i)
+        {
+            const entt::entity parent = view.parents[i] != kInvalidIndex ? entities[view.parents[i]] : entt::null;
+
+            entities[i] = scene.CreateEntity(parent, Transform(view.transforms[i]));
+        }
+
+        for (size_t i = 0; i < view.names.size; ++i)
+        {
+            const NameRecord& record = view.names[i];
+
+            scene.emplace<NameComponent>(entities[record.entity], GetString(view.strings, record.name));
+        }
+
+        const auto& gsc = scene.ctx().get<GeometryStorageComponent>();
+        const auto& msc = scene.ctx().get<MaterialStorageComponent>();
+
+        for (size_t i = 0; i < view.renders.size; ++i)
+        {
+            const RenderRecord& record = view.renders[i];
+
+            auto& rc = scene.emplace<RenderComponent>(entities[record.entity]);
+
+            rc.renderObjects.resize(record.objectCount);
+
+            for (uint32_t j = 0; j < record.objectCount; ++j)
+            {
+                const RenderObjectRecord& ro = view.renderObjects[record.objectOffset + j];
+
+                rc.renderObjects[j].primitive = gsc.primitives.GetHandle(ro.primitive);
+                rc.renderObjects[j].material = msc.materials.GetHandle(ro.material);
+            }
+        }
+
+        for (size_t i = 0; i < view.cameras.size; ++i)
+        {
+            const CameraRecord& record = view.cameras[i];
+
+            auto& cc = scene.emplace<CameraComponent>(entities[record.entity]);
+
+            cc.location = record.location;
+            cc.projection = record.projection;
+
+            cc.viewMatrix = CameraHelpers::ComputeViewMatrix(cc.location);
+            cc.projMatrix = CameraHelpers::ComputeProjMatrix(cc.projection);
+        }
+
+        for (size_t i = 0; i < view.lights.size; ++i)
+        {
+            const LightRecord& record = view.lights[i];
+
+            scene.emplace<LightComponent>(entities[record.entity], record.type, record.color);
+        }
+
+        for (size_t i = 0; i < view.environments.size; ++i)
+        {
+            const EnvironmentRecord& record = view.environments[i];
+
+            const Filepath panoramaPath(GetString(view.strings, record.panoramaPath));
+
+            scene.emplace<EnvironmentComponent>(entities[record.entity],
+                    EnvironmentHelpers::LoadEnvironment(panoramaPath));
+        }
+
+        const Header& header = view.header[0];
+
+        if (header.cameraEntity != kInvalidIndex)
+        {
+            scene.ctx().emplace<CameraComponent&>(scene.get<CameraComponent>(entities[header.cameraEntity]));
+        }
+
+        if (header.environmentEntity != kInvalidIndex)
+        {
+            scene.ctx().emplace<EnvironmentComponent&>(scene.get<EnvironmentComponent>(entities[header.environmentEntity]));
+        }
+
+        return entities;
+    }
+
+    static void AddAnimationComponents(Scene& scene, const SnapshotView& view,
+            const std::vector<entt::entity>& entities)
+    {
+        scene.ctx().emplace<AnimationComponent>();
+
+        for (size_t i = 0; i < view.animations.size; ++i)
+        {
+            const AnimationRecord& record = view.animations[i];
+
+            AnimationComponent& ac = record.owner != kInvalidIndex
+                    ? scene.get_or_emplace<AnimationComponent>(entities[record.owner])
+                    : scene.ctx().get<AnimationComponent>();
+
+            Animation& animation = ac.animations.emplace_back();
+
+            animation.name = GetString(view.strings, record.name);
+            animation.time = record.time;
+            animation.duration = record.duration;
+            animation.speed = record.speed;
+            animation.active = record.active;
+            animation.looped = record.looped;
+            animation.reverse = record.reverse;
+
+            animation.tracks.resize(record.trackCount);
+
+            for (uint32_t j = 0; j < record.trackCount; ++j)
+            {
+                const TrackRecord& trackRecord = view.tracks[record.trackOffset + j];
+
+                AnimationTrack& track = animation.tracks[j];
+
+                track.target = entities[trackRecord.target];
+                track.property = trackRecord.property;
+                track.interpolation = trackRecord.interpolation;
+
+                const AnimationKeyFrame* keyFrames = view.keyFrames.data + trackRecord.keyFrameOffset;
+
+                track.keyFrames.assign(keyFrames, keyFrames + trackRecord.keyFrameCount);
+            }
+        }
+    }
+
+    static void AddLightVolumeComponent(Scene& scene, const SnapshotView& view)
+    {
+        if (view.probePositions.size == 0)
+        {
+            return;
+        }
+
+        // Buffers mirror the ones created by GlobalIllumination::GenerateLightVolume
+        const vk::Buffer positionsBuffer = ResourceContext::CreateBuffer({
+            .type = BufferType::eStorage,
+            .initialData = view.probePositions.GetByteView()
+        });
+
+        const vk::Buffer tetrahedralBuffer = ResourceContext::CreateBuffer({
+            .type = BufferType::eStorage,
+            .initialData = view.probePositions.GetByteView()
+        });
+
+        const vk::Buffer coefficientsBuffer = ResourceContext::CreateBuffer({
+            .type = BufferType::eStorage,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc,
+            .initialData = view.probeCoefficients
+        });
+
+        scene.ctx().emplace<LightVolumeComponent>(LightVolumeComponent{
+            positionsBuffer, tetrahedralBuffer, coefficientsBuffer,
+            view.probePositions.GetCopy(), view.probeEdgeIndices.GetCopy()
+        });
+    }
+}
+
+Filepath SceneSnapshot::GetSnapshotPath(const Filepath& scenePath)
+{
+    return Filepath(scenePath.GetAbsolute() + Details::kSnapshotExtension);
+}
+
+bool SceneSnapshot::IsUpToDate(const Filepath& scenePath, const Filepath& snapshotPath)
+{
+    if (!snapshotPath.Exists() || !scenePath.Exists())
+    {
+        return false;
+    }
+
+    const auto snapshotTime = std::filesystem::last_write_time(snapshotPath.GetAbsolute());
+
+    // Missing source file means the scene was changed as well, it's reloaded from glTF then
+    return std::ranges::all_of(Details::GetSourceFiles(scenePath), [&](const Filepath& sourceFile)
+        {
+            return sourceFile.Exists() && std::filesystem::last_write_time(sourceFile.GetAbsolute()) <= snapshotTime;
+        });
+}
+
+bool SceneSnapshot::Save(const Scene& scene, const Filepath& path, float sourceLoadSeconds)
+{
+    EASY_FUNCTION()
+
+    if (!scene.view<ScenePrefabComponent>().empty() || !scene.view<SharedInstanceComponent>().empty())
+    {
+        LogW << "Scene snapshot isn't saved, scene prefabs aren't supported: " << path.GetAbsolute() << "\n";
+        return false;
+    }
+
+    Details::SnapshotData data;
+
+    data.header.push_back(Details::Header{ .sourceLoadSeconds = sourceLoadSeconds });
+
+    std::unordered_map<uint32_t, uint32_t> primitiveIndices;
+    std::unordered_map<uint32_t, uint32_t> materialIndices;
+
+    if (!Details::ExtractStorages(scene, data, primitiveIndices, materialIndices))
+    {
+        LogW << "Scene snapshot isn't saved, scene contains textures without source: " << path.GetAbsolute() << "\n";
+        return false;
+    }
+
+    Details::ExtractEntities(scene, data, primitiveIndices, materialIndices);
+
+    Details::ExtractLightVolume(scene, data);
+
+    Details::SnapshotWriter writer;
+
+    Details::WriteSnapshot(writer, data);
+
+    if (!Filesystem::WriteBinaryFile(path, writer.GetByteView()))
+    {
+        LogE << "Failed to save scene snapshot: " << path.GetAbsolute() << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool SceneSnapshot::Load(Scene& scene, const Filepath& path)
+{
+    EASY_FUNCTION()
+
+    Timer timer;
+    timer.Tick();
+
+    const Bytes bytes = Filesystem::ReadBinaryFile(path);
+
+    Details::SnapshotReader reader(bytes);
+
+    Details::SnapshotView view;
+
+    Details::ReadSnapshot(reader, view);
+
+    if (!reader.IsValid() || view.header.size != 1)
+    {
+        return false;
+    }
+
+    const Details::Header& header = view.header[0];
+
+    if (header.magic != Details::kMagic || header.version != Details::kVersion)
+    {
+        return false;
+    }
+
+    Details::AddStorageComponents(scene, view);
+
+    const std::vector<entt::entity> entities = Details::AddEntities(scene, view);
+
+    Details::AddAnimationComponents(scene, view, entities);
+
+    Details::AddLightVolumeComponent(scene, view);
+
+    const float loadSeconds = timer.Tick();
+
+    LogI << "Scene loaded from snapshot in " << loadSeconds / Metric::kMili << " ms, glTF load took "
+            << header.sourceLoadSeconds / Metric::kMili << " ms ("
+            << header.sourceLoadSeconds / std::max(loadSeconds, Metric::kMicro) << "x)\n";
+
+    return true;
+}
@@ -2,28 +2,61 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "Engine/Scene/SceneHelpers.hpp"
 #include "Engine/Filesystem/Filepath.hpp"
 
+#include "Utils/DynamicBvh.hpp"
+
 class Transform;
+struct Ray;
 
 class Scene : public entt::registry
 {
 public:
+    using NameIndex = std::unordered_multimap<std::string, entt::entity, StringHash, std::equal_to<>>;
+    using NameRange = std::pair<NameIndex::const_iterator, NameIndex::const_iterator>;
+
     Scene();
     Scene(const Filepath& path);
 
     ~Scene();
 
+    // Depth-first order, scans hierarchy storage if it's sorted and walks links otherwise
     void EnumerateHierarchy(const SceneEntityFunc& func) const;
 
     void EnumerateDescendants(entt::entity entity, const SceneEntityFunc& func) const;
 
+    void EnumerateChildren(entt::entity entity, const SceneEntityFunc& func) const;
+
     void EnumerateAncestors(entt::entity entity, const SceneEntityFunc& func) const;
 
     entt::entity FindRootParent(entt::entity entity) const;
 
-    entt::entity FindEntity(const std::string& name) const;
+    entt::entity FindEntity(std::string_view name) const;
+
+    NameRange FindEntities(std::string_view name) const;
+
+    // Leaves store entities with RenderComponent, pending bounds updates are applied on access
+    const DynamicBvh& GetBvh() const;
+
+    void InvalidateTransform(entt::entity entity);
+
+    // Material edits have to be reported to reach GPU material buffer
+    void InvalidateMaterial(MaterialHandle material);
+
+    // Returns changes accumulated since the previous call
+    SceneChanges ConsumeChanges();
+
+    // Builds missing triangle BVHs of scene primitives in parallel
+    void BuildTriangleBvhs() const;
+
+    // Generates missing BLASes of scene primitives in batched submits
+    void GenerateBlases();
+
+    std::optional<RayHit> CastRay(const Ray& ray, RayCastMode mode = RayCastMode::eClosestHit) const;
 
     entt::entity CreateEntity(entt::entity parent, const Transform& transform);
 
@@ -35,14 +68,62 @@ public:
 
     void RemoveChildren(entt::entity entity);
 
+    void SetParent(entt::entity entity, entt::entity parent);
+
     void EmplaceScenePrefab(Scene&& scene, entt::entity entity);
 
     void EmplaceSceneInstance(entt::entity scene, entt::entity entity);
 
     entt::entity CreateSceneInstance(entt::entity scene, const Transform& transform);
 
+    // Instance references prefab hierarchy without copying it, prefab animations aren't applied to it
+    void EmplaceSharedInstance(entt::entity scene, entt::entity entity, MaterialHandle materialOverride = {});
+
+    entt::entity CreateSharedInstance(entt::entity scene, const Transform& transform);
+
     std::unique_ptr<Scene> EraseScenePrefab(entt::entity scene);
 
+    // Reorders hierarchy storage depth-first after edits, invalidates views over HierarchyComponent.
+    // Called on the main thread once per frame, it's no-op if hierarchy wasn't changed
+    void SortHierarchy();
+
 private:
+    entt::entity firstRoot = entt::null;
+    entt::entity lastRoot = entt::null;
+
+    bool hierarchySorted = true;
+
+    NameIndex nameIndex;
+    std::unordered_map<entt::entity, const std::string*> indexedNames;
+
+    mutable DynamicBvh bvh;
+    mutable std::unordered_map<entt::entity, uint32_t> bvhLeaves;
+    mutable std::unordered_set<entt::entity> invalidatedBounds;
+
+    SceneChanges changes;
+
     entity_type create() { return entt::registry::create(); }
+
+    void LinkEntity(entt::entity entity, entt::entity parent);
+
+    void UnlinkEntity(entt::entity entity);
+
+    // Visits nodes starting from first and its following siblings, doesn't climb above stop
+    void WalkDepthFirst(entt::entity first, entt::entity stop, const SceneEntityFunc& func) const;
+
+    void AddNameToIndex(entt::registry&, entt::entity entity);
+
+    void RemoveNameFromIndex(entt::registry&, entt::entity entity);
+
+    void UpdateNameInIndex(entt::registry& registry, entt::entity entity);
+
+    void InvalidateRenderBounds(entt::registry&, entt::entity entity);
+
+    void RemoveFromBvh(entt::registry&, entt::entity entity);
+
+    void InvalidateLight(entt::registry&, entt::entity entity);
+
+    void InvalidateLights(entt::registry&, entt::entity);
+
+    void UpdateBvh() const;
 };
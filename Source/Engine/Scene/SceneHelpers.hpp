@@ -1,28 +1,62 @@
 #pragma once
 
+#include <unordered_set>
+
 #include "Utils/AABBox.hpp"
 #include "Utils/Helpers.hpp"
+#include "Utils/SlotMap.hpp"
 
 class Scene;
-class TransformComponent;
 class Transform;
+class Primitive;
+struct Texture;
+struct Material;
 struct RenderObject;
+struct SharedInstanceComponent;
+
+using TextureHandle = SlotHandle<Texture>;
+using MaterialHandle = SlotHandle<Material>;
+using PrimitiveHandle = SlotHandle<Primitive>;
+
+struct StorageHandles
+{
+    std::vector<TextureHandle> textures;
+    std::vector<MaterialHandle> materials;
+    std::vector<PrimitiveHandle> primitives;
+};
+
+enum class RayCastMode
+{
+    eClosestHit,
+    eAnyHit
+};
+
+struct RayHit
+{
+    entt::entity entity = entt::null;
+    PrimitiveHandle primitive;
+    uint32_t triangle = 0;
+    glm::vec2 barycentrics = glm::vec2(0.0f);
+    float distance = 0.0f;
+};
 
-struct StorageRange
+// Accumulated by Scene between render snapshots, allows renderer to upload only changed data
+struct SceneChanges
 {
-    Range textures;
-    Range materials;
-    Range primitives;
+    std::unordered_set<entt::entity> lights;
+    std::vector<MaterialHandle> materials;
+    bool lightsAddedOrRemoved = false;
+    bool drawObjects = false;
+    // Render objects were added, removed or replaced, transform changes don't set it
+    bool renderObjects = false;
 };
 
 using SceneEntityFunc = std::function<void(entt::entity)>;
 
-using SceneRenderFunc = std::function<void(const Transform&, const RenderObject&)>;
+using SceneRenderFunc = std::function<void(const glm::mat4&, const RenderObject&)>;
 
 namespace SceneHelpers
 {
-    AABBox ComputeBBox(const Scene& scene);
-
     std::string GetDefaultName(entt::entity entity);
 
     std::string GetDisplayName(const Scene& scene, entt::entity entity);
@@ -33,10 +67,15 @@ namespace SceneHelpers
 
     void CopyHierarchy(const Scene& srcScene, Scene& dstScene, entt::entity srcParent, entt::entity dstParent);
 
-    void MergeStorageComponents(Scene& srcScene, Scene& dstScene);
+    StorageHandles MergeStorageComponents(Scene& srcScene, Scene& dstScene);
+
+    void SplitStorageComponents(Scene& srcScene, Scene& dstScene, const StorageHandles& handles);
+
+    RenderObject GetInstanceRenderObject(const SharedInstanceComponent& sic, const RenderObject& ro);
 
-    void SplitStorageComponents(Scene& srcScene, Scene& dstScene, const StorageRange& range);
+    // Shared instances are expanded from their prefab render nodes
+    void EnumerateRenderObjects(const Scene& scene, entt::entity entity, const SceneRenderFunc& func);
 
     vk::AccelerationStructureInstanceKHR GetTlasInstance(
-            const Scene& scene, const TransformComponent& tc, const RenderObject& ro);
+            const Scene& scene, const glm::mat4& transform, const RenderObject& ro);
 }
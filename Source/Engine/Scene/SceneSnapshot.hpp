@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Engine/Filesystem/Filepath.hpp"
+
+class Scene;
+
+// Binary image of a loaded scene: every component type is stored as one aligned array,
+// so the file can be mapped and copied in bulk without per-entity parsing
+namespace SceneSnapshot
+{
+    Filepath GetSnapshotPath(const Filepath& scenePath);
+
+    bool IsUpToDate(const Filepath& scenePath, const Filepath& snapshotPath);
+
+    // Scenes containing prefabs aren't supported, returns false for them
+    bool Save(const Scene& scene, const Filepath& path, float sourceLoadSeconds);
+
+    // Returns false without modifying the scene if the snapshot is missing or incompatible
+    bool Load(Scene& scene, const Filepath& path);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Engine/UI/ImGuiWidget.hpp"
+
+class Scene;
+
+class BenchmarkWidget : public ImGuiWidget
+{
+public:
+    BenchmarkWidget();
+
+protected:
+    void BuildInternal(Scene* scene, float deltaSeconds) override;
+
+private:
+    std::map<std::string, std::string> results;
+};
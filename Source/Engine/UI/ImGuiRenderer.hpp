@@ -1,9 +1,13 @@
 #pragma once
 
+#include "Engine/Render/RenderThread.hpp"
+
 class Scene;
 class Window;
 class RenderPass;
 class ImGuiWidget;
+struct ImDrawData;
+struct ImDrawList;
 
 class ImGuiRenderer
 {
@@ -13,14 +17,24 @@ public:
 
     void Build(Scene* scene, float deltaSeconds) const;
 
-    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const;
+    void CaptureDrawData(const RenderSnapshot& snapshot);
+
+    void Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const;
 
 private:
+    struct DrawData
+    {
+        std::unique_ptr<ImDrawData> data;
+        std::vector<ImDrawList*> lists;
+    };
+
     vk::DescriptorPool descriptorPool;
     std::unique_ptr<RenderPass> renderPass;
     std::vector<vk::Framebuffer> framebuffers;
 
     std::vector<std::unique_ptr<ImGuiWidget>> widgets;
 
+    std::array<DrawData, RenderThread::kSnapshotCount> drawData;
+
     void HandleResizeEvent(const vk::Extent2D& extent);
 };
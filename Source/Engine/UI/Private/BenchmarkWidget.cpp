@@ -0,0 +1,519 @@
+#include <imgui.h>
+
+#include "Engine/UI/BenchmarkWidget.hpp"
+
+#include "Engine/Render/CommandRecorder.hpp"
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Pipelines/ComputePipeline.hpp"
+#include "Engine/Scene/Components/CameraComponent.hpp"
+#include "Engine/Scene/Components/Components.hpp"
+#include "Engine/Scene/Scene.hpp"
+
+#include "Utils/Logger.hpp"
+#include "Utils/Ray.hpp"
+#include "Utils/TimeHelpers.hpp"
+
+#include <random>
+
+namespace Details
+{
+    static constexpr glm::uvec2 kRayGridSize(512, 256);
+
+    static std::vector<Ray> GenerateCameraRays(const Scene& scene)
+    {
+        const auto& cameraComponent = scene.ctx().get<CameraComponent>();
+
+        const glm::mat4 inverseViewProjMatrix = glm::inverse(cameraComponent.projMatrix * cameraComponent.viewMatrix);
+
+        const glm::vec3& origin = cameraComponent.location.position;
+
+        std::vector<Ray> rays;
+        rays.reserve(kRayGridSize.x * kRayGridSize.y);
+
+        for (uint32_t y = 0; y < kRayGridSize.y; ++y)
+        {
+            for (uint32_t x = 0; x < kRayGridSize.x; ++x)
+            {
+                const glm::vec2 ndc = (glm::vec2(x, y) + 0.5f) / glm::vec2(kRayGridSize) * 2.0f - 1.0f;
+
+                const glm::vec4 target = inverseViewProjMatrix * glm::vec4(ndc, 0.5f, 1.0f);
+
+                rays.push_back(Ray{ origin, glm::normalize(glm::vec3(target) / target.w - origin) });
+            }
+        }
+
+        return rays;
+    }
+
+    static std::string RunRayCastBenchmark(const Scene& scene)
+    {
+        EASY_FUNCTION()
+
+        Timer timer;
+        timer.Tick();
+
+        scene.BuildTriangleBvhs();
+
+        const float buildSeconds = timer.Tick();
+
+        const std::vector<Ray> rays = GenerateCameraRays(scene);
+
+        std::string result = std::format("BVH build: {:.2f} ms", buildSeconds / Metric::kMili);
+
+        for (const auto mode : { RayCastMode::eClosestHit, RayCastMode::eAnyHit })
+        {
+            uint32_t hitCount = 0;
+
+            timer.Tick();
+
+            for (const auto& ray : rays)
+            {
+                if (scene.CastRay(ray, mode))
+                {
+                    ++hitCount;
+                }
+            }
+
+            const float seconds = timer.Tick();
+
+            const float raysPerSecond = static_cast<float>(rays.size()) / seconds / Metric::kMega;
+
+            const std::string modeName = mode == RayCastMode::eClosestHit ? "closest hit" : "any hit";
+
+            result += std::format("\n{}: {:.2f} Mrays/s ({} rays, {} hits)", modeName, raysPerSecond, rays.size(), hitCount);
+        }
+
+        return result;
+    }
+
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    static constexpr uint32_t kHierarchySize = 100000;
+    static constexpr uint32_t kReparentCount = 10000;
+    static constexpr uint32_t kTraversalCount = 10;
+
+    // Parent index is always less than node index, so random reparenting never creates cycles
+    static std::vector<uint32_t> GenerateParentIndices(std::mt19937& generator)
+    {
+        std::vector<uint32_t> parentIndices(kHierarchySize, kInvalidIndex);
+
+        for (uint32_t i = 1; i < kHierarchySize; ++i)
+        {
+            parentIndices[i] = std::uniform_int_distribution<uint32_t>(0, i - 1)(generator);
+        }
+
+        return parentIndices;
+    }
+
+    static std::vector<std::pair<uint32_t, uint32_t>> GenerateReparents(std::mt19937& generator)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> reparents(kReparentCount);
+
+        for (auto& [index, parentIndex] : reparents)
+        {
+            index = std::uniform_int_distribution<uint32_t>(1, kHierarchySize - 1)(generator);
+            parentIndex = std::uniform_int_distribution<uint32_t>(0, index - 1)(generator);
+        }
+
+        return reparents;
+    }
+
+    // Reference layout with per-node children vectors, used as a baseline
+    class ChildListHierarchy
+    {
+    public:
+        ChildListHierarchy(const std::vector<uint32_t>& parentIndices)
+            : nodes(parentIndices.size())
+        {
+            for (uint32_t i = 0; i < static_cast<uint32_t>(parentIndices.size()); ++i)
+            {
+                SetParent(i, parentIndices[i]);
+            }
+        }
+
+        void SetParent(uint32_t index, uint32_t parentIndex)
+        {
+            Node& node = nodes[index];
+
+            if (node.parent != kInvalidIndex)
+            {
+                std::erase(nodes[node.parent].children, index);
+            }
+            else
+            {
+                std::erase(roots, index);
+            }
+
+            node.parent = parentIndex;
+
+            if (parentIndex != kInvalidIndex)
+            {
+                nodes[parentIndex].children.push_back(index);
+            }
+            else
+            {
+                roots.push_back(index);
+            }
+        }
+
+        uint32_t Traverse() const
+        {
+            uint32_t checksum = 0;
+
+            for (const uint32_t root : roots)
+            {
+                checksum += Traverse(root);
+            }
+
+            return checksum;
+        }
+
+    private:
+        struct Node
+        {
+            uint32_t parent = kInvalidIndex;
+            std::vector<uint32_t> children;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<uint32_t> roots;
+
+        uint32_t Traverse(uint32_t index) const
+        {
+            uint32_t checksum = index;
+
+            for (const uint32_t child : nodes[index].children)
+            {
+                checksum += Traverse(child);
+            }
+
+            return checksum;
+        }
+    };
+
+    static std::string RunHierarchyTraversalBenchmark()
+    {
+        EASY_FUNCTION()
+
+        std::mt19937 generator(0);
+
+        const std::vector<uint32_t> parentIndices = GenerateParentIndices(generator);
+
+        Timer timer;
+
+        const ChildListHierarchy childListHierarchy(parentIndices);
+
+        uint32_t childListChecksum = 0;
+
+        timer.Tick();
+
+        for (uint32_t i = 0; i < kTraversalCount; ++i)
+        {
+            childListChecksum += childListHierarchy.Traverse();
+        }
+
+        const float childListSeconds = timer.Tick() / static_cast<float>(kTraversalCount);
+
+        Scene scene;
+
+        std::vector<entt::entity> entities(kHierarchySize);
+
+        for (uint32_t i = 0; i < kHierarchySize; ++i)
+        {
+            const entt::entity parent = parentIndices[i] != kInvalidIndex ? entities[parentIndices[i]] : entt::null;
+
+            entities[i] = scene.CreateEntity(parent, {});
+        }
+
+        uint32_t intrusiveChecksum = 0;
+
+        timer.Tick();
+
+        scene.SortHierarchy();
+
+        const float sortSeconds = timer.Tick();
+
+        for (uint32_t i = 0; i < kTraversalCount; ++i)
+        {
+            scene.EnumerateHierarchy([&](entt::entity entity)
+                {
+                    intrusiveChecksum += static_cast<uint32_t>(entity);
+                });
+        }
+
+        const float scanSeconds = timer.Tick() / static_cast<float>(kTraversalCount);
+
+        for (uint32_t i = 0; i < kTraversalCount; ++i)
+        {
+            scene.EnumerateDescendants(entities.front(), [&](entt::entity entity)
+                {
+                    intrusiveChecksum += static_cast<uint32_t>(entity);
+                });
+        }
+
+        const float walkSeconds = timer.Tick() / static_cast<float>(kTraversalCount);
+
+        return std::format("{} nodes, checksums {} / {}"
+                "\nChild lists, recursive walk: {:.3f} ms"
+                "\nIntrusive, depth-first sort: {:.3f} ms"
+                "\nIntrusive, sorted scan: {:.3f} ms"
+                "\nIntrusive, link walk: {:.3f} ms",
+                kHierarchySize, childListChecksum, intrusiveChecksum,
+                childListSeconds / Metric::kMili, sortSeconds / Metric::kMili,
+                scanSeconds / Metric::kMili, walkSeconds / Metric::kMili);
+    }
+
+    static std::string RunHierarchyReparentingBenchmark()
+    {
+        EASY_FUNCTION()
+
+        std::mt19937 generator(0);
+
+        const std::vector<uint32_t> parentIndices = GenerateParentIndices(generator);
+        const std::vector<std::pair<uint32_t, uint32_t>> reparents = GenerateReparents(generator);
+
+        Timer timer;
+
+        ChildListHierarchy childListHierarchy(parentIndices);
+
+        timer.Tick();
+
+        for (const auto& [index, parentIndex] : reparents)
+        {
+            childListHierarchy.SetParent(index, parentIndex);
+        }
+
+        const float childListSeconds = timer.Tick();
+
+        Scene scene;
+
+        std::vector<entt::entity> entities(kHierarchySize);
+
+        for (uint32_t i = 0; i < kHierarchySize; ++i)
+        {
+            const entt::entity parent = parentIndices[i] != kInvalidIndex ? entities[parentIndices[i]] : entt::null;
+
+            entities[i] = scene.CreateEntity(parent, {});
+        }
+
+        timer.Tick();
+
+        for (const auto& [index, parentIndex] : reparents)
+        {
+            scene.SetParent(entities[index], entities[parentIndex]);
+        }
+
+        const float intrusiveSeconds = timer.Tick();
+
+        scene.SortHierarchy();
+
+        const float resortSeconds = timer.Tick();
+
+        return std::format("{} nodes, {} reparents"
+                "\nChild lists: {:.3f} ms"
+                "\nIntrusive (with transform invalidation): {:.3f} ms"
+                "\nIntrusive, depth-first resort: {:.3f} ms",
+                kHierarchySize, kReparentCount, childListSeconds / Metric::kMili,
+                intrusiveSeconds / Metric::kMili, resortSeconds / Metric::kMili);
+    }
+
+    static constexpr uint32_t kPushConstantDrawCount = 50000;
+
+    // Any pipeline with several push constants fits, reflection filter pushes roughness and face index
+    static const Filepath kPushConstantShaderPath("~/Shaders/Compute/ImageBasedLighting/Reflection.comp");
+
+    static constexpr glm::uvec3 kPushConstantWorkGroupSize(8, 8, 1);
+
+    // Only push constants are recorded for each draw, so the pipeline doesn't need bound resources
+    static std::string RunPushConstantBenchmark()
+    {
+        EASY_FUNCTION()
+
+        const ShaderModule shaderModule = VulkanContext::shaderManager->CreateComputeShaderModule(
+                kPushConstantShaderPath, kPushConstantWorkGroupSize);
+
+        const std::unique_ptr<ComputePipeline> pipeline = ComputePipeline::Create(shaderModule);
+
+        VulkanContext::shaderManager->DestroyShaderModule(shaderModule);
+
+        float nameSeconds = 0.0f;
+        float handleSeconds = 0.0f;
+        float blockSeconds = 0.0f;
+
+        VulkanContext::device->ExecuteOneTimeCommands([&](vk::CommandBuffer commandBuffer)
+            {
+                pipeline->Bind(commandBuffer);
+
+                Timer timer;
+                timer.Tick();
+
+                for (uint32_t i = 0; i < kPushConstantDrawCount; ++i)
+                {
+                    pipeline->PushConstant(commandBuffer, "roughness", static_cast<float>(i));
+                    pipeline->PushConstant(commandBuffer, "faceIndex", i);
+                }
+
+                nameSeconds = timer.Tick();
+
+                const PushConstantHandle roughnessHandle = pipeline->GetPushConstantHandle("roughness");
+                const PushConstantHandle faceIndexHandle = pipeline->GetPushConstantHandle("faceIndex");
+
+                for (uint32_t i = 0; i < kPushConstantDrawCount; ++i)
+                {
+                    pipeline->PushConstant(commandBuffer, roughnessHandle, static_cast<float>(i));
+                    pipeline->PushConstant(commandBuffer, faceIndexHandle, i);
+                }
+
+                handleSeconds = timer.Tick();
+
+                for (uint32_t i = 0; i < kPushConstantDrawCount; ++i)
+                {
+                    const PushConstantBlock pushConstants = PushConstantBlock()
+                            .Set(roughnessHandle, static_cast<float>(i))
+                            .Set(faceIndexHandle, i);
+
+                    pipeline->PushConstants(commandBuffer, pushConstants);
+                }
+
+                blockSeconds = timer.Tick();
+            });
+
+        const auto formatResult = [](const std::string& name, float seconds)
+            {
+                const float nanoseconds = seconds / Metric::kNano / static_cast<float>(kPushConstantDrawCount);
+
+                return std::format("\n{}: {:.3f} ms ({:.1f} ns per draw)", name, seconds / Metric::kMili, nanoseconds);
+            };
+
+        return std::format("{} draws, 2 push constants per draw", kPushConstantDrawCount)
+                + formatResult("By name", nameSeconds)
+                + formatResult("Handles", handleSeconds)
+                + formatResult("Handles, single command", blockSeconds);
+    }
+
+    static constexpr uint32_t kRecordingObjectCount = 100000;
+    static constexpr uint32_t kRecordingChunkSize = 1024;
+
+    // Each synthetic object pushes constants and dispatches, recorded command buffers are never submitted
+    static std::string RunCommandRecordingBenchmark()
+    {
+        EASY_FUNCTION()
+
+        const ShaderModule shaderModule = VulkanContext::shaderManager->CreateComputeShaderModule(
+                kPushConstantShaderPath, kPushConstantWorkGroupSize);
+
+        const std::unique_ptr<ComputePipeline> pipeline = ComputePipeline::Create(shaderModule);
+
+        VulkanContext::shaderManager->DestroyShaderModule(shaderModule);
+
+        const PushConstantHandle roughnessHandle = pipeline->GetPushConstantHandle("roughness");
+        const PushConstantHandle faceIndexHandle = pipeline->GetPushConstantHandle("faceIndex");
+
+        CommandRecorder commandRecorder(1);
+
+        const uint32_t chunkCount = (kRecordingObjectCount + kRecordingChunkSize - 1) / kRecordingChunkSize;
+
+        const auto recordChunk = [&](vk::CommandBuffer commandBuffer, uint32_t chunkIndex)
+            {
+                pipeline->Bind(commandBuffer);
+
+                const uint32_t begin = chunkIndex * kRecordingChunkSize;
+                const uint32_t end = std::min(begin + kRecordingChunkSize, kRecordingObjectCount);
+
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    const PushConstantBlock pushConstants = PushConstantBlock()
+                            .Set(roughnessHandle, static_cast<float>(i))
+                            .Set(faceIndexHandle, i);
+
+                    pipeline->PushConstants(commandBuffer, pushConstants);
+
+                    commandBuffer.dispatch(1, 1, 1);
+                }
+            };
+
+        const vk::CommandBufferInheritanceInfo inheritanceInfo;
+
+        const uint32_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+        std::string result = std::format("{} objects in chunks of {}", kRecordingObjectCount, kRecordingChunkSize);
+
+        float singleThreadSeconds = 0.0f;
+
+        for (uint32_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+        {
+            commandRecorder.BeginFrame(0);
+
+            Timer timer;
+            timer.Tick();
+
+            commandRecorder.Record(inheritanceInfo, threadCount, chunkCount, recordChunk);
+
+            const float seconds = timer.Tick();
+
+            if (threadCount == 1)
+            {
+                singleThreadSeconds = seconds;
+            }
+
+            result += std::format("\n{} threads: {:.3f} ms ({:.2f}x)", threadCount,
+                    seconds / Metric::kMili, singleThreadSeconds / seconds);
+        }
+
+        commandRecorder.BeginFrame(0);
+
+        return result;
+    }
+}
+
+BenchmarkWidget::BenchmarkWidget()
+    : ImGuiWidget("Benchmarks")
+{}
+
+void BenchmarkWidget::BuildInternal(Scene* scene, float)
+{
+    if (!scene)
+    {
+        return;
+    }
+
+    if (ImGui::Button("Ray casting"))
+    {
+        results["Ray casting"] = Details::RunRayCastBenchmark(*scene);
+
+        LogI << "Ray casting benchmark:\n" << results["Ray casting"] << "\n";
+    }
+
+    if (ImGui::Button("Hierarchy traversal"))
+    {
+        results["Hierarchy traversal"] = Details::RunHierarchyTraversalBenchmark();
+
+        LogI << "Hierarchy traversal benchmark:\n" << results["Hierarchy traversal"] << "\n";
+    }
+
+    if (ImGui::Button("Hierarchy reparenting"))
+    {
+        results["Hierarchy reparenting"] = Details::RunHierarchyReparentingBenchmark();
+
+        LogI << "Hierarchy reparenting benchmark:\n" << results["Hierarchy reparenting"] << "\n";
+    }
+
+    if (ImGui::Button("Push constants"))
+    {
+        results["Push constants"] = Details::RunPushConstantBenchmark();
+
+        LogI << "Push constants benchmark:\n" << results["Push constants"] << "\n";
+    }
+
+    if (ImGui::Button("Command recording"))
+    {
+        results["Command recording"] = Details::RunCommandRecordingBenchmark();
+
+        LogI << "Command recording benchmark:\n" << results["Command recording"] << "\n";
+    }
+
+    for (const auto& [name, result] : results)
+    {
+        ImGui::Text("%s", std::format("{}\n{}", name, result).c_str());
+    }
+}
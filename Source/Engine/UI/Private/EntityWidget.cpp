@@ -39,9 +39,14 @@ namespace Details
 
     static void BuildNameView(Scene& scene, entt::entity entity)
     {
-        if (auto* nc = scene.try_get<NameComponent>(entity))
+        if (const auto* nc = scene.try_get<NameComponent>(entity))
         {
-            nc->name = BuildNameInput(nc->name);
+            const std::string name = BuildNameInput(nc->name);
+
+            if (name != nc->name)
+            {
+                scene.replace<NameComponent>(entity, name);
+            }
         }
         else
         {
@@ -21,7 +21,7 @@ namespace Details
             flags |= ImGuiTreeNodeFlags_Selected;
         }
 
-        if (hc.GetChildren().empty())
+        if (!hc.HasChildren())
         {
             flags |= ImGuiTreeNodeFlags_Leaf;
         }
@@ -35,10 +35,10 @@ namespace Details
                 selectedEntity = entity;
             }
 
-            for (const auto& child : hc.GetChildren())
-            {
-                BuildTreeNode(scene, child, selectedEntity);
-            }
+            scene.EnumerateChildren(entity, [&](entt::entity child)
+                {
+                    BuildTreeNode(scene, child, selectedEntity);
+                });
 
             ImGui::TreePop();
         }
@@ -46,14 +46,9 @@ namespace Details
 
     static void BuildHierarchyView(const Scene& scene, entt::entity& selectedEntity)
     {
-        scene.each([&](entt::entity entity)
+        scene.EnumerateChildren(entt::null, [&](entt::entity entity)
             {
-                const auto& hc = scene.get<HierarchyComponent>(entity);
-
-                if (hc.GetParent() == entt::null)
-                {
-                    BuildTreeNode(scene, entity, selectedEntity);
-                }
+                BuildTreeNode(scene, entity, selectedEntity);
             });
     }
 }
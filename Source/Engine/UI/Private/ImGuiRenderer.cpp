@@ -5,10 +5,12 @@
 #include "Engine/UI/ImGuiRenderer.hpp"
 
 #include "Engine/UI/AnimationWidget.hpp"
+#include "Engine/UI/BenchmarkWidget.hpp"
 #include "Engine/UI/HierarchyWidget.hpp"
 #include "Engine/UI/EntityWidget.hpp"
 #include "Engine/UI/CVarsWidget.hpp"
 #include "Engine/UI/StatWidget.hpp"
+#include "Engine/Render/RenderContext.hpp"
 #include "Engine/Render/Vulkan/VulkanContext.hpp"
 #include "Engine/Render/Vulkan/RenderPass.hpp"
 #include "Engine/Scene/Components/Components.hpp"
@@ -128,6 +130,37 @@ namespace Details
 
         ImGui::SetNextWindowSizeConstraints(minSize, maxSize);
     }
+
+    static void DestroyDrawLists(std::vector<ImDrawList*>& drawLists)
+    {
+        for (ImDrawList* drawList : drawLists)
+        {
+            IM_DELETE(drawList);
+        }
+
+        drawLists.clear();
+    }
+
+    static void CopyDrawData(const ImDrawData& srcData, ImDrawData& dstData, std::vector<ImDrawList*>& dstLists)
+    {
+        DestroyDrawLists(dstLists);
+
+        for (int32_t i = 0; i < srcData.CmdListsCount; ++i)
+        {
+            dstLists.push_back(srcData.CmdLists[i]->CloneOutput());
+        }
+
+        dstData = srcData;
+
+#if IMGUI_VERSION_NUM >= 18980
+        for (int32_t i = 0; i < srcData.CmdListsCount; ++i)
+        {
+            dstData.CmdLists[i] = dstLists[i];
+        }
+#else
+        dstData.CmdLists = dstLists.data();
+#endif
+    }
 }
 
 ImGuiRenderer::ImGuiRenderer(const Window& window)
@@ -140,11 +173,17 @@ ImGuiRenderer::ImGuiRenderer(const Window& window)
 
     Details::InitializeImGui(window.Get(), descriptorPool, renderPass->Get());
 
+    for (auto& [data, lists] : drawData)
+    {
+        data = std::make_unique<ImDrawData>();
+    }
+
     widgets.push_back(std::make_unique<StatWidget>());
     widgets.push_back(std::make_unique<CVarsWidget>());
     widgets.push_back(std::make_unique<HierarchyWidget>());
     widgets.push_back(std::make_unique<EntityWidget>());
     widgets.push_back(std::make_unique<AnimationWidget>());
+    widgets.push_back(std::make_unique<BenchmarkWidget>());
 
     Engine::AddEventHandler<vk::Extent2D>(EventType::eResize,
             MakeFunction(this, &ImGuiRenderer::HandleResizeEvent));
@@ -152,6 +191,11 @@ ImGuiRenderer::ImGuiRenderer(const Window& window)
 
 ImGuiRenderer::~ImGuiRenderer()
 {
+    for (auto& [data, lists] : drawData)
+    {
+        Details::DestroyDrawLists(lists);
+    }
+
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -180,11 +224,20 @@ void ImGuiRenderer::Build(Scene* scene, float deltaSeconds) const
     }
 
     ImGui::End();
+
+    ImGui::Render();
 }
 
-void ImGuiRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex) const
+void ImGuiRenderer::CaptureDrawData(const RenderSnapshot& snapshot)
 {
-    ImGui::Render();
+    auto& [data, lists] = drawData[snapshot.frameIndex % RenderThread::kSnapshotCount];
+
+    Details::CopyDrawData(*ImGui::GetDrawData(), *data, lists);
+}
+
+void ImGuiRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex, const RenderSnapshot& snapshot) const
+{
+    const DrawData& frameDrawData = drawData[snapshot.frameIndex % RenderThread::kSnapshotCount];
 
     const vk::Extent2D& extent = VulkanContext::swapchain->GetExtent();
 
@@ -194,13 +247,15 @@ void ImGuiRenderer::Render(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
 
     commandBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
 
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+    ImGui_ImplVulkan_RenderDrawData(frameDrawData.data.get(), commandBuffer);
 
     commandBuffer.endRenderPass();
 }
 
 void ImGuiRenderer::HandleResizeEvent(const vk::Extent2D& extent)
 {
+    RenderContext::renderThread->Flush();
+
     if (extent.width != 0 && extent.height != 0)
     {
         for (const auto& framebuffer : framebuffers)
@@ -2,6 +2,12 @@
 
 #include "Engine/UI/StatWidget.hpp"
 
+#include "Engine/Render/RenderContext.hpp"
+#include "Engine/Render/RenderStats.hpp"
+#include "Engine/Render/RenderThread.hpp"
+#include "Engine/Render/Vulkan/VulkanContext.hpp"
+#include "Engine/Render/Vulkan/Resources/GeometryArena.hpp"
+
 #include "Utils/Helpers.hpp"
 
 StatWidget::StatWidget()
@@ -15,4 +21,93 @@ void StatWidget::BuildInternal(Scene*, float deltaSeconds)
     const float fps = 1.0f / deltaSeconds; // TODO implement fps averaging
 
     ImGui::Text("%s", std::format("Frame time: {:.2f} ms ({:.1f} FPS)", frameTime, fps).c_str());
+
+    const RenderThread& renderThread = *RenderContext::renderThread;
+
+    const RenderStats& stats = renderThread.GetStats();
+
+    const float renderSeconds = stats.renderSeconds;
+    const float latencySeconds = stats.latencySeconds;
+
+    const std::string renderMode = renderThread.IsEnabled() ? "render thread" : "inline";
+
+    ImGui::Text("%s", std::format("Render time: {:.2f} ms ({})", renderSeconds / Metric::kMili, renderMode).c_str());
+    ImGui::Text("%s", std::format("Snapshot latency: {:.2f} ms", latencySeconds / Metric::kMili).c_str());
+
+    const uint32_t drawObjectCount = stats.extract.drawObjectCount;
+    const uint32_t frustumCulledCount = stats.extract.frustumCulledCount;
+    const uint32_t occludedCount = stats.extract.occludedCount;
+    const uint32_t submittedCount = stats.extract.submittedCount;
+
+    ImGui::Text("%s", std::format("Draw objects: {} (culled: {}, occluded: {}, submitted: {})",
+            drawObjectCount, frustumCulledCount, occludedCount, submittedCount).c_str());
+    ImGui::Text("%s", std::format("Culling time: {:.3f} ms (occlusion: {:.3f} ms)",
+            stats.extract.cullingSeconds / Metric::kMili, stats.extract.occlusionSeconds / Metric::kMili).c_str());
+
+    const uint32_t sortKeyCount = stats.extract.sortKeyCount;
+    const uint32_t uniqueSortKeyCount = stats.extract.uniqueSortKeyCount;
+    const uint32_t renderListRebuildCount = stats.extract.renderListRebuildCount;
+
+    ImGui::Text("%s", std::format("Render list: {} keys ({} unique), {} rebuilds (last: {:.3f} ms)",
+            sortKeyCount, uniqueSortKeyCount, renderListRebuildCount,
+            stats.extract.renderListRebuildSeconds / Metric::kMili).c_str());
+
+    const uint32_t pipelineChangeCount = stats.extract.pipelineChangeCount;
+    const uint32_t materialChangeCount = stats.extract.materialChangeCount;
+    const uint32_t primitiveChangeCount = stats.extract.primitiveChangeCount;
+
+    ImGui::Text("%s", std::format("State changes: {} pipelines, {} materials, {} primitives",
+            pipelineChangeCount, materialChangeCount, primitiveChangeCount).c_str());
+
+    const uint32_t drawCallCount = stats.record.drawCallCount;
+    const float drawRecordTime = stats.record.drawRecordSeconds / Metric::kMili;
+    const float drawsPerMillisecond = drawRecordTime > 0.0f ? static_cast<float>(submittedCount) / drawRecordTime : 0.0f;
+
+    ImGui::Text("%s", std::format("Draw recording: {:.3f} ms, {} draw calls ({:.0f} draws per ms)",
+            drawRecordTime, drawCallCount, drawsPerMillisecond).c_str());
+
+    const uint32_t recordingThreadCount = stats.record.recordingThreadCount;
+    const uint32_t secondaryCommandBufferCount = stats.record.secondaryCommandBufferCount;
+
+    ImGui::Text("%s", std::format("Recording threads: {} ({} secondary command buffers)",
+            recordingThreadCount, secondaryCommandBufferCount).c_str());
+
+    const GeometryStats geometryStats = GeometryArena::GetStats();
+
+    ImGui::Text("%s", std::format("Vertex layout: {} ({} bytes per vertex, {} streams, {} bytes per position)",
+            GeometryArena::GetVertexLayoutName(geometryStats.vertexLayout), geometryStats.vertexSize,
+            geometryStats.vertexStreamCount, geometryStats.positionStride).c_str());
+    ImGui::Text("%s", std::format("Geometry memory: {:.2f} MB vertices ({}), {:.2f} MB indices ({})",
+            static_cast<float>(geometryStats.vertexMemorySize) / Metric::kMegabyte, geometryStats.vertexCount,
+            static_cast<float>(geometryStats.indexMemorySize) / Metric::kMegabyte, geometryStats.indexCount).c_str());
+
+    const uint64_t vertexFetchBytes = stats.extract.vertexFetchBytes;
+
+    ImGui::Text("%s", std::format("Vertex fetch: {:.2f} MB per frame (estimated)",
+            static_cast<float>(vertexFetchBytes) / Metric::kMegabyte).c_str());
+
+    const uint64_t uploadedBytes = stats.record.uploadedBytes;
+    const uint32_t bufferCopyRegionCount = stats.record.bufferCopyRegionCount;
+    const uint32_t bufferBarrierCount = stats.record.bufferBarrierCount;
+
+    ImGui::Text("%s", std::format("Uploaded: {} bytes (copy regions: {}, barriers: {})",
+            uploadedBytes, bufferCopyRegionCount, bufferBarrierCount).c_str());
+
+    const uint32_t tlasRefitCount = stats.record.tlasRefitCount;
+
+    ImGui::Text("%s", std::format("TLAS: {:.3f} ms CPU, {:.3f} ms GPU (refits since rebuild: {})",
+            stats.record.tlasCpuSeconds / Metric::kMili, stats.record.tlasGpuSeconds / Metric::kMili, tlasRefitCount).c_str());
+
+    const uint32_t frameAllocationCount = stats.record.frameAllocationCount;
+    const uint32_t renderThreadAllocationCount = stats.record.renderThreadAllocationCount;
+    const uint64_t frameArenaUsedBytes = stats.record.frameArenaUsedBytes;
+
+    ImGui::Text("%s", std::format("Heap allocations: {} per frame (render thread: {}), frame arena: {} bytes",
+            frameAllocationCount, renderThreadAllocationCount, frameArenaUsedBytes).c_str());
+
+    const PipelineCacheStats pipelineCacheStats = VulkanContext::pipelineCache->GetStats();
+
+    ImGui::Text("%s", std::format("Pipeline cache: {}, {} pipelines created in {:.2f} ms",
+            pipelineCacheStats.warm ? "warm" : "cold", pipelineCacheStats.pipelineCount,
+            pipelineCacheStats.creationSeconds / Metric::kMili).c_str());
 }
@@ -59,6 +59,19 @@ struct Frame
     vec2 padding;
 };
 
+struct DrawInstance
+{
+    mat4 transform;
+    uint materialIndex;
+    uint padding[3];
+};
+
+struct Primitive
+{
+    uint firstIndex;
+    uint vertexOffset;
+};
+
 struct Tetrahedron
 {
     int vertices[TET_VERTEX_COUNT];
@@ -0,0 +1,84 @@
+#ifndef VERTEX_GLSL
+#define VERTEX_GLSL
+
+#ifndef SHADER_STAGE
+    #define SHADER_STAGE vertex
+    #pragma shader_stage(vertex)
+    void main() {}
+#endif
+
+// Values match VertexLayout of GeometryArena
+#define VERTEX_LAYOUT_SEPARATE 0
+#define VERTEX_LAYOUT_INTERLEAVED 1
+#define VERTEX_LAYOUT_POSITION_SPLIT 2
+#define VERTEX_LAYOUT_COMPRESSED 3
+
+#ifndef VERTEX_LAYOUT
+    #define VERTEX_LAYOUT VERTEX_LAYOUT_SEPARATE
+#endif
+
+// Offsets and strides in 32-bit words of buffers containing normals, tangents and texture coordinates
+#if VERTEX_LAYOUT == VERTEX_LAYOUT_SEPARATE
+    #define NORMAL_OFFSET 0
+    #define NORMAL_STRIDE 3
+    #define TANGENT_OFFSET 0
+    #define TANGENT_STRIDE 3
+    #define TEX_COORD_OFFSET 0
+    #define TEX_COORD_STRIDE 2
+#elif VERTEX_LAYOUT == VERTEX_LAYOUT_INTERLEAVED
+    #define NORMAL_OFFSET 3
+    #define NORMAL_STRIDE 11
+    #define TANGENT_OFFSET 6
+    #define TANGENT_STRIDE 11
+    #define TEX_COORD_OFFSET 9
+    #define TEX_COORD_STRIDE 11
+#elif VERTEX_LAYOUT == VERTEX_LAYOUT_POSITION_SPLIT
+    #define NORMAL_OFFSET 0
+    #define NORMAL_STRIDE 8
+    #define TANGENT_OFFSET 3
+    #define TANGENT_STRIDE 8
+    #define TEX_COORD_OFFSET 6
+    #define TEX_COORD_STRIDE 8
+#elif VERTEX_LAYOUT == VERTEX_LAYOUT_COMPRESSED
+    #define NORMAL_OFFSET 0
+    #define NORMAL_STRIDE 3
+    #define TANGENT_OFFSET 1
+    #define TANGENT_STRIDE 3
+    #define TEX_COORD_OFFSET 2
+    #define TEX_COORD_STRIDE 3
+#endif
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+
+    if (v.z < 0.0)
+    {
+        const vec2 s = vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+        v.xy = (1.0 - abs(v.yx)) * s;
+    }
+
+    return normalize(v);
+}
+
+#if VERTEX_LAYOUT == VERTEX_LAYOUT_COMPRESSED
+    // Normals and tangents are fetched as R16G16Snorm octahedral encoding
+    #define VERTEX_DIRECTION vec2
+    #define DECODE_DIRECTION(v) DecodeOctahedral(v)
+
+    #define LOAD_NORMAL(words, i) DecodeOctahedral(unpackSnorm2x16(words[(i) * NORMAL_STRIDE + NORMAL_OFFSET]))
+    #define LOAD_TANGENT(words, i) DecodeOctahedral(unpackSnorm2x16(words[(i) * TANGENT_STRIDE + TANGENT_OFFSET]))
+    #define LOAD_TEX_COORD(words, i) unpackHalf2x16(words[(i) * TEX_COORD_STRIDE + TEX_COORD_OFFSET])
+#else
+    #define VERTEX_DIRECTION vec3
+    #define DECODE_DIRECTION(v) (v)
+
+    #define LOAD_VEC2(words, j) uintBitsToFloat(uvec2(words[(j)], words[(j) + 1]))
+    #define LOAD_VEC3(words, j) uintBitsToFloat(uvec3(words[(j)], words[(j) + 1], words[(j) + 2]))
+
+    #define LOAD_NORMAL(words, i) LOAD_VEC3(words, (i) * NORMAL_STRIDE + NORMAL_OFFSET)
+    #define LOAD_TANGENT(words, i) LOAD_VEC3(words, (i) * TANGENT_STRIDE + TANGENT_OFFSET)
+    #define LOAD_TEX_COORD(words, i) LOAD_VEC2(words, (i) * TEX_COORD_STRIDE + TEX_COORD_OFFSET)
+#endif
+
+#endif
@@ -14,6 +14,8 @@
 #define RAY_TRACING_ENABLED 1
 #define LIGHT_VOLUME_ENABLED 1
 
+#define VERTEX_LAYOUT 0
+
 #include "Common/Common.h"
 #include "Common/Common.glsl"
 #include "Common/PBR.glsl"
@@ -24,7 +26,7 @@
 
 void main() 
 {
-    const Material material = materials[materialIndex];
+    const Material material = materials[inMaterialIndex];
 
     const vec4 baseColor = GetBaseColor(material);
 
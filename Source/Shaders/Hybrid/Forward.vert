@@ -9,22 +9,27 @@
 #define DEPTH_ONLY 0
 #define NORMAL_MAPPING 0
 
+#define VERTEX_LAYOUT 0
+
 #include "Hybrid/Forward.layout"
 
 void main() 
 {
-    const vec4 worldPosition = transform * vec4(inPosition, 1.0);
+    const DrawInstance instance = instances[gl_InstanceIndex];
+
+    const vec4 worldPosition = instance.transform * vec4(inPosition, 1.0);
 
     #if !DEPTH_ONLY
         // TODO: move to CPU
-        const mat4 normalTransform = transpose(inverse(transform));
+        const mat4 normalTransform = transpose(inverse(instance.transform));
 
+        outMaterialIndex = instance.materialIndex;
         outPosition = worldPosition.xyz;
-        outNormal = normalize(vec3(normalTransform * vec4(inNormal, 0.0)));
+        outNormal = normalize(vec3(normalTransform * vec4(DECODE_DIRECTION(inNormal), 0.0)));
         outTexCoord = inTexCoord;
         
         #if NORMAL_MAPPING
-            outTangent = normalize(vec3(normalTransform * vec4(inTangent, 0.0)));
+            outTangent = normalize(vec3(normalTransform * vec4(DECODE_DIRECTION(inTangent), 0.0)));
         #endif
     #endif
 
@@ -18,7 +18,7 @@
 
 void main() 
 {
-    const Material material = materials[materialIndex];
+    const Material material = materials[inMaterialIndex];
 
     const vec4 baseColor = GetBaseColor(material);
 
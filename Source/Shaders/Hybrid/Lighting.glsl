@@ -26,12 +26,16 @@
 #if RAY_TRACING_ENABLED
     uvec3 GetIndices(uint instanceId, uint primitiveId)
     {
-        return indexBuffers[nonuniformEXT(instanceId)].indices[primitiveId];
+        const Primitive primitive = primitives[instanceId];
+
+        const uint i = primitive.firstIndex + primitiveId * 3;
+
+        return uvec3(vertexIndices[i], vertexIndices[i + 1], vertexIndices[i + 2]) + primitive.vertexOffset;
     }
 
-    vec2 GetTexCoord(uint instanceId, uint i)
+    vec2 GetTexCoord(uint i)
     {
-        return texCoordBuffers[nonuniformEXT(instanceId)].texCoords[i];
+        return LOAD_TEX_COORD(vertexTexCoords, i);
     }
 
     float TraceRay(Ray ray)
@@ -56,9 +60,9 @@
 
                 const uvec3 indices = GetIndices(instanceId, primitiveId);
 
-                const vec2 texCoord0 = GetTexCoord(instanceId, indices[0]);
-                const vec2 texCoord1 = GetTexCoord(instanceId, indices[1]);
-                const vec2 texCoord2 = GetTexCoord(instanceId, indices[2]);
+                const vec2 texCoord0 = GetTexCoord(indices[0]);
+                const vec2 texCoord1 = GetTexCoord(indices[1]);
+                const vec2 texCoord2 = GetTexCoord(indices[2]);
                 
                 const vec3 baryCoord = vec3(1.0 - hitCoord.x - hitCoord.y, hitCoord.x, hitCoord.y);
 
@@ -0,0 +1,10 @@
+#pragma once
+
+// Counts calls of global operator new, which is replaced in AllocationCounter.cpp
+namespace AllocationCounter
+{
+    uint64_t GetTotalCount();
+
+    // Allocations made by the calling thread
+    uint64_t GetThreadCount();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Utils/AABBox.hpp"
+
+class Frustum;
+struct Ray;
+
+// Incrementally updated bounding volume hierarchy, leaves are inserted using surface area heuristic
+class DynamicBvh
+{
+public:
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    using QueryFunc = std::function<void(uint32_t)>;
+
+    // Returns new max distance of the ray, allows to shrink the query to the closest hit
+    using RayQueryFunc = std::function<float(uint32_t, float)>;
+
+    uint32_t Insert(const AABBox& bbox, uint32_t id);
+
+    void Remove(uint32_t leaf);
+
+    void Refit(uint32_t leaf, const AABBox& bbox);
+
+    void Clear();
+
+    bool IsEmpty() const { return root == kInvalidIndex; }
+
+    uint32_t GetLeafCount() const { return leafCount; }
+
+    AABBox GetBBox() const;
+
+    uint32_t GetId(uint32_t leaf) const { return nodes[leaf].id; }
+
+    void QueryBBox(const AABBox& bbox, const QueryFunc& func) const;
+
+    void QuerySphere(const glm::vec3& center, float radius, const QueryFunc& func) const;
+
+    void QueryFrustum(const Frustum& frustum, const QueryFunc& func) const;
+
+    void QueryRay(const Ray& ray, const RayQueryFunc& func) const;
+
+private:
+    struct Node
+    {
+        AABBox bbox;
+        uint32_t parent = kInvalidIndex;
+        uint32_t left = kInvalidIndex;
+        uint32_t right = kInvalidIndex;
+        uint32_t id = kInvalidIndex;
+
+        bool IsLeaf() const { return left == kInvalidIndex; }
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+
+    uint32_t root = kInvalidIndex;
+    uint32_t leafCount = 0;
+
+    uint32_t AllocateNode();
+
+    void FreeNode(uint32_t index);
+
+    uint32_t FindBestSibling(const AABBox& bbox) const;
+
+    void InsertLeaf(uint32_t leaf);
+
+    void RemoveLeaf(uint32_t leaf);
+
+    void RefitAncestors(uint32_t index);
+
+    void EnumerateLeaves(uint32_t index, const QueryFunc& func) const;
+};
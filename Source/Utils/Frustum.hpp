@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Utils/AABBox.hpp"
+
+class Frustum
+{
+public:
+    Frustum() = default;
+    Frustum(const glm::mat4& viewProjMatrix);
+
+    const std::array<glm::vec4, 6>& GetPlanes() const { return planes; }
+
+    AABBox::Intersection Intersect(const AABBox& bbox) const;
+
+    bool Intersect(const glm::vec3& center, float radius) const;
+
+private:
+    std::array<glm::vec4, 6> planes;
+};
@@ -97,6 +97,13 @@ void CombineHash(std::size_t& s, const T& v)
     s ^= h(v) + 0x9e3779b9 + (s << 6) + (s >> 2);
 }
 
+struct StringHash
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view string) const { return std::hash<std::string_view>()(string); }
+};
+
 template <class TSrc, class TDst>
 std::vector<TDst> CopyVector(const std::vector<TSrc>& src)
 {
@@ -119,6 +126,9 @@ auto MakeFunction(TInst* instance, TFunc&& function)
         };
 }
 
+// Calls func for each index in [0, count) using all hardware threads including the calling one
+void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
 Bytes GetBytes(const std::vector<ByteView>& byteViews);
 
 template <class... Types>
@@ -149,8 +159,8 @@ ByteView GetByteView(const T& data)
 }
 
 
-template <class T>
-ByteView GetByteView(const std::vector<T>& data)
+template <class T, class Allocator>
+ByteView GetByteView(const std::vector<T, Allocator>& data)
 {
     return ByteView(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(T));
 }
@@ -162,8 +172,8 @@ ByteAccess GetByteAccess(T& data)
 }
 
 
-template <class T>
-ByteAccess GetByteAccess(std::vector<T>& data)
+template <class T, class Allocator>
+ByteAccess GetByteAccess(std::vector<T, Allocator>& data)
 {
     return ByteAccess(reinterpret_cast<uint8_t*>(data.data()), data.size() * sizeof(T));
 }
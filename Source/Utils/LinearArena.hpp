@@ -0,0 +1,73 @@
+#pragma once
+
+// Bump allocator for transient data, memory is released all at once by Reset.
+// Blocks added when the arena overflows are merged into one on reset, so steady state usage doesn't touch the heap
+class LinearArena
+{
+public:
+    explicit LinearArena(size_t blockSize_);
+
+    void* Allocate(size_t size, size_t alignment);
+
+    void Reset();
+
+    size_t GetUsedSize() const { return usedSize; }
+
+    size_t GetCapacity() const { return capacity; }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+    };
+
+    size_t blockSize = 0;
+
+    std::vector<Block> blocks;
+    size_t blockOffset = 0;
+
+    size_t usedSize = 0;
+    size_t capacity = 0;
+
+    void AddBlock(size_t minSize);
+};
+
+// Adapts LinearArena to std containers, deallocation is a no-op
+template <class T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator(LinearArena& arena_)
+        : arena(&arena_)
+    {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : arena(other.arena)
+    {}
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return arena == other.arena;
+    }
+
+private:
+    LinearArena* arena;
+
+    template <class U>
+    friend class ArenaAllocator;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,95 @@
+#include "Utils/AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Details
+{
+    static std::atomic<uint64_t> totalCount = 0;
+
+    static thread_local uint64_t threadCount = 0;
+
+    static void* Allocate(size_t size)
+    {
+        totalCount.fetch_add(1, std::memory_order_relaxed);
+        ++threadCount;
+
+        if (void* memory = std::malloc(size > 0 ? size : 1))
+        {
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    static void* AllocateAligned(size_t size, size_t alignment)
+    {
+        totalCount.fetch_add(1, std::memory_order_relaxed);
+        ++threadCount;
+
+#if defined(_MSC_VER)
+        void* memory = _aligned_malloc(size > 0 ? size : 1, alignment);
+#else
+        // Size has to be a multiple of alignment
+        void* memory = std::aligned_alloc(alignment, (std::max(size, size_t(1)) + alignment - 1) & ~(alignment - 1));
+#endif
+
+        if (memory)
+        {
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    static void FreeAligned(void* memory)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+uint64_t AllocationCounter::GetTotalCount()
+{
+    return Details::totalCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::GetThreadCount()
+{
+    return Details::threadCount;
+}
+
+// Array and nothrow forms are implemented by the standard library through these ones
+void* operator new(size_t size)
+{
+    return Details::Allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return Details::AllocateAligned(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    Details::FreeAligned(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    Details::FreeAligned(memory);
+}
@@ -0,0 +1,449 @@
+#include "Utils/DynamicBvh.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/Frustum.hpp"
+#include "Utils/Ray.hpp"
+
+#include <queue>
+
+namespace Details
+{
+    static AABBox Union(const AABBox& a, const AABBox& b)
+    {
+        AABBox result = a;
+        result.Add(b);
+        return result;
+    }
+
+    static float GetSurfaceArea(const AABBox& bbox)
+    {
+        const glm::vec3 size = bbox.GetSize();
+
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    static bool Overlaps(const AABBox& a, const AABBox& b)
+    {
+        return glm::all(glm::lessThanEqual(a.GetMin(), b.GetMax()))
+                && glm::all(glm::lessThanEqual(b.GetMin(), a.GetMax()));
+    }
+
+    static bool Overlaps(const AABBox& bbox, const glm::vec3& center, float radius)
+    {
+        const glm::vec3 closestPoint = glm::clamp(center, bbox.GetMin(), bbox.GetMax());
+        const glm::vec3 offset = closestPoint - center;
+
+        return glm::dot(offset, offset) <= radius * radius;
+    }
+
+    static float IntersectRay(const AABBox& bbox, const glm::vec3& origin,
+            const glm::vec3& inverseDirection, float maxDistance)
+    {
+        const glm::vec3 t0 = (bbox.GetMin() - origin) * inverseDirection;
+        const glm::vec3 t1 = (bbox.GetMax() - origin) * inverseDirection;
+
+        const float tMin = glm::compMax(glm::min(t0, t1));
+        const float tMax = glm::compMin(glm::max(t0, t1));
+
+        if (tMax >= std::max(tMin, 0.0f) && tMin <= maxDistance)
+        {
+            return std::max(tMin, 0.0f);
+        }
+
+        return std::numeric_limits<float>::infinity();
+    }
+}
+
+uint32_t DynamicBvh::Insert(const AABBox& bbox, uint32_t id)
+{
+    Assert(bbox.IsValid());
+
+    const uint32_t leaf = AllocateNode();
+
+    nodes[leaf].bbox = bbox;
+    nodes[leaf].id = id;
+
+    InsertLeaf(leaf);
+
+    ++leafCount;
+
+    return leaf;
+}
+
+void DynamicBvh::Remove(uint32_t leaf)
+{
+    Assert(nodes[leaf].IsLeaf());
+
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+
+    --leafCount;
+}
+
+void DynamicBvh::Refit(uint32_t leaf, const AABBox& bbox)
+{
+    Assert(nodes[leaf].IsLeaf() && bbox.IsValid());
+
+    if (Details::Overlaps(nodes[leaf].bbox, bbox))
+    {
+        nodes[leaf].bbox = bbox;
+
+        RefitAncestors(nodes[leaf].parent);
+    }
+    else
+    {
+        RemoveLeaf(leaf);
+
+        nodes[leaf].bbox = bbox;
+
+        InsertLeaf(leaf);
+    }
+}
+
+void DynamicBvh::Clear()
+{
+    nodes.clear();
+    freeNodes.clear();
+
+    root = kInvalidIndex;
+    leafCount = 0;
+}
+
+AABBox DynamicBvh::GetBBox() const
+{
+    if (root == kInvalidIndex)
+    {
+        return AABBox();
+    }
+
+    return nodes[root].bbox;
+}
+
+void DynamicBvh::QueryBBox(const AABBox& bbox, const QueryFunc& func) const
+{
+    if (root == kInvalidIndex || !bbox.IsValid())
+    {
+        return;
+    }
+
+    std::vector<uint32_t> stack{ root };
+
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!Details::Overlaps(node.bbox, bbox))
+        {
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            func(node.id);
+        }
+        else
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void DynamicBvh::QuerySphere(const glm::vec3& center, float radius, const QueryFunc& func) const
+{
+    if (root == kInvalidIndex)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> stack{ root };
+
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!Details::Overlaps(node.bbox, center, radius))
+        {
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            func(node.id);
+        }
+        else
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void DynamicBvh::QueryFrustum(const Frustum& frustum, const QueryFunc& func) const
+{
+    if (root == kInvalidIndex)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> stack{ root };
+
+    while (!stack.empty())
+    {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+
+        const AABBox::Intersection intersection = frustum.Intersect(node.bbox);
+
+        if (intersection == AABBox::Intersection::eOutside)
+        {
+            continue;
+        }
+
+        if (intersection == AABBox::Intersection::eInside || node.IsLeaf())
+        {
+            EnumerateLeaves(index, func);
+        }
+        else
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void DynamicBvh::QueryRay(const Ray& ray, const RayQueryFunc& func) const
+{
+    if (root == kInvalidIndex)
+    {
+        return;
+    }
+
+    const glm::vec3 inverseDirection = 1.0f / ray.direction;
+
+    float maxDistance = ray.maxDistance;
+
+    using Entry = std::pair<float, uint32_t>;
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+
+    const float rootDistance = Details::IntersectRay(nodes[root].bbox, ray.origin, inverseDirection, maxDistance);
+
+    if (rootDistance <= maxDistance)
+    {
+        queue.emplace(rootDistance, root);
+    }
+
+    while (!queue.empty())
+    {
+        const auto [distance, index] = queue.top();
+        queue.pop();
+
+        if (distance > maxDistance)
+        {
+            break;
+        }
+
+        const Node& node = nodes[index];
+
+        if (node.IsLeaf())
+        {
+            maxDistance = std::min(func(node.id, maxDistance), maxDistance);
+        }
+        else
+        {
+            for (const uint32_t child : { node.left, node.right })
+            {
+                const float childDistance = Details::IntersectRay(
+                        nodes[child].bbox, ray.origin, inverseDirection, maxDistance);
+
+                if (childDistance <= maxDistance)
+                {
+                    queue.emplace(childDistance, child);
+                }
+            }
+        }
+    }
+}
+
+uint32_t DynamicBvh::AllocateNode()
+{
+    if (!freeNodes.empty())
+    {
+        const uint32_t index = freeNodes.back();
+        freeNodes.pop_back();
+
+        nodes[index] = Node();
+
+        return index;
+    }
+
+    nodes.emplace_back();
+
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void DynamicBvh::FreeNode(uint32_t index)
+{
+    nodes[index] = Node();
+
+    freeNodes.push_back(index);
+}
+
+uint32_t DynamicBvh::FindBestSibling(const AABBox& bbox) const
+{
+    const float bboxArea = Details::GetSurfaceArea(bbox);
+
+    uint32_t bestSibling = root;
+    float bestCost = Details::GetSurfaceArea(Details::Union(nodes[root].bbox, bbox));
+
+    using Entry = std::pair<uint32_t, float>;
+
+    std::vector<Entry> stack{ Entry(root, 0.0f) };
+
+    while (!stack.empty())
+    {
+        const auto [index, inheritedCost] = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+
+        const float directCost = Details::GetSurfaceArea(Details::Union(node.bbox, bbox));
+        const float cost = directCost + inheritedCost;
+
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestSibling = index;
+        }
+
+        if (!node.IsLeaf())
+        {
+            const float childInheritedCost = inheritedCost + directCost - Details::GetSurfaceArea(node.bbox);
+
+            if (bboxArea + childInheritedCost < bestCost)
+            {
+                stack.emplace_back(node.left, childInheritedCost);
+                stack.emplace_back(node.right, childInheritedCost);
+            }
+        }
+    }
+
+    return bestSibling;
+}
+
+void DynamicBvh::InsertLeaf(uint32_t leaf)
+{
+    if (root == kInvalidIndex)
+    {
+        root = leaf;
+        nodes[root].parent = kInvalidIndex;
+        return;
+    }
+
+    const uint32_t sibling = FindBestSibling(nodes[leaf].bbox);
+    const uint32_t oldParent = nodes[sibling].parent;
+
+    const uint32_t newParent = AllocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[newParent].bbox = Details::Union(nodes[sibling].bbox, nodes[leaf].bbox);
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == kInvalidIndex)
+    {
+        root = newParent;
+    }
+    else
+    {
+        if (nodes[oldParent].left == sibling)
+        {
+            nodes[oldParent].left = newParent;
+        }
+        else
+        {
+            nodes[oldParent].right = newParent;
+        }
+
+        RefitAncestors(oldParent);
+    }
+}
+
+void DynamicBvh::RemoveLeaf(uint32_t leaf)
+{
+    if (leaf == root)
+    {
+        root = kInvalidIndex;
+        return;
+    }
+
+    const uint32_t parent = nodes[leaf].parent;
+    const uint32_t grandParent = nodes[parent].parent;
+    const uint32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    if (grandParent == kInvalidIndex)
+    {
+        root = sibling;
+        nodes[sibling].parent = kInvalidIndex;
+    }
+    else
+    {
+        if (nodes[grandParent].left == parent)
+        {
+            nodes[grandParent].left = sibling;
+        }
+        else
+        {
+            nodes[grandParent].right = sibling;
+        }
+
+        nodes[sibling].parent = grandParent;
+
+        RefitAncestors(grandParent);
+    }
+
+    nodes[leaf].parent = kInvalidIndex;
+
+    FreeNode(parent);
+}
+
+void DynamicBvh::RefitAncestors(uint32_t index)
+{
+    while (index != kInvalidIndex)
+    {
+        Node& node = nodes[index];
+
+        node.bbox = Details::Union(nodes[node.left].bbox, nodes[node.right].bbox);
+
+        index = node.parent;
+    }
+}
+
+void DynamicBvh::EnumerateLeaves(uint32_t index, const QueryFunc& func) const
+{
+    std::vector<uint32_t> stack{ index };
+
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (node.IsLeaf())
+        {
+            func(node.id);
+        }
+        else
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include "Utils/Frustum.hpp"
+
+namespace Details
+{
+    static glm::vec4 GetRow(const glm::mat4& matrix, uint32_t index)
+    {
+        return glm::vec4(matrix[0][index], matrix[1][index], matrix[2][index], matrix[3][index]);
+    }
+
+    static glm::vec4 NormalizePlane(const glm::vec4& plane)
+    {
+        const float length = glm::length(glm::vec3(plane));
+
+        return length > 0.0f ? plane / length : plane;
+    }
+}
+
+Frustum::Frustum(const glm::mat4& viewProjMatrix)
+{
+    const glm::vec4 row0 = Details::GetRow(viewProjMatrix, 0);
+    const glm::vec4 row1 = Details::GetRow(viewProjMatrix, 1);
+    const glm::vec4 row2 = Details::GetRow(viewProjMatrix, 2);
+    const glm::vec4 row3 = Details::GetRow(viewProjMatrix, 3);
+
+    planes[0] = Details::NormalizePlane(row3 + row0);
+    planes[1] = Details::NormalizePlane(row3 - row0);
+    planes[2] = Details::NormalizePlane(row3 + row1);
+    planes[3] = Details::NormalizePlane(row3 - row1);
+    planes[4] = Details::NormalizePlane(row2);
+    planes[5] = Details::NormalizePlane(row3 - row2);
+}
+
+AABBox::Intersection Frustum::Intersect(const AABBox& bbox) const
+{
+    if (!bbox.IsValid())
+    {
+        return AABBox::Intersection::eOutside;
+    }
+
+    const glm::vec3 center = bbox.GetCenter();
+    const glm::vec3 extent = bbox.GetSize() * 0.5f;
+
+    AABBox::Intersection result = AABBox::Intersection::eInside;
+
+    for (const auto& plane : planes)
+    {
+        const glm::vec3 normal(plane);
+
+        const float distance = glm::dot(normal, center) + plane.w;
+        const float radius = glm::dot(extent, glm::abs(normal));
+
+        if (distance + radius < 0.0f)
+        {
+            return AABBox::Intersection::eOutside;
+        }
+
+        if (distance - radius < 0.0f)
+        {
+            result = AABBox::Intersection::eIntersect;
+        }
+    }
+
+    return result;
+}
+
+bool Frustum::Intersect(const glm::vec3& center, float radius) const
+{
+    for (const auto& plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -1,5 +1,8 @@
 #include "Utils/Helpers.hpp"
 
+#include <atomic>
+#include <thread>
+
 namespace Details
 {
     template <glm::length_t N>
@@ -74,6 +77,35 @@ float Math::RemapValueClamped(const glm::vec2& inputRange, const glm::vec2& outp
     return std::lerp(outputRange.x, outputRange.y, t);
 }
 
+void ParallelFor(size_t count, const std::function<void(size_t)>& func)
+{
+    const size_t threadCount = std::min(static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)), count);
+
+    std::atomic<size_t> nextIndex = 0;
+
+    const auto worker = [&]()
+        {
+            for (size_t i = nextIndex++; i < count; i = nextIndex++)
+            {
+                func(i);
+            }
+        };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
 Bytes GetBytes(const std::vector<ByteView>& byteViews)
 {
     size_t size = 0;
@@ -0,0 +1,71 @@
+#include "Utils/LinearArena.hpp"
+
+#include "Utils/Assert.hpp"
+
+#include <bit>
+
+namespace Details
+{
+    static size_t GetAlignedOffset(const uint8_t* data, size_t offset, size_t alignment)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(data) + offset;
+
+        return offset + ((alignment - address % alignment) % alignment);
+    }
+}
+
+LinearArena::LinearArena(size_t blockSize_)
+    : blockSize(blockSize_)
+{
+    AddBlock(blockSize);
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    Assert(std::has_single_bit(alignment));
+
+    if (Details::GetAlignedOffset(blocks.back().data.get(), blockOffset, alignment) + size > blocks.back().size)
+    {
+        AddBlock(size + alignment);
+    }
+
+    const Block& block = blocks.back();
+
+    const size_t offset = Details::GetAlignedOffset(block.data.get(), blockOffset, alignment);
+
+    blockOffset = offset + size;
+    usedSize += size;
+
+    return block.data.get() + offset;
+}
+
+void LinearArena::Reset()
+{
+    if (blocks.size() > 1)
+    {
+        blocks.clear();
+
+        AddBlock(capacity);
+    }
+
+    blockOffset = 0;
+    usedSize = 0;
+}
+
+void LinearArena::AddBlock(size_t minSize)
+{
+    const size_t size = std::max(minSize, blockSize);
+
+    blocks.push_back(Block{ std::unique_ptr<uint8_t[]>(new uint8_t[size]), size });
+
+    blockOffset = 0;
+
+    if (blocks.size() == 1)
+    {
+        capacity = size;
+    }
+    else
+    {
+        capacity += size;
+    }
+}
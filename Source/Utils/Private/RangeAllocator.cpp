@@ -0,0 +1,93 @@
+#include "Utils/RangeAllocator.hpp"
+
+#include "Utils/Assert.hpp"
+
+RangeAllocator::RangeAllocator(uint32_t capacity_)
+{
+    Grow(capacity_);
+}
+
+uint32_t RangeAllocator::Allocate(uint32_t size)
+{
+    Assert(size > 0);
+
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+    {
+        const auto [offset, freeSize] = *it;
+
+        if (freeSize >= size)
+        {
+            freeRanges.erase(it);
+
+            if (freeSize > size)
+            {
+                freeRanges.emplace(offset + size, freeSize - size);
+            }
+
+            usedSize += size;
+
+            return offset;
+        }
+    }
+
+    return kInvalidOffset;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+    Assert(size > 0 && offset + size <= capacity);
+
+    uint32_t freeOffset = offset;
+    uint32_t freeSize = size;
+
+    const auto next = freeRanges.lower_bound(offset);
+
+    if (next != freeRanges.end())
+    {
+        Assert(offset + size <= next->first);
+
+        if (offset + size == next->first)
+        {
+            freeSize += next->second;
+
+            freeRanges.erase(next);
+        }
+    }
+
+    auto prev = freeRanges.lower_bound(offset);
+
+    if (prev != freeRanges.begin())
+    {
+        --prev;
+
+        Assert(prev->first + prev->second <= offset);
+
+        if (prev->first + prev->second == offset)
+        {
+            freeOffset = prev->first;
+            freeSize += prev->second;
+
+            freeRanges.erase(prev);
+        }
+    }
+
+    freeRanges.emplace(freeOffset, freeSize);
+
+    usedSize -= size;
+}
+
+void RangeAllocator::Grow(uint32_t newCapacity)
+{
+    Assert(newCapacity >= capacity);
+
+    if (newCapacity == capacity)
+    {
+        return;
+    }
+
+    const uint32_t oldCapacity = std::exchange(capacity, newCapacity);
+
+    usedSize += newCapacity - oldCapacity;
+
+    Free(oldCapacity, newCapacity - oldCapacity);
+}
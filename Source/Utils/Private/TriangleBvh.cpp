@@ -0,0 +1,411 @@
+#include "Utils/TriangleBvh.hpp"
+
+#include "Utils/Assert.hpp"
+#include "Utils/Ray.hpp"
+
+#include <xmmintrin.h>
+
+namespace Details
+{
+    static constexpr uint32_t kBinCount = 12;
+
+    // Deeper subtrees are split by median to keep traversal stack bounded
+    static constexpr uint32_t kMaxSahDepth = 32;
+
+    static constexpr uint32_t kMaxStackSize = 96;
+
+    static constexpr float kDeterminantEpsilon = 1e-12f;
+
+    static float GetSurfaceArea(const AABBox& bbox)
+    {
+        const glm::vec3 size = bbox.GetSize();
+
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    static float HorizontalMin(__m128 value)
+    {
+        value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        return _mm_cvtss_f32(value);
+    }
+
+    static float HorizontalMax(__m128 value)
+    {
+        value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        return _mm_cvtss_f32(value);
+    }
+
+    static float IntersectBounds(const float* min, const float* max,
+            __m128 origin, __m128 inverseDirection, float maxDistance)
+    {
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(min), origin), inverseDirection);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(max), origin), inverseDirection);
+
+        const float tNear = std::max(HorizontalMax(_mm_min_ps(t0, t1)), 0.0f);
+        const float tFar = HorizontalMin(_mm_max_ps(t0, t1));
+
+        if (tFar >= tNear && tNear <= maxDistance)
+        {
+            return tNear;
+        }
+
+        return std::numeric_limits<float>::infinity();
+    }
+}
+
+struct TriangleBvh::BuildTriangle
+{
+    AABBox bbox;
+    glm::vec3 centroid;
+    glm::vec3 v0;
+    glm::vec3 v1;
+    glm::vec3 v2;
+    uint32_t index;
+};
+
+TriangleBvh::TriangleBvh(const std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions)
+{
+    EASY_FUNCTION()
+
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    std::vector<BuildTriangle> triangles(triangleCount);
+
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        BuildTriangle& triangle = triangles[i];
+
+        triangle.v0 = positions[indices[i * 3]];
+        triangle.v1 = positions[indices[i * 3 + 1]];
+        triangle.v2 = positions[indices[i * 3 + 2]];
+
+        triangle.bbox = AABBox(triangle.v0, triangle.v1);
+        triangle.bbox.Add(triangle.v2);
+
+        triangle.centroid = (triangle.v0 + triangle.v1 + triangle.v2) / 3.0f;
+        triangle.index = i;
+    }
+
+    nodes.reserve(triangleCount * 2 / kLeafSize + 1);
+    packets.reserve(triangleCount / kLeafSize + 1);
+
+    BuildNode(triangles, 0, triangleCount, 0);
+
+    bbox = AABBox(glm::make_vec3(nodes.front().min.data()), glm::make_vec3(nodes.front().max.data()));
+}
+
+std::optional<TriangleHit> TriangleBvh::IntersectClosest(const Ray& ray) const
+{
+    return Intersect<false>(ray);
+}
+
+std::optional<TriangleHit> TriangleBvh::IntersectAny(const Ray& ray) const
+{
+    return Intersect<true>(ray);
+}
+
+uint32_t TriangleBvh::BuildNode(std::vector<BuildTriangle>& triangles, uint32_t begin, uint32_t end, uint32_t depth)
+{
+    const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+
+    nodes.emplace_back();
+
+    AABBox nodeBBox;
+    AABBox centroidBBox;
+
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        nodeBBox.Add(triangles[i].bbox);
+        centroidBBox.Add(triangles[i].centroid);
+    }
+
+    Node& node = nodes[nodeIndex];
+
+    node.min = { nodeBBox.GetMin().x, nodeBBox.GetMin().y, nodeBBox.GetMin().z, std::numeric_limits<float>::lowest() };
+    node.max = { nodeBBox.GetMax().x, nodeBBox.GetMax().y, nodeBBox.GetMax().z, std::numeric_limits<float>::max() };
+
+    const uint32_t count = end - begin;
+
+    if (count <= kLeafSize)
+    {
+        TrianglePacket packet{};
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const BuildTriangle& triangle = triangles[begin + i];
+
+            const glm::vec3 e1 = triangle.v1 - triangle.v0;
+            const glm::vec3 e2 = triangle.v2 - triangle.v0;
+
+            packet.v0x[i] = triangle.v0.x;
+            packet.v0y[i] = triangle.v0.y;
+            packet.v0z[i] = triangle.v0.z;
+            packet.e1x[i] = e1.x;
+            packet.e1y[i] = e1.y;
+            packet.e1z[i] = e1.z;
+            packet.e2x[i] = e2.x;
+            packet.e2y[i] = e2.y;
+            packet.e2z[i] = e2.z;
+            packet.triangles[i] = triangle.index;
+        }
+
+        node.offset = static_cast<uint32_t>(packets.size());
+        node.count = count;
+
+        packets.push_back(packet);
+
+        return nodeIndex;
+    }
+
+    const glm::vec3 centroidSize = centroidBBox.GetSize();
+
+    const uint32_t axis = centroidSize.x > centroidSize.y
+            ? (centroidSize.x > centroidSize.z ? 0 : 2)
+            : (centroidSize.y > centroidSize.z ? 1 : 2);
+
+    const float axisMin = centroidBBox.GetMin()[axis];
+    const float axisSize = centroidSize[axis];
+
+    const auto begin_ = triangles.begin() + begin;
+    const auto end_ = triangles.begin() + end;
+
+    auto middle = begin_ + count / 2;
+
+    if (axisSize > 0.0f && depth < Details::kMaxSahDepth)
+    {
+        const auto getBin = [&](const BuildTriangle& triangle)
+            {
+                const float offset = (triangle.centroid[axis] - axisMin) / axisSize;
+
+                return std::min(static_cast<uint32_t>(offset * Details::kBinCount), Details::kBinCount - 1);
+            };
+
+        std::array<AABBox, Details::kBinCount> binBBoxes;
+        std::array<uint32_t, Details::kBinCount> binCounts{};
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const uint32_t bin = getBin(triangles[i]);
+
+            binBBoxes[bin].Add(triangles[i].bbox);
+            ++binCounts[bin];
+        }
+
+        std::array<float, Details::kBinCount - 1> leftCosts;
+
+        AABBox leftBBox;
+        uint32_t leftCount = 0;
+
+        for (uint32_t i = 0; i < Details::kBinCount - 1; ++i)
+        {
+            leftBBox.Add(binBBoxes[i]);
+            leftCount += binCounts[i];
+
+            leftCosts[i] = Details::GetSurfaceArea(leftBBox) * static_cast<float>(leftCount);
+        }
+
+        AABBox rightBBox;
+        uint32_t rightCount = 0;
+
+        uint32_t bestBin = 0;
+        float bestCost = std::numeric_limits<float>::max();
+
+        for (uint32_t i = Details::kBinCount - 1; i > 0; --i)
+        {
+            rightBBox.Add(binBBoxes[i]);
+            rightCount += binCounts[i];
+
+            const float cost = leftCosts[i - 1] + Details::GetSurfaceArea(rightBBox) * static_cast<float>(rightCount);
+
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestBin = i - 1;
+            }
+        }
+
+        middle = std::partition(begin_, end_, [&](const BuildTriangle& triangle)
+            {
+                return getBin(triangle) <= bestBin;
+            });
+    }
+
+    if (middle == begin_ || middle == end_)
+    {
+        middle = begin_ + count / 2;
+
+        std::nth_element(begin_, middle, end_, [&](const BuildTriangle& a, const BuildTriangle& b)
+            {
+                return a.centroid[axis] < b.centroid[axis];
+            });
+    }
+
+    const uint32_t split = static_cast<uint32_t>(middle - triangles.begin());
+
+    BuildNode(triangles, begin, split, depth + 1);
+
+    const uint32_t rightChild = BuildNode(triangles, split, end, depth + 1);
+
+    nodes[nodeIndex].offset = rightChild;
+
+    return nodeIndex;
+}
+
+template <bool AnyHit>
+std::optional<TriangleHit> TriangleBvh::Intersect(const Ray& ray) const
+{
+    if (nodes.empty())
+    {
+        return std::nullopt;
+    }
+
+    const glm::vec3 inverseDirection = 1.0f / ray.direction;
+
+    const __m128 origin = _mm_setr_ps(ray.origin.x, ray.origin.y, ray.origin.z, 0.0f);
+    const __m128 inverseDirection4 = _mm_setr_ps(inverseDirection.x, inverseDirection.y, inverseDirection.z, 1.0f);
+
+    const __m128 ox = _mm_set1_ps(ray.origin.x);
+    const __m128 oy = _mm_set1_ps(ray.origin.y);
+    const __m128 oz = _mm_set1_ps(ray.origin.z);
+    const __m128 dx = _mm_set1_ps(ray.direction.x);
+    const __m128 dy = _mm_set1_ps(ray.direction.y);
+    const __m128 dz = _mm_set1_ps(ray.direction.z);
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 epsilon = _mm_set1_ps(Details::kDeterminantEpsilon);
+
+    float maxDistance = ray.maxDistance;
+
+    std::optional<TriangleHit> result;
+
+    std::array<uint32_t, Details::kMaxStackSize> stack;
+    uint32_t stackSize = 0;
+
+    if (Details::IntersectBounds(nodes[0].min.data(), nodes[0].max.data(),
+            origin, inverseDirection4, maxDistance) <= maxDistance)
+    {
+        stack[stackSize++] = 0;
+    }
+
+    while (stackSize > 0)
+    {
+        const uint32_t nodeIndex = stack[--stackSize];
+
+        const Node& node = nodes[nodeIndex];
+
+        if (node.count == 0)
+        {
+            const uint32_t left = nodeIndex + 1;
+            const uint32_t right = node.offset;
+
+            const float leftDistance = Details::IntersectBounds(nodes[left].min.data(),
+                    nodes[left].max.data(), origin, inverseDirection4, maxDistance);
+            const float rightDistance = Details::IntersectBounds(nodes[right].min.data(),
+                    nodes[right].max.data(), origin, inverseDirection4, maxDistance);
+
+            const bool leftHit = leftDistance <= maxDistance;
+            const bool rightHit = rightDistance <= maxDistance;
+
+            if (leftHit && rightHit)
+            {
+                Assert(stackSize + 2 <= Details::kMaxStackSize);
+
+                stack[stackSize++] = leftDistance < rightDistance ? right : left;
+                stack[stackSize++] = leftDistance < rightDistance ? left : right;
+            }
+            else if (leftHit)
+            {
+                stack[stackSize++] = left;
+            }
+            else if (rightHit)
+            {
+                stack[stackSize++] = right;
+            }
+
+            continue;
+        }
+
+        const TrianglePacket& packet = packets[node.offset];
+
+        const __m128 e1x = _mm_loadu_ps(packet.e1x.data());
+        const __m128 e1y = _mm_loadu_ps(packet.e1y.data());
+        const __m128 e1z = _mm_loadu_ps(packet.e1z.data());
+        const __m128 e2x = _mm_loadu_ps(packet.e2x.data());
+        const __m128 e2y = _mm_loadu_ps(packet.e2y.data());
+        const __m128 e2z = _mm_loadu_ps(packet.e2z.data());
+
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+        const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        const __m128 inverseDet = _mm_div_ps(one, det);
+
+        const __m128 tx = _mm_sub_ps(ox, _mm_loadu_ps(packet.v0x.data()));
+        const __m128 ty = _mm_sub_ps(oy, _mm_loadu_ps(packet.v0y.data()));
+        const __m128 tz = _mm_sub_ps(oz, _mm_loadu_ps(packet.v0z.data()));
+
+        const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inverseDet);
+
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+        const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverseDet);
+
+        const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverseDet);
+
+        __m128 mask = _mm_cmpgt_ps(_mm_andnot_ps(signMask, det), epsilon);
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+        mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+        mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(maxDistance)));
+
+        const int32_t hitMask = _mm_movemask_ps(mask);
+
+        if (hitMask == 0)
+        {
+            continue;
+        }
+
+        std::array<float, kLeafSize> distances;
+        std::array<float, kLeafSize> us;
+        std::array<float, kLeafSize> vs;
+
+        _mm_storeu_ps(distances.data(), t);
+        _mm_storeu_ps(us.data(), u);
+        _mm_storeu_ps(vs.data(), v);
+
+        for (uint32_t i = 0; i < node.count; ++i)
+        {
+            if ((hitMask & (1 << i)) && distances[i] < maxDistance)
+            {
+                maxDistance = distances[i];
+
+                result = TriangleHit{ packet.triangles[i], glm::vec2(us[i], vs[i]), distances[i] };
+            }
+        }
+
+        if constexpr (AnyHit)
+        {
+            return result;
+        }
+    }
+
+    return result;
+}
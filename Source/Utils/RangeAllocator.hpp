@@ -0,0 +1,31 @@
+#pragma once
+
+// First fit allocator of ranges within abstract capacity, freed ranges are merged with adjacent free ones
+class RangeAllocator
+{
+public:
+    static constexpr uint32_t kInvalidOffset = std::numeric_limits<uint32_t>::max();
+
+    RangeAllocator() = default;
+
+    explicit RangeAllocator(uint32_t capacity_);
+
+    // Returns kInvalidOffset if there is no free range of the requested size
+    uint32_t Allocate(uint32_t size);
+
+    void Free(uint32_t offset, uint32_t size);
+
+    // Appends free space at the end, allocated ranges keep their offsets
+    void Grow(uint32_t newCapacity);
+
+    uint32_t GetCapacity() const { return capacity; }
+
+    uint32_t GetUsedSize() const { return usedSize; }
+
+private:
+    // Free ranges sizes by offset
+    std::map<uint32_t, uint32_t> freeRanges;
+
+    uint32_t capacity = 0;
+    uint32_t usedSize = 0;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+struct Ray
+{
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float maxDistance = std::numeric_limits<float>::max();
+};
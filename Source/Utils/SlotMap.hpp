@@ -0,0 +1,193 @@
+#pragma once
+
+#include "Utils/Assert.hpp"
+
+template <class T>
+struct SlotHandle
+{
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != kInvalidIndex; }
+
+    bool operator==(const SlotHandle<T>& other) const = default;
+};
+
+// Values keep their slot index until removed, so slot indices can be used in gpu data.
+// Removed slots stay in the contiguous slot array (holding placeholder value) and are reused later.
+template <class T>
+class SlotMap
+{
+public:
+    using Handle = SlotHandle<T>;
+
+    uint32_t GetSize() const { return size; }
+
+    uint32_t GetSlotCount() const { return static_cast<uint32_t>(slots.size()); }
+
+    bool IsEmpty() const { return size == 0; }
+
+    const std::vector<T>& GetSlots() const { return slots; }
+
+    bool IsAlive(uint32_t index) const { return index < slots.size() && alive[index]; }
+
+    bool Contains(Handle handle) const;
+
+    Handle GetHandle(uint32_t index) const;
+
+    T& operator[](Handle handle);
+
+    const T& operator[](Handle handle) const;
+
+    Handle Add(T&& value);
+
+    // Moved-from value stays in the slot
+    T Extract(Handle handle);
+
+    T Extract(Handle handle, T&& placeholder);
+
+    void Clear();
+
+    template <class F>
+    void Enumerate(F&& func);
+
+    template <class F>
+    void Enumerate(F&& func) const;
+
+private:
+    std::vector<T> slots;
+    std::vector<uint32_t> generations;
+    std::vector<bool> alive;
+    std::vector<uint32_t> freeSlots;
+
+    uint32_t size = 0;
+
+    void FreeSlot(Handle handle);
+};
+
+template <class T>
+bool SlotMap<T>::Contains(Handle handle) const
+{
+    return IsAlive(handle.index) && generations[handle.index] == handle.generation;
+}
+
+template <class T>
+typename SlotMap<T>::Handle SlotMap<T>::GetHandle(uint32_t index) const
+{
+    Assert(IsAlive(index));
+
+    return Handle{ index, generations[index] };
+}
+
+template <class T>
+T& SlotMap<T>::operator[](Handle handle)
+{
+    Assert(Contains(handle));
+
+    return slots[handle.index];
+}
+
+template <class T>
+const T& SlotMap<T>::operator[](Handle handle) const
+{
+    Assert(Contains(handle));
+
+    return slots[handle.index];
+}
+
+template <class T>
+typename SlotMap<T>::Handle SlotMap<T>::Add(T&& value)
+{
+    ++size;
+
+    if (!freeSlots.empty())
+    {
+        const uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+
+        slots[index] = std::move(value);
+        alive[index] = true;
+
+        return Handle{ index, generations[index] };
+    }
+
+    slots.push_back(std::move(value));
+    generations.push_back(0);
+    alive.push_back(true);
+
+    return Handle{ static_cast<uint32_t>(slots.size() - 1), 0 };
+}
+
+template <class T>
+T SlotMap<T>::Extract(Handle handle)
+{
+    Assert(Contains(handle));
+
+    T value = std::move(slots[handle.index]);
+
+    FreeSlot(handle);
+
+    return value;
+}
+
+template <class T>
+T SlotMap<T>::Extract(Handle handle, T&& placeholder)
+{
+    Assert(Contains(handle));
+
+    T value = std::exchange(slots[handle.index], std::move(placeholder));
+
+    FreeSlot(handle);
+
+    return value;
+}
+
+template <class T>
+void SlotMap<T>::Clear()
+{
+    slots.clear();
+    generations.clear();
+    alive.clear();
+    freeSlots.clear();
+
+    size = 0;
+}
+
+template <class T>
+template <class F>
+void SlotMap<T>::Enumerate(F&& func)
+{
+    for (uint32_t i = 0; i < slots.size(); ++i)
+    {
+        if (alive[i])
+        {
+            func(Handle{ i, generations[i] }, slots[i]);
+        }
+    }
+}
+
+template <class T>
+template <class F>
+void SlotMap<T>::Enumerate(F&& func) const
+{
+    for (uint32_t i = 0; i < slots.size(); ++i)
+    {
+        if (alive[i])
+        {
+            func(Handle{ i, generations[i] }, slots[i]);
+        }
+    }
+}
+
+template <class T>
+void SlotMap<T>::FreeSlot(Handle handle)
+{
+    alive[handle.index] = false;
+    ++generations[handle.index];
+
+    freeSlots.push_back(handle.index);
+
+    --size;
+}
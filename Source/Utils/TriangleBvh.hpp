@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Utils/AABBox.hpp"
+
+struct Ray;
+
+struct TriangleHit
+{
+    uint32_t triangle = 0;
+    glm::vec2 barycentrics = glm::vec2(0.0f);
+    float distance = 0.0f;
+};
+
+// Static SAH BVH over triangles of a single mesh, leaves store up to 4 triangles tested at once with SSE
+class TriangleBvh
+{
+public:
+    TriangleBvh(const std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions);
+
+    const AABBox& GetBBox() const { return bbox; }
+
+    std::optional<TriangleHit> IntersectClosest(const Ray& ray) const;
+
+    std::optional<TriangleHit> IntersectAny(const Ray& ray) const;
+
+private:
+    static constexpr uint32_t kLeafSize = 4;
+
+    struct Node
+    {
+        std::array<float, 4> min;
+        std::array<float, 4> max;
+        uint32_t offset = 0; // packet index for leaves, right child index for inner nodes
+        uint32_t count = 0; // 0 for inner nodes
+    };
+
+    struct TrianglePacket
+    {
+        std::array<float, kLeafSize> v0x;
+        std::array<float, kLeafSize> v0y;
+        std::array<float, kLeafSize> v0z;
+        std::array<float, kLeafSize> e1x;
+        std::array<float, kLeafSize> e1y;
+        std::array<float, kLeafSize> e1z;
+        std::array<float, kLeafSize> e2x;
+        std::array<float, kLeafSize> e2y;
+        std::array<float, kLeafSize> e2z;
+        std::array<uint32_t, kLeafSize> triangles;
+    };
+
+    struct BuildTriangle;
+
+    AABBox bbox;
+
+    std::vector<Node> nodes;
+    std::vector<TrianglePacket> packets;
+
+    uint32_t BuildNode(std::vector<BuildTriangle>& triangles, uint32_t begin, uint32_t end, uint32_t depth);
+
+    template <bool AnyHit>
+    std::optional<TriangleHit> Intersect(const Ray& ray) const;
+};
@@ -0,0 +1,179 @@
+#include "Engine/Render/OcclusionCuller.hpp"
+
+#include <sstream>
+
+// Rasterizes fixed occluder set and compares visibility of test objects with golden results.
+// Run with --update as the second argument to rewrite golden file after intended culler changes.
+namespace Details
+{
+    struct Occluder
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        glm::mat4 transform;
+    };
+
+    struct TestObject
+    {
+        std::string name;
+        AABBox bbox;
+    };
+
+    static const glm::vec3 kCameraPosition(0.0f, 0.0f, 10.0f);
+
+    static const float kFieldOfView = glm::radians(60.0f);
+    static constexpr float kNearPlane = 0.1f;
+    static constexpr float kFarPlane = 100.0f;
+
+    static glm::mat4 CreateViewProjMatrix()
+    {
+        const float aspect = static_cast<float>(OcclusionCuller::kWidth) / static_cast<float>(OcclusionCuller::kHeight);
+
+        const glm::mat4 viewMatrix = glm::lookAt(kCameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 projMatrix = glm::perspective(kFieldOfView, aspect, kNearPlane, kFarPlane);
+
+        return projMatrix * viewMatrix;
+    }
+
+    // Unit quad in XY plane, occluders are placed with transforms
+    static Occluder CreateQuadOccluder(const glm::vec3& center, const glm::vec2& size)
+    {
+        return Occluder{
+            .positions = {
+                glm::vec3(-0.5f, -0.5f, 0.0f),
+                glm::vec3(0.5f, -0.5f, 0.0f),
+                glm::vec3(0.5f, 0.5f, 0.0f),
+                glm::vec3(-0.5f, 0.5f, 0.0f),
+            },
+            .indices = { 0, 1, 2, 2, 3, 0 },
+            .transform = glm::translate(center) * glm::scale(glm::vec3(size, 1.0f))
+        };
+    }
+
+    static std::vector<Occluder> CreateOccluders()
+    {
+        return {
+            CreateQuadOccluder(glm::vec3(-2.0f, 0.0f, 0.0f), glm::vec2(4.0f, 6.0f)),
+            CreateQuadOccluder(glm::vec3(2.5f, 0.0f, 2.0f), glm::vec2(2.0f, 2.0f)),
+        };
+    }
+
+    static TestObject CreateTestObject(const std::string& name, const glm::vec3& center, float halfSize)
+    {
+        return TestObject{ name, AABBox(center - glm::vec3(halfSize), center + glm::vec3(halfSize)) };
+    }
+
+    static std::vector<TestObject> CreateTestObjects()
+    {
+        return {
+            CreateTestObject("BehindWall", glm::vec3(-2.0f, 0.0f, -5.0f), 0.5f),
+            CreateTestObject("BehindWallLarge", glm::vec3(-2.0f, 0.0f, -5.0f), 4.0f),
+            CreateTestObject("BehindWallFar", glm::vec3(-2.0f, 2.0f, -40.0f), 1.0f),
+            CreateTestObject("BehindWallTouching", glm::vec3(-2.0f, 0.0f, -0.6f), 0.5f),
+            CreateTestObject("InFrontOfWall", glm::vec3(-2.0f, 0.0f, 3.0f), 0.5f),
+            CreateTestObject("AboveWall", glm::vec3(-2.0f, 6.0f, -5.0f), 0.5f),
+            CreateTestObject("StraddlingWallEdge", glm::vec3(0.0f, 0.0f, -5.0f), 0.5f),
+            CreateTestObject("RightOfWall", glm::vec3(3.0f, 0.0f, -5.0f), 0.5f),
+            CreateTestObject("BehindSmallOccluder", glm::vec3(3.75f, 0.0f, -2.0f), 0.3f),
+            CreateTestObject("OutsideFrustum", glm::vec3(30.0f, 0.0f, -5.0f), 0.5f),
+            CreateTestObject("BehindCamera", glm::vec3(0.0f, 0.0f, 15.0f), 0.5f),
+        };
+    }
+
+    static std::string ComputeResults()
+    {
+        OcclusionCuller culler;
+
+        culler.Begin(CreateViewProjMatrix());
+
+        for (const Occluder& occluder : CreateOccluders())
+        {
+            culler.RasterizeOccluder(occluder.positions, occluder.indices, occluder.transform);
+        }
+
+        culler.BuildHierarchy();
+
+        std::ostringstream results;
+
+        for (const TestObject& object : CreateTestObjects())
+        {
+            results << object.name << " " << (culler.IsOccluded(object.bbox) ? "occluded" : "visible") << "\n";
+        }
+
+        return results.str();
+    }
+
+    static std::vector<std::string> SplitLines(const std::string& text)
+    {
+        std::vector<std::string> lines;
+
+        std::istringstream stream(text);
+
+        for (std::string line; std::getline(stream, line);)
+        {
+            if (!line.empty() && line.front() != '#')
+            {
+                lines.push_back(line);
+            }
+        }
+
+        return lines;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: OcclusionCullerTest <golden file> [--update]\n";
+        return 1;
+    }
+
+    const std::string goldenPath(argv[1]);
+
+    const std::string results = Details::ComputeResults();
+
+    if (argc > 2 && std::string(argv[2]) == "--update")
+    {
+        std::ofstream file(goldenPath, std::ios::trunc);
+
+        file << "# Visibility of OcclusionCullerTest objects, regenerate with --update after intended culler changes\n";
+        file << results;
+
+        return file.good() ? 0 : 1;
+    }
+
+    std::ifstream file(goldenPath);
+
+    if (!file)
+    {
+        std::cerr << "Failed to open golden file: " << goldenPath << "\n";
+        return 1;
+    }
+
+    std::stringstream golden;
+    golden << file.rdbuf();
+
+    const std::vector<std::string> expectedLines = Details::SplitLines(golden.str());
+    const std::vector<std::string> actualLines = Details::SplitLines(results);
+
+    bool passed = expectedLines.size() == actualLines.size();
+
+    if (!passed)
+    {
+        std::cerr << "Object count mismatch: expected " << expectedLines.size()
+                << ", got " << actualLines.size() << "\n";
+    }
+
+    for (size_t i = 0; i < std::min(expectedLines.size(), actualLines.size()); ++i)
+    {
+        if (expectedLines[i] != actualLines[i])
+        {
+            std::cerr << "Mismatch: expected \"" << expectedLines[i] << "\", got \"" << actualLines[i] << "\"\n";
+
+            passed = false;
+        }
+    }
+
+    return passed ? 0 : 1;
+}
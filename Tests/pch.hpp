@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <optional>
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <functional>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_XYZW_ONLY
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtx/component_wise.hpp>
+
+#include <easy/profiler.h>